@@ -0,0 +1,101 @@
+/**
+ * Copyright © 2017-2026 Wellington Wallace
+ *
+ * This file is part of Easy Effects.
+ *
+ * Easy Effects is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Easy Effects is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "analysis_bus.hpp"
+#include <sys/types.h>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+AnalysisBus::AnalysisBus() : ring_left(capacity, 0.0F), ring_right(capacity, 0.0F) {}
+
+void AnalysisBus::publish(const std::span<const float>& left,
+                          const std::span<const float>& right,
+                          const uint& rate,
+                          const uint64_t& clock_position) {
+  const bool publishing = n_readers.load(std::memory_order_relaxed) > 0;
+
+  if (this->rate.load(std::memory_order_relaxed) != rate || (publishing && !was_publishing)) {
+    this->rate.store(rate, std::memory_order_relaxed);
+
+    // Readers must not mix the frames already in the ring with the new ones.
+    valid_position.store(write_position.load(std::memory_order_relaxed), std::memory_order_release);
+  }
+
+  was_publishing = publishing;
+
+  if (!publishing) {
+    return;
+  }
+
+  const size_t n_frames = std::min(left.size(), right.size());
+
+  const uint64_t position = write_position.load(std::memory_order_relaxed);
+
+  clock_offset.store(static_cast<int64_t>(clock_position) - static_cast<int64_t>(position), std::memory_order_relaxed);
+
+  size_t done = 0U;
+
+  while (done < n_frames) {
+    const size_t offset = (position + done) & mask;
+    const size_t count = std::min(n_frames - done, static_cast<size_t>(capacity) - offset);
+
+    std::copy_n(left.begin() + static_cast<std::ptrdiff_t>(done), count, ring_left.begin() + offset);
+    std::copy_n(right.begin() + static_cast<std::ptrdiff_t>(done), count, ring_right.begin() + offset);
+
+    done += count;
+  }
+
+  write_position.store(position + n_frames, std::memory_order_release);
+}
+
+auto AnalysisBus::read(std::span<float> left, std::span<float> right, const uint64_t& end_position) const -> bool {
+  const size_t n_frames = std::min(left.size(), right.size());
+
+  return visit(end_position, n_frames, [&](const float* l, const float* r, const size_t& count, const size_t& offset) {
+    std::copy_n(l, count, left.begin() + static_cast<std::ptrdiff_t>(offset));
+    std::copy_n(r, count, right.begin() + static_cast<std::ptrdiff_t>(offset));
+  });
+}
+
+auto AnalysisBus::get_rate() const -> uint {
+  return rate.load(std::memory_order_relaxed);
+}
+
+auto AnalysisBus::get_write_position() const -> uint64_t {
+  return write_position.load(std::memory_order_acquire);
+}
+
+auto AnalysisBus::get_clock_offset() const -> int64_t {
+  return clock_offset.load(std::memory_order_relaxed);
+}
+
+void AnalysisBus::add_reader() {
+  n_readers.fetch_add(1, std::memory_order_relaxed);
+}
+
+void AnalysisBus::remove_reader() {
+  n_readers.fetch_sub(1, std::memory_order_relaxed);
+}
+
+auto AnalysisBus::has_readers() const -> bool {
+  return n_readers.load(std::memory_order_relaxed) > 0;
+}
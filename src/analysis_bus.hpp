@@ -0,0 +1,145 @@
+/**
+ * Copyright © 2017-2026 Wellington Wallace
+ *
+ * This file is part of Easy Effects.
+ *
+ * Easy Effects is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Easy Effects is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <sys/types.h>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/**
+ * In-process analysis bus. The node at the end of an effects pipeline publishes the audio it outputs here and any
+ * number of analyzers read snapshots of it from other threads. Analyzers do not need their own PipeWire filter and
+ * the realtime thread never waits for them.
+ *
+ * The samples are kept in a ring buffer with a published write position. There is a single writer. Readers do not
+ * take locks: they copy the frames they want and check afterwards if the writer went over them while they were
+ * reading, in which case the snapshot is discarded.
+ */
+class AnalysisBus {
+ public:
+  AnalysisBus();
+  AnalysisBus(const AnalysisBus&) = delete;
+  auto operator=(const AnalysisBus&) -> AnalysisBus& = delete;
+  AnalysisBus(const AnalysisBus&&) = delete;
+  auto operator=(const AnalysisBus&&) -> AnalysisBus& = delete;
+  ~AnalysisBus() = default;
+
+  // Enough for the largest analysis window plus one second of A/V sync delay at 192 kHz.
+  static constexpr uint capacity = 1U << 18U;
+
+  /**
+   * Realtime thread only. clock_position is the graph clock position of the cycle, so readers can find which frames
+   * of the ring correspond to a given graph time.
+   */
+  void publish(const std::span<const float>& left,
+               const std::span<const float>& right,
+               const uint& rate,
+               const uint64_t& clock_position);
+
+  /**
+   * Copies the left.size() frames that end at the absolute position end_position. Returns false if there is not
+   * enough data yet or if the writer overwrote part of the snapshot while it was being copied.
+   */
+  auto read(std::span<float> left, std::span<float> right, const uint64_t& end_position) const -> bool;
+
+  /**
+   * Gives the n_frames frames ending at end_position straight from the ring, without copying them to a snapshot
+   * first. The window is unwrapped in at most two contiguous segments and for each one the callback is called with
+   * (left, right, count, offset), offset being the position of the segment inside the window.
+   *
+   * Like in read, the callback may see frames that the writer is overwriting. Whatever it produced has to be
+   * discarded when false is returned.
+   */
+  template <typename Callback>
+  auto visit(const uint64_t& end_position, const size_t& n_frames, Callback&& callback) const -> bool {
+    const uint64_t position = write_position.load(std::memory_order_acquire);
+
+    if (end_position > position || end_position < n_frames || position - end_position + n_frames > capacity) {
+      return false;
+    }
+
+    const uint64_t first = end_position - n_frames;
+
+    if (first < valid_position.load(std::memory_order_acquire)) {
+      return false;
+    }
+
+    size_t done = 0U;
+
+    while (done < n_frames) {
+      const size_t offset = (first + done) & mask;
+      const size_t count = std::min(n_frames - done, static_cast<size_t>(capacity) - offset);
+
+      callback(ring_left.data() + offset, ring_right.data() + offset, count, done);
+
+      done += count;
+    }
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    const uint64_t new_position = write_position.load(std::memory_order_relaxed);
+
+    // The writer went around the ring over the frames we used or invalidated them.
+
+    return new_position - first <= capacity && first >= valid_position.load(std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] auto get_rate() const -> uint;
+
+  [[nodiscard]] auto get_write_position() const -> uint64_t;
+
+  /**
+   * Graph clock position minus ring position of the last published cycle. It stays the same while the node runs
+   * every cycle and changes when cycles are skipped.
+   */
+  [[nodiscard]] auto get_clock_offset() const -> int64_t;
+
+  // The writer skips the copy to the ring while there is nobody reading it.
+  void add_reader();
+
+  void remove_reader();
+
+  [[nodiscard]] auto has_readers() const -> bool;
+
+ private:
+  static constexpr uint mask = capacity - 1U;
+
+  std::vector<float> ring_left, ring_right;
+
+  std::atomic<uint64_t> write_position = 0U;
+
+  // Frames before this position were captured at another rate or before a reader was attached.
+  std::atomic<uint64_t> valid_position = 0U;
+
+  bool was_publishing = false;  // Realtime thread only
+
+  std::atomic<uint> rate = 0U;
+
+  std::atomic<int64_t> clock_offset = 0;
+
+  std::atomic<int> n_readers = 0;
+
+  static_assert((capacity & mask) == 0U, "capacity must be a power of two");
+  static_assert(std::atomic<uint64_t>::is_always_lock_free);
+};
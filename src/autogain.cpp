@@ -30,6 +30,7 @@
 #include <numbers>
 #include <span>
 #include <string>
+#include "channel_layout.hpp"
 #include "db_manager.hpp"
 #include "easyeffects_db_autogain.h"
 #include "pipeline_type.hpp"
@@ -100,10 +101,18 @@ auto Autogain::init_ebur128() -> bool {
     ebur_state = nullptr;
   }
 
-  ebur_state = ebur128_init(2U, rate, EBUR128_MODE_S | EBUR128_MODE_I | EBUR128_MODE_LRA | EBUR128_MODE_SAMPLE_PEAK);
+  const auto& positions = channel_layout::positions();
 
-  ebur128_set_channel(ebur_state, 0U, EBUR128_LEFT);
-  ebur128_set_channel(ebur_state, 1U, EBUR128_RIGHT);
+  ebur_state = ebur128_init(static_cast<uint>(positions.size()), rate,
+                            EBUR128_MODE_S | EBUR128_MODE_I | EBUR128_MODE_LRA | EBUR128_MODE_SAMPLE_PEAK);
+
+  if (ebur_state == nullptr) {
+    return false;
+  }
+
+  for (uint n = 0U; n < positions.size(); n++) {
+    ebur128_set_channel(ebur_state, n, channel_layout::ebur128_channel(positions[n]));
+  }
 
   set_maximum_history(settings->maximumHistory());
 
@@ -133,8 +142,8 @@ void Autogain::setup() {
   attack_coeff = std::exp(-block_time / attack_time);
   release_coeff = std::exp(-block_time / release_time);
 
-  if (2U * static_cast<size_t>(n_samples) != data.size()) {
-    data.resize(static_cast<size_t>(n_samples) * 2U);
+  if (channel_layout::n_channels() * static_cast<size_t>(n_samples) != data.size()) {
+    data.resize(static_cast<size_t>(n_samples) * channel_layout::n_channels());
   }
 
   // There is no need to reset libebur128 when n_samples change.
@@ -178,6 +187,8 @@ void Autogain::process(std::span<float>& left_in,
     std::ranges::copy(left_in, left_out.begin());
     std::ranges::copy(right_in, right_out.begin());
 
+    copy_extra_channels(1.0F);
+
     return;
   }
 
@@ -195,20 +206,34 @@ void Autogain::process(std::span<float>& left_in,
       apply_gain(left_out, right_out, final_gain);
     }
 
+    copy_extra_channels(input_gain * final_gain);
+
     return;
   }
 
+  const auto n_channels = 2U + extra_in.size();
+
   {
     const float* __restrict__ l = left_in.data();
     const float* __restrict__ r = right_in.data();
     float* __restrict__ d = data.data();
 
     for (size_t i = 0; i < n_samples; ++i) {
-      const size_t idx = i * 2;
+      const size_t idx = i * n_channels;
 
       d[idx] = l[i];
       d[idx + 1] = r[i];
     }
+
+    // The extra channels did not get the input gain yet. FL and FR got it in place.
+
+    for (size_t n = 0U; n < extra_in.size(); n++) {
+      const float* __restrict__ e = extra_in[n].data();
+
+      for (size_t i = 0; i < n_samples; ++i) {
+        d[(i * n_channels) + 2U + n] = e[i] * input_gain;
+      }
+    }
   }
 
   ebur128_add_frames_float(ebur_state, data.data(), n_samples);
@@ -256,15 +281,16 @@ void Autogain::process(std::span<float>& left_in,
   }
 
   if (momentary > settings->silenceThreshold() && !failed) {
-    double peak_L = 0.0;
-    double peak_R = 0.0;
+    double peak = 0.0;
 
-    if (EBUR128_SUCCESS != ebur128_prev_sample_peak(ebur_state, 0U, &peak_L)) {
-      failed = true;
-    }
+    for (uint n = 0U; n < n_channels; n++) {
+      double channel_peak = 0.0;
 
-    if (EBUR128_SUCCESS != ebur128_prev_sample_peak(ebur_state, 1U, &peak_R)) {
-      failed = true;
+      if (EBUR128_SUCCESS != ebur128_prev_sample_peak(ebur_state, n, &channel_peak)) {
+        failed = true;
+      }
+
+      peak = std::max(peak, channel_peak);
     }
 
     if (!failed) {
@@ -317,8 +343,6 @@ void Autogain::process(std::span<float>& left_in,
       // 10^(diff/20). The way below should be faster than using pow
       const double gain = std::exp((diff / 20.0) * std::numbers::ln10);
 
-      const double peak = (peak_L > peak_R) ? peak_L : peak_R;
-
       const auto db_peak = util::linear_to_db(peak);
 
       if (db_peak > util::minimum_db_level) {
@@ -348,11 +372,23 @@ void Autogain::process(std::span<float>& left_in,
     apply_gain(left_out, right_out, final_gain);
   }
 
+  copy_extra_channels(input_gain * final_gain);
+
   if (updateLevelMeters) {
     get_peaks(left_in, right_in, left_out, right_out);
   }
 }
 
+void Autogain::copy_extra_channels(const float& gain) {
+  for (size_t n = 0U; n < extra_in.size(); n++) {
+    std::ranges::transform(extra_in[n], extra_out[n].begin(), [gain](const float& v) { return v * gain; });
+  }
+}
+
+void Autogain::process_extra_channels(std::span<std::span<float>> in, std::span<std::span<float>> out) {
+  fold_extra_peaks(in, out, bypass ? 1.0F : input_gain);
+}
+
 void Autogain::process([[maybe_unused]] std::span<float>& left_in,
                        [[maybe_unused]] std::span<float>& right_in,
                        [[maybe_unused]] std::span<float>& left_out,
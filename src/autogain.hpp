@@ -63,6 +63,12 @@ class Autogain : public PluginBase {
                std::span<float>& probe_left,
                std::span<float>& probe_right) override;
 
+  /**
+   * process() already wrote the extra channels, because they are part of the
+   * measured loudness and get the same gain as FL and FR.
+   */
+  void process_extra_channels(std::span<std::span<float>> in, std::span<std::span<float>> out) override;
+
   auto get_latency_seconds() -> float override;
 
   Q_INVOKABLE [[nodiscard]] float getMomentaryLevel() const;
@@ -109,4 +115,6 @@ class Autogain : public PluginBase {
   auto init_ebur128() -> bool;
 
   void set_maximum_history(const int& seconds);
+
+  void copy_extra_channels(const float& gain);
 };
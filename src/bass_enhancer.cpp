@@ -62,6 +62,8 @@ BassEnhancer::BassEnhancer(const std::string& tag,
 
   init_common_controls<DbBassEnhancer>(settings);
 
+  enable_oversampling();
+
   // specific plugin controls
 
   BIND_LV2_PORT("listen", listen, setListen, DbBassEnhancer::listenChanged);
@@ -115,9 +117,11 @@ void BassEnhancer::setup() {
     return;
   }
 
-  lv2_wrapper->set_n_samples(n_samples);
+  setup_oversampling();
+
+  lv2_wrapper->set_n_samples(lv2_n_samples());
 
-  if (lv2_wrapper->has_instance() && rate == lv2_wrapper->get_rate()) {
+  if (lv2_wrapper->has_instance() && lv2_rate() == lv2_wrapper->get_rate()) {
     return;
   }
 
@@ -127,7 +131,7 @@ void BassEnhancer::setup() {
   QMetaObject::invokeMethod(
       baseWorker,
       [this] {
-        lv2_wrapper->create_instance(rate);
+        lv2_wrapper->create_instance(lv2_rate());
 
         std::scoped_lock<std::mutex> lock(data_mutex);
 
@@ -165,8 +169,13 @@ void BassEnhancer::process(std::span<float>& left_in,
     apply_gain(left_in, right_in, input_gain);
   }
 
-  lv2_wrapper->connect_data_ports(left_in, right_in, left_out, right_out);
-  lv2_wrapper->run();
+  run_lv2(left_in, right_in, left_out, right_out);
+
+  if (latency_value != oversampling_latency()) {
+    latency_value = oversampling_latency();
+
+    update_filter_params();
+  }
 
   if (output_gain != 1.0F) {
     apply_gain(left_out, right_out, output_gain);
@@ -187,7 +196,7 @@ void BassEnhancer::process([[maybe_unused]] std::span<float>& left_in,
                            [[maybe_unused]] std::span<float>& probe_right) {}
 
 auto BassEnhancer::get_latency_seconds() -> float {
-  return 0.0F;
+  return latency_value;
 }
 
 float BassEnhancer::getHarmonicsLevel() const {
@@ -62,6 +62,8 @@ BassLoudness::BassLoudness(const std::string& tag,
 
   init_common_controls<DbBassLoudness>(settings);
 
+  enable_lv2_extra_channels();
+
   BIND_LV2_PORT_DB("loudness", loudness, setLoudness, DbBassLoudness::loudnessChanged, false);
   BIND_LV2_PORT_DB("output", output, setOutput, DbBassLoudness::outputChanged, false);
   BIND_LV2_PORT_DB("link", link, setLink, DbBassLoudness::linkChanged, false);
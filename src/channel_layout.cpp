@@ -0,0 +1,118 @@
+/**
+ * Copyright © 2017-2026 Wellington Wallace
+ *
+ * This file is part of Easy Effects.
+ *
+ * Easy Effects is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Easy Effects is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "channel_layout.hpp"
+#include <ebur128.h>
+#include <sys/types.h>
+#include <array>
+#include <numbers>
+#include <string>
+#include <vector>
+#include "db_manager.hpp"
+
+namespace channel_layout {
+
+auto positions() -> const std::vector<std::string>& {
+  static const std::vector<std::string> list = []() -> std::vector<std::string> {
+    switch (DbMain::channelLayout()) {
+      case DbMain::EnumChannelLayout::surround51:
+        return {"FL", "FR", "FC", "LFE", "SL", "SR"};
+      case DbMain::EnumChannelLayout::surround71:
+        return {"FL", "FR", "FC", "LFE", "SL", "SR", "RL", "RR"};
+      default:
+        return {"FL", "FR"};
+    }
+  }();
+
+  return list;
+}
+
+auto n_channels() -> uint {
+  return static_cast<uint>(positions().size());
+}
+
+auto audio_position() -> std::string {
+  std::string result;
+
+  for (const auto& p : positions()) {
+    result += result.empty() ? p : "," + p;
+  }
+
+  return result;
+}
+
+auto downmix_gains(const std::string& position) -> std::array<float, 2> {
+  constexpr auto minus_3db = std::numbers::sqrt2_v<float> * 0.5F;
+
+  if (position == "FL") {
+    return {1.0F, 0.0F};
+  }
+
+  if (position == "FR") {
+    return {0.0F, 1.0F};
+  }
+
+  if (position == "FC") {
+    return {minus_3db, minus_3db};
+  }
+
+  if (position == "SL" || position == "RL") {
+    return {minus_3db, 0.0F};
+  }
+
+  if (position == "SR" || position == "RR") {
+    return {0.0F, minus_3db};
+  }
+
+  return {0.0F, 0.0F};
+}
+
+auto ebur128_channel(const std::string& position) -> int {
+  if (position == "FL") {
+    return EBUR128_LEFT;
+  }
+
+  if (position == "FR") {
+    return EBUR128_RIGHT;
+  }
+
+  if (position == "FC") {
+    return EBUR128_CENTER;
+  }
+
+  if (position == "SL") {
+    return EBUR128_LEFT_SURROUND;
+  }
+
+  if (position == "SR") {
+    return EBUR128_RIGHT_SURROUND;
+  }
+
+  if (position == "RL") {
+    return EBUR128_Mp135;
+  }
+
+  if (position == "RR") {
+    return EBUR128_Mm135;
+  }
+
+  return EBUR128_UNUSED;
+}
+
+}  // namespace channel_layout
@@ -0,0 +1,53 @@
+/**
+ * Copyright © 2017-2026 Wellington Wallace
+ *
+ * This file is part of Easy Effects.
+ *
+ * Easy Effects is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Easy Effects is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <sys/types.h>
+#include <array>
+#include <string>
+#include <vector>
+
+namespace channel_layout {
+
+/**
+ * Channel positions of the layout chosen in the preferences. The first two
+ * are always FL and FR. The layout is read once on purpose: the virtual
+ * devices and the ports of every filter are created with it, so all of them
+ * have to agree on it until a restart. Output devices with a different channel
+ * map are handled when they are linked. See PluginBase::set_linked_channels().
+ */
+auto positions() -> const std::vector<std::string>&;
+
+auto n_channels() -> uint;
+
+// Comma separated positions, as expected by the audio.position property.
+auto audio_position() -> std::string;
+
+/**
+ * Gains that fold a channel into FL and FR when the output device does not
+ * have it. As in the ITU-R BS.775 downmix the center and the
+ * surrounds are mixed at -3 dB and the LFE is dropped.
+ */
+auto downmix_gains(const std::string& position) -> std::array<float, 2>;
+
+// libebur128 channel type of a position. The LFE is not part of the loudness.
+auto ebur128_channel(const std::string& position) -> int;
+
+}  // namespace channel_layout
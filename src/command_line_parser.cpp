@@ -23,16 +23,17 @@
 #include <qtmetamacros.h>
 #include <KAboutData>
 #include <KLocalizedString>
-#include <QApplication>
+#include <QCoreApplication>
 #include <QLoggingCategory>
 #include <QString>
 #include <cstdlib>
+#include <filesystem>
 #include <iostream>
 #include <memory>
 #include <string>
 #include "easyeffects_db.h"
 #include "pipeline_type.hpp"
-#include "presets_manager.hpp"
+#include "presets_directory_manager.hpp"
 #include "util.hpp"
 
 CommandLineParser::CommandLineParser(KAboutData& about, QObject* parent)
@@ -54,6 +55,7 @@ CommandLineParser::CommandLineParser(KAboutData& about, QObject* parent)
        {{"s", "last-loaded-presets"}, i18n("Get the last loaded input and output presets.")},
        {"gapplication-service", i18n("Deprecated. Use --service-mode instead.")},
        {"service-mode", i18n("Start the application with service mode turned on.")},
+       {"daemon", i18n("Run only the audio engine and the local socket server, without a user interface.")},
        {"debug", i18n("Enable debug messages.")}});
 }
 
@@ -61,7 +63,7 @@ void CommandLineParser::set_is_primary(const bool& state) {
   is_primary = state;
 }
 
-void CommandLineParser::process(KAboutData& about, QApplication* app) {
+void CommandLineParser::process(KAboutData& about, QCoreApplication* app) {
   parser->process(*app);
 
   about.processCommandLine(parser.get());
@@ -80,8 +82,6 @@ void CommandLineParser::process_hide_window(bool& show_window) {
 }
 
 void CommandLineParser::process_events() {
-  auto* pm = &presets::Manager::self();
-
   if (parser->isSet("quit")) {
     Q_EMIT onQuit();
   }
@@ -151,10 +151,12 @@ void CommandLineParser::process_events() {
   }
 
   if (parser->isSet("presets")) {
+    presets::DirectoryManager dir_manager;
+
     std::string list;
     int i = 0;
 
-    for (const auto& p : pm->get_local_presets_paths(PipelineType::output)) {
+    for (const auto& p : dir_manager.getLocalPresetsPaths(PipelineType::output)) {
       list += util::to_string(++i) + '\t' + p.stem().string() + '\n';
     }
 
@@ -167,7 +169,7 @@ void CommandLineParser::process_events() {
     list = "";
     i = 0;
 
-    for (const auto& p : pm->get_local_presets_paths(PipelineType::input)) {
+    for (const auto& p : dir_manager.getLocalPresetsPaths(PipelineType::input)) {
       list += util::to_string(++i) + '\t' + p.stem().string() + '\n';
     }
 
@@ -187,13 +189,22 @@ void CommandLineParser::process_events() {
 
     const auto name = parser->value("load-preset");
 
-    if (pm->preset_file_exists(PipelineType::input, name.toStdString())) {
+    /**
+     * The secondary instance only needs to know whether the preset file is
+     * there. The full presets manager is left to the primary instance.
+     */
+
+    presets::DirectoryManager dir_manager;
+
+    const auto file_name = std::filesystem::path{name.toStdString() + presets::DirectoryManager::json_ext};
+
+    if (std::filesystem::exists(dir_manager.userInputDir() / file_name)) {
       Q_EMIT onLoadPreset(PipelineType::input, name);
 
       ok = true;
     }
 
-    if (pm->preset_file_exists(PipelineType::output, name.toStdString())) {
+    if (std::filesystem::exists(dir_manager.userOutputDir() / file_name)) {
       Q_EMIT onLoadPreset(PipelineType::output, name);
 
       ok = true;
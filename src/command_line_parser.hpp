@@ -20,7 +20,7 @@
 #pragma once
 
 #include <qtmetamacros.h>
-#include <QApplication>
+#include <QCoreApplication>
 #include <QCommandLineParser>
 #include <QObject>
 #include <memory>
@@ -34,7 +34,7 @@ class CommandLineParser : public QObject {
  public:
   explicit CommandLineParser(KAboutData& about, QObject* parent = nullptr);
 
-  void process(KAboutData& about, QApplication* app);
+  void process(KAboutData& about, QCoreApplication* app);
 
   void process_debug_option();
 
@@ -59,10 +59,22 @@ Compressor::Compressor(const std::string& tag, pw::Manager* pipe_manager, Pipeli
 
   if (!packageInstalled) {
     util::debug(std::format("{}{} is not installed", log_tag, lv2_plugin_uri));
+  } else {
+    meter_ports = {.latency = lv2_wrapper->get_control_port_index("out_latency"),
+                   .reduction_left = lv2_wrapper->get_control_port_index("rlm_l"),
+                   .reduction_right = lv2_wrapper->get_control_port_index("rlm_r"),
+                   .sidechain_left = lv2_wrapper->get_control_port_index("slm_l"),
+                   .sidechain_right = lv2_wrapper->get_control_port_index("slm_r"),
+                   .curve_left = lv2_wrapper->get_control_port_index("clm_l"),
+                   .curve_right = lv2_wrapper->get_control_port_index("clm_r"),
+                   .envelope_left = lv2_wrapper->get_control_port_index("elm_l"),
+                   .envelope_right = lv2_wrapper->get_control_port_index("elm_r")};
   }
 
   init_common_controls<DbCompressor>(settings);
 
+  enable_lv2_extra_channels();
+
   // specific plugin controls
 
   connect(settings, &DbCompressor::sidechainTypeChanged, [&]() { update_sidechain_links(); });
@@ -211,7 +223,7 @@ void Compressor::process(std::span<float>& left_in,
 
   // This plugin gives the latency in number of samples
 
-  const auto lv = static_cast<uint>(lv2_wrapper->get_control_port_value("out_latency"));
+  const auto lv = static_cast<uint>(lv2_wrapper->get_control_port_value(meter_ports.latency));
 
   if (latency_n_frames != lv) {
     latency_n_frames = lv;
@@ -226,17 +238,16 @@ void Compressor::process(std::span<float>& left_in,
   if (updateLevelMeters) {
     get_peaks(left_in, right_in, left_out, right_out);
 
-    reduction_left = util::linear_to_db(lv2_wrapper->get_control_port_value("rlm_l"));
-    reduction_right = util::linear_to_db(lv2_wrapper->get_control_port_value("rlm_r"));
-
-    sidechain_left = util::linear_to_db(lv2_wrapper->get_control_port_value("slm_l"));
-    sidechain_right = util::linear_to_db(lv2_wrapper->get_control_port_value("slm_r"));
-
-    curve_left = util::linear_to_db(lv2_wrapper->get_control_port_value("clm_l"));
-    curve_right = util::linear_to_db(lv2_wrapper->get_control_port_value("clm_r"));
+    auto db = [&](const uint& port) { return util::linear_to_db(lv2_wrapper->get_control_port_value(port)); };
 
-    envelope_left = util::linear_to_db(lv2_wrapper->get_control_port_value("elm_l"));
-    envelope_right = util::linear_to_db(lv2_wrapper->get_control_port_value("elm_r"));
+    meters.write({.reduction_left = db(meter_ports.reduction_left),
+                  .reduction_right = db(meter_ports.reduction_right),
+                  .sidechain_left = db(meter_ports.sidechain_left),
+                  .sidechain_right = db(meter_ports.sidechain_right),
+                  .curve_left = db(meter_ports.curve_left),
+                  .curve_right = db(meter_ports.curve_right),
+                  .envelope_left = db(meter_ports.envelope_left),
+                  .envelope_right = db(meter_ports.envelope_right)});
   }
 }
 
@@ -272,34 +283,38 @@ auto Compressor::get_latency_seconds() -> float {
   return this->latency_value;
 }
 
+void Compressor::refreshMeters() {
+  meters.read();
+}
+
 float Compressor::getReductionLevelLeft() const {
-  return reduction_left;
+  return meters.latest().reduction_left;
 }
 
 float Compressor::getReductionLevelRight() const {
-  return reduction_right;
+  return meters.latest().reduction_right;
 }
 
 float Compressor::getSideChainLevelLeft() const {
-  return sidechain_left;
+  return meters.latest().sidechain_left;
 }
 
 float Compressor::getSideChainLevelRight() const {
-  return sidechain_right;
+  return meters.latest().sidechain_right;
 }
 
 float Compressor::getCurveLevelLeft() const {
-  return curve_left;
+  return meters.latest().curve_left;
 }
 
 float Compressor::getCurveLevelRight() const {
-  return curve_right;
+  return meters.latest().curve_right;
 }
 
 float Compressor::getEnvelopeLevelLeft() const {
-  return envelope_left;
+  return meters.latest().envelope_left;
 }
 
 float Compressor::getEnvelopeLevelRight() const {
-  return envelope_right;
+  return meters.latest().envelope_right;
 }
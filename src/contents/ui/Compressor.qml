@@ -38,6 +38,7 @@ Kirigami.ScrollablePage {
         if (!compressorPage.pluginBackend)
             return;
 
+        compressorPage.pluginBackend.refreshMeters();
         inputOutputLevels.setInputLevelLeft(compressorPage.pluginBackend.getInputLevelLeft());
         inputOutputLevels.setInputLevelRight(compressorPage.pluginBackend.getInputLevelRight());
         inputOutputLevels.setOutputLevelLeft(compressorPage.pluginBackend.getOutputLevelLeft());
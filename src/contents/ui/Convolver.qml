@@ -373,7 +373,7 @@ Kirigami.ScrollablePage {
                     uniformCellWidths: true
                     rowSpacing: Kirigami.Units.largeSpacing
                     columnSpacing: Kirigami.Units.largeSpacing
-                    columns: 5
+                    columns: 6
                     rows: 2
 
                     Controls.Label {
@@ -401,6 +401,11 @@ Kirigami.ScrollablePage {
                         text: i18n("Format") // qmllint disable
                     }
 
+                    Controls.Label {
+                        Layout.alignment: Qt.AlignHCenter
+                        text: i18n("Saved") // qmllint disable
+                    }
+
                     Controls.Label {
                         id: irRate
 
@@ -440,6 +445,14 @@ Kirigami.ScrollablePage {
                         text: (convolverPage.pluginBackend ? convolverPage.pluginBackend.kernelIsSofa : false) ? Units.sofa : Units.wav
                         enabled: false
                     }
+
+                    Controls.Label {
+                        id: irTrimSavings
+
+                        Layout.alignment: Qt.AlignHCenter
+                        text: Number(convolverPage.pluginBackend ? 100 * convolverPage.pluginBackend.kernelTrimSavings : 0).toLocaleString(Qt.locale(), 'f', 1) + ` ${Units.percent}`
+                        enabled: false
+                    }
                 }
             }
         }
@@ -505,6 +518,41 @@ Kirigami.ScrollablePage {
                     convolverPage.pluginDB.wet = v;
                 }
             }
+
+            EeSpinBox {
+                id: trimThreshold
+
+                label: i18n("Trim threshold") // qmllint disable
+                labelAbove: true
+                spinboxLayoutFillWidth: true
+                from: convolverPage.pluginDB.getMinValue("trimThreshold")
+                to: convolverPage.pluginDB.getMaxValue("trimThreshold")
+                value: convolverPage.pluginDB.trimThreshold
+                decimals: 0
+                stepSize: 1
+                unit: Units.dB
+                enabled: convolverPage.pluginDB.trimTail
+                onValueModified: v => {
+                    convolverPage.pluginDB.trimThreshold = v;
+                }
+            }
+
+            EeSpinBox {
+                id: maxKernelDuration
+
+                label: i18n("Maximum length") // qmllint disable
+                labelAbove: true
+                spinboxLayoutFillWidth: true
+                from: convolverPage.pluginDB.getMinValue("maxKernelDuration")
+                to: convolverPage.pluginDB.getMaxValue("maxKernelDuration")
+                value: convolverPage.pluginDB.maxKernelDuration
+                decimals: 0
+                stepSize: 10
+                unit: Units.ms
+                onValueModified: v => {
+                    convolverPage.pluginDB.maxKernelDuration = v;
+                }
+            }
         }
     }
 
@@ -542,6 +590,16 @@ Kirigami.ScrollablePage {
                             convolverPage.pluginDB.autogain = checked;
                     }
                 },
+                Kirigami.Action {
+                    text: i18n("Trim Tail") // qmllint disable
+                    icon.name: "edit-cut-symbolic"
+                    checkable: true
+                    checked: convolverPage.pluginDB.trimTail
+                    onTriggered: {
+                        if (checked !== convolverPage.pluginDB.trimTail)
+                            convolverPage.pluginDB.trimTail = checked;
+                    }
+                },
                 Kirigami.Action {
                     text: Units.sofa
                     icon.name: "waveform-symbolic"
@@ -40,6 +40,7 @@ Kirigami.ScrollablePage {
         inputOutputLevels.setInputLevelRight(echoCancellerPage.pluginBackend.getInputLevelRight());
         inputOutputLevels.setOutputLevelLeft(echoCancellerPage.pluginBackend.getOutputLevelLeft());
         inputOutputLevels.setOutputLevelRight(echoCancellerPage.pluginBackend.getOutputLevelRight());
+        estimatedDelay.setValue(echoCancellerPage.pluginBackend.getEstimatedDelay());
     }
 
     Component.onCompleted: {
@@ -85,6 +86,27 @@ Kirigami.ScrollablePage {
                             echoCancellerPage.pluginDB.echoCancellerEnforceHighPass = isChecked;
                     }
                 }
+
+                EeSwitch {
+                    label: i18n("Delay estimation") // qmllint disable
+                    subtitle: i18n("Aligns the speaker signal with the echo it produces in the microphone") // qmllint disable
+                    isChecked: echoCancellerPage.pluginDB.enableDelayEstimation
+                    onCheckedChanged: {
+                        if (isChecked !== echoCancellerPage.pluginDB.enableDelayEstimation)
+                            echoCancellerPage.pluginDB.enableDelayEstimation = isChecked;
+                    }
+                }
+
+                EeProgressBar {
+                    id: estimatedDelay
+
+                    label: i18n("Estimated delay") // qmllint disable
+                    unit: Units.ms
+                    from: 0
+                    to: 500
+                    decimals: 1
+                    visible: echoCancellerPage.pluginDB.enableDelayEstimation
+                }
             }
 
             EeCard {
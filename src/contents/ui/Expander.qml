@@ -38,6 +38,7 @@ Kirigami.ScrollablePage {
         if (!expanderPage.pluginBackend)
             return;
 
+        expanderPage.pluginBackend.refreshMeters();
         inputOutputLevels.setInputLevelLeft(expanderPage.pluginBackend.getInputLevelLeft());
         inputOutputLevels.setInputLevelRight(expanderPage.pluginBackend.getInputLevelRight());
         inputOutputLevels.setOutputLevelLeft(expanderPage.pluginBackend.getOutputLevelLeft());
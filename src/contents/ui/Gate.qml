@@ -38,6 +38,7 @@ Kirigami.ScrollablePage {
         if (!gatePage.pluginBackend)
             return;
 
+        gatePage.pluginBackend.refreshMeters();
         inputOutputLevels.setInputLevelLeft(gatePage.pluginBackend.getInputLevelLeft());
         inputOutputLevels.setInputLevelRight(gatePage.pluginBackend.getInputLevelRight());
         inputOutputLevels.setOutputLevelLeft(gatePage.pluginBackend.getOutputLevelLeft());
@@ -38,6 +38,7 @@ Kirigami.ScrollablePage {
         if (!limiterPage.pluginBackend)
             return;
 
+        limiterPage.pluginBackend.refreshMeters();
         inputOutputLevels.setInputLevelLeft(limiterPage.pluginBackend.getInputLevelLeft());
         inputOutputLevels.setInputLevelRight(limiterPage.pluginBackend.getInputLevelRight());
         inputOutputLevels.setOutputLevelLeft(limiterPage.pluginBackend.getOutputLevelLeft());
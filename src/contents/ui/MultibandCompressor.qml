@@ -49,6 +49,7 @@ Kirigami.ScrollablePage {
         if (!multibandCompressorPage.pluginBackend)
             return;
 
+        multibandCompressorPage.pluginBackend.refreshMeters();
         inputOutputLevels.setInputLevelLeft(multibandCompressorPage.pluginBackend.getInputLevelLeft());
         inputOutputLevels.setInputLevelRight(multibandCompressorPage.pluginBackend.getInputLevelRight());
         inputOutputLevels.setOutputLevelLeft(multibandCompressorPage.pluginBackend.getOutputLevelLeft());
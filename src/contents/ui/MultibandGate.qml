@@ -49,6 +49,7 @@ Kirigami.ScrollablePage {
         if (!multibandGatePage.pluginBackend)
             return;
 
+        multibandGatePage.pluginBackend.refreshMeters();
         inputOutputLevels.setInputLevelLeft(multibandGatePage.pluginBackend.getInputLevelLeft());
         inputOutputLevels.setInputLevelRight(multibandGatePage.pluginBackend.getInputLevelRight());
         inputOutputLevels.setOutputLevelLeft(multibandGatePage.pluginBackend.getOutputLevelLeft());
@@ -22,6 +22,7 @@ import QtQuick
 import QtQuick.Controls as Controls
 import QtQuick.Layouts
 import "Common.js" as Common
+import ee.pipeline as Pipeline
 import ee.pipewire as PW
 import org.kde.kirigami as Kirigami
 import org.kde.kirigamiaddons.delegates as Delegates
@@ -437,6 +438,91 @@ Kirigami.Page {
                     }
                 }
             }
+
+            FormCard.FormHeader {
+                title: i18n("Measurement") // qmllint disable
+            }
+
+            FormCard.FormSectionText {
+                text: i18n("Plays a stimulus through the output pipeline and measures its latency and frequency response. Nothing else should be playing while it runs.") // qmllint disable
+            }
+
+            FormCard.FormCard {
+                FormCard.FormRadioDelegate {
+                    text: i18n("Logarithmic sweep") // qmllint disable
+                    checked: DbTestSignals.measurementStimulus === 0
+                    enabled: !Pipeline.Measurement.running
+                    onCheckedChanged: {
+                        if (checked && DbTestSignals.measurementStimulus !== 0)
+                            DbTestSignals.measurementStimulus = 0;
+                    }
+                }
+
+                FormCard.FormRadioDelegate {
+                    text: i18n("Maximum length sequence") // qmllint disable
+                    checked: DbTestSignals.measurementStimulus === 1
+                    enabled: !Pipeline.Measurement.running
+                    onCheckedChanged: {
+                        if (checked && DbTestSignals.measurementStimulus !== 1)
+                            DbTestSignals.measurementStimulus = 1;
+                    }
+                }
+
+                FormCard.FormButtonDelegate {
+                    text: Pipeline.Measurement.running ? i18n("Cancel") : i18n("Measure") // qmllint disable
+                    icon.name: Pipeline.Measurement.running ? "process-stop-symbolic" : "media-playback-start-symbolic"
+                    onClicked: {
+                        if (Pipeline.Measurement.running)
+                            Pipeline.Measurement.cancel();
+                        else
+                            Pipeline.Measurement.start(DbTestSignals.measurementStimulus);
+                    }
+                }
+
+                FormCard.FormTextDelegate {
+                    text: i18n("Status") // qmllint disable
+                    description: Pipeline.Measurement.status
+                    visible: Pipeline.Measurement.status !== ""
+                }
+
+                FormCard.FormTextDelegate {
+                    text: i18n("Measured latency") // qmllint disable
+                    description: `${Pipeline.Measurement.measuredLatency.toFixed(2)} ${Units.ms}`
+                }
+
+                FormCard.FormTextDelegate {
+                    text: i18n("Reported latency") // qmllint disable
+                    description: `${Pipeline.Measurement.reportedLatency.toFixed(2)} ${Units.ms}`
+                }
+
+                EeChart {
+                    id: measurementChart
+
+                    Layout.fillWidth: true
+                    implicitHeight: Kirigami.Units.gridUnit * 12
+                    seriesType: 1 // spline series
+                    colorScheme: DbGraph.colorScheme
+                    colorTheme: DbGraph.colorTheme
+                    xMin: 20
+                    xMax: 20000
+                    xUnit: Units.hz
+                    yUnit: Units.dB
+                    yAxisDecimals: 1
+                    logarithimicHorizontalAxis: true
+
+                    Component.onCompleted: {
+                        measurementChart.updateData(Pipeline.Measurement.getResponse(0));
+                    }
+
+                    Connections {
+                        function onFinished() {
+                            measurementChart.updateData(Pipeline.Measurement.getResponse(0));
+                        }
+
+                        target: Pipeline.Measurement
+                    }
+                }
+            }
         }
     }
 
@@ -238,6 +238,187 @@ KirigamiSettings.ConfigurationView {
                     }
                 }
 
+                EeSwitch {
+                    id: smoothControlPorts
+
+                    label: i18n("Smooth parameter changes") // qmllint disable
+                    subtitle: i18n("Gradually apply the new value of a plugin parameter over the audio buffer instead of changing it at once. This avoids clicks and zipper noise when parameters are adjusted while audio is playing.") // qmllint disable
+                    maximumLineCount: -1
+                    isChecked: DbMain.smoothControlPorts
+                    onCheckedChanged: {
+                        if (isChecked !== DbMain.smoothControlPorts)
+                            DbMain.smoothControlPorts = isChecked;
+                    }
+                }
+
+                EeSwitch {
+                    id: spliceBypassedPlugins
+
+                    label: i18n("Remove bypassed plugins from the pipeline") // qmllint disable
+                    subtitle: i18n("Bypassed plugins are unlinked and stop processing audio, saving CPU. Enabling or disabling one relinks the pipeline, which may cause a short audio interruption.") // qmllint disable
+                    maximumLineCount: -1
+                    isChecked: DbMain.spliceBypassedPlugins
+                    onCheckedChanged: {
+                        if (isChecked !== DbMain.spliceBypassedPlugins)
+                            DbMain.spliceBypassedPlugins = isChecked;
+                    }
+                }
+
+                EeSwitch {
+                    id: pipelineDataLoops
+
+                    label: i18n("Separate processing threads") // qmllint disable
+                    subtitle: i18n("Output and input effects run on their own PipeWire threads, so heavy microphone processing does not delay the speakers. Requires PipeWire 1.1 or newer and takes effect after a restart.") // qmllint disable
+                    maximumLineCount: -1
+                    isChecked: DbMain.pipelineDataLoops
+                    onCheckedChanged: {
+                        if (isChecked !== DbMain.pipelineDataLoops)
+                            DbMain.pipelineDataLoops = isChecked;
+                    }
+                }
+
+                EeSpinBox {
+                    id: outputLoopCpu
+
+                    label: i18n("Output thread CPU") // qmllint disable
+                    subtitle: i18n("CPU core the output effects thread is pinned to. Use -1 to let the system choose.") // qmllint disable
+                    maximumLineCount: -1
+                    from: DbMain.getMinValue("outputLoopCpu")
+                    to: DbMain.getMaxValue("outputLoopCpu")
+                    value: DbMain.outputLoopCpu
+                    decimals: 0
+                    stepSize: 1
+                    enabled: DbMain.pipelineDataLoops
+                    onValueModified: v => {
+                        DbMain.outputLoopCpu = v;
+                    }
+                }
+
+                EeSpinBox {
+                    id: outputLoopRtPriority
+
+                    label: i18n("Output thread priority") // qmllint disable
+                    subtitle: i18n("Realtime priority of the output effects thread. Use -1 for the PipeWire default.") // qmllint disable
+                    maximumLineCount: -1
+                    from: DbMain.getMinValue("outputLoopRtPriority")
+                    to: DbMain.getMaxValue("outputLoopRtPriority")
+                    value: DbMain.outputLoopRtPriority
+                    decimals: 0
+                    stepSize: 1
+                    enabled: DbMain.pipelineDataLoops
+                    onValueModified: v => {
+                        DbMain.outputLoopRtPriority = v;
+                    }
+                }
+
+                EeSpinBox {
+                    id: inputLoopCpu
+
+                    label: i18n("Input thread CPU") // qmllint disable
+                    subtitle: i18n("CPU core the input effects thread is pinned to. Use -1 to let the system choose.") // qmllint disable
+                    maximumLineCount: -1
+                    from: DbMain.getMinValue("inputLoopCpu")
+                    to: DbMain.getMaxValue("inputLoopCpu")
+                    value: DbMain.inputLoopCpu
+                    decimals: 0
+                    stepSize: 1
+                    enabled: DbMain.pipelineDataLoops
+                    onValueModified: v => {
+                        DbMain.inputLoopCpu = v;
+                    }
+                }
+
+                EeSpinBox {
+                    id: inputLoopRtPriority
+
+                    label: i18n("Input thread priority") // qmllint disable
+                    subtitle: i18n("Realtime priority of the input effects thread. Use -1 for the PipeWire default.") // qmllint disable
+                    maximumLineCount: -1
+                    from: DbMain.getMinValue("inputLoopRtPriority")
+                    to: DbMain.getMaxValue("inputLoopRtPriority")
+                    value: DbMain.inputLoopRtPriority
+                    decimals: 0
+                    stepSize: 1
+                    enabled: DbMain.pipelineDataLoops
+                    onValueModified: v => {
+                        DbMain.inputLoopRtPriority = v;
+                    }
+                }
+
+                EeSwitch {
+                    id: oversampleNonlinearPlugins
+
+                    label: i18n("Oversample nonlinear effects") // qmllint disable
+                    subtitle: i18n("Exciter, Bass Enhancer, Bit Crusher and Maximizer process audio at twice the sampling rate, which reduces the aliasing caused by the harmonics they generate. Uses more CPU and adds a small latency.") // qmllint disable
+                    maximumLineCount: -1
+                    isChecked: DbMain.oversampleNonlinearPlugins
+                    onCheckedChanged: {
+                        if (isChecked !== DbMain.oversampleNonlinearPlugins)
+                            DbMain.oversampleNonlinearPlugins = isChecked;
+                    }
+                }
+
+                FormCard.FormComboBoxDelegate {
+                    id: channelLayout
+
+                    text: i18n("Channel layout") // qmllint disable
+                    description: i18n("Number of channels of the Easy Effects virtual devices and pipelines. Only the front left and right channels go through the effects that are stereo only. Takes effect after a restart.") // qmllint disable
+                    displayMode: FormCard.FormComboBoxDelegate.ComboBox
+                    currentIndex: DbMain.channelLayout
+                    editable: false
+                    model: [i18n("Stereo"), i18n("5.1 Surround"), i18n("7.1 Surround")] // qmllint disable
+                    onActivated: idx => {
+                        if (idx !== DbMain.channelLayout)
+                            DbMain.channelLayout = idx;
+                    }
+                }
+
+                EeSpinBox {
+                    id: idlePluginPoolSize
+
+                    label: i18n("Removed plugins kept loaded") // qmllint disable
+                    subtitle: i18n("Plugins removed from a pipeline stay loaded for a while, so that switching back to a preset that uses them is instant. Higher values use more memory.") // qmllint disable
+                    maximumLineCount: -1
+                    from: DbMain.getMinValue("idlePluginPoolSize")
+                    to: DbMain.getMaxValue("idlePluginPoolSize")
+                    value: DbMain.idlePluginPoolSize
+                    decimals: 0
+                    stepSize: 1
+                    onValueModified: v => {
+                        DbMain.idlePluginPoolSize = v;
+                    }
+                }
+
+                EeSwitch {
+                    id: seamlessPresetSwitching
+
+                    label: i18n("Seamless preset switching") // qmllint disable
+                    subtitle: i18n("The effects of a new preset are loaded while the current ones keep playing, then the sound crossfades to them. Uses more CPU during the switch.") // qmllint disable
+                    maximumLineCount: -1
+                    isChecked: DbMain.seamlessPresetSwitching
+                    onCheckedChanged: {
+                        if (isChecked !== DbMain.seamlessPresetSwitching)
+                            DbMain.seamlessPresetSwitching = isChecked;
+                    }
+                }
+
+                EeSpinBox {
+                    id: presetCrossfadeDuration
+
+                    label: i18n("Preset crossfade duration") // qmllint disable
+                    maximumLineCount: -1
+                    from: DbMain.getMinValue("presetCrossfadeDuration")
+                    to: DbMain.getMaxValue("presetCrossfadeDuration")
+                    value: DbMain.presetCrossfadeDuration
+                    decimals: 0
+                    stepSize: 5
+                    unit: Units.ms
+                    enabled: DbMain.seamlessPresetSwitching
+                    onValueModified: v => {
+                        DbMain.presetCrossfadeDuration = v;
+                    }
+                }
+
                 EeSwitch {
                     id: inactivityTimerEnable
 
@@ -363,6 +544,85 @@ KirigamiSettings.ConfigurationView {
                 }
             }
 
+            FormCard.FormHeader {
+                title: i18n("Analysis") // qmllint disable
+            }
+
+            FormCard.FormCard {
+                FormCard.FormComboBoxDelegate {
+                    id: fftSize
+
+                    text: i18n("FFT size") // qmllint disable
+                    displayMode: FormCard.FormComboBoxDelegate.ComboBox
+                    currentIndex: DbSpectrum.fftSize
+                    editable: false
+                    model: ["1024", "2048", "4096", "8192", "16384", "32768"]
+                    onActivated: idx => {
+                        if (idx !== DbSpectrum.fftSize)
+                            DbSpectrum.fftSize = idx;
+                    }
+                }
+
+                FormCard.FormComboBoxDelegate {
+                    id: overlap
+
+                    text: i18n("Overlap") // qmllint disable
+                    displayMode: FormCard.FormComboBoxDelegate.ComboBox
+                    currentIndex: DbSpectrum.overlap
+                    editable: false
+                    model: [i18n("None"), "50%", "75%", "87.5%"] // qmllint disable
+                    onActivated: idx => {
+                        if (idx !== DbSpectrum.overlap)
+                            DbSpectrum.overlap = idx;
+                    }
+                }
+
+                FormCard.FormComboBoxDelegate {
+                    id: windowFunction
+
+                    text: i18n("Window") // qmllint disable
+                    displayMode: FormCard.FormComboBoxDelegate.ComboBox
+                    currentIndex: DbSpectrum.windowFunction
+                    editable: false
+                    model: [i18n("Hann"), i18n("Hamming"), i18n("Blackman-Harris"), i18n("Flat Top"), i18n("Rectangular")] // qmllint disable
+                    onActivated: idx => {
+                        if (idx !== DbSpectrum.windowFunction)
+                            DbSpectrum.windowFunction = idx;
+                    }
+                }
+
+                FormCard.FormComboBoxDelegate {
+                    id: averaging
+
+                    text: i18n("Averaging") // qmllint disable
+                    displayMode: FormCard.FormComboBoxDelegate.ComboBox
+                    currentIndex: DbSpectrum.averaging
+                    editable: false
+                    model: [i18n("None"), i18n("Exponential"), i18n("Peak Hold")] // qmllint disable
+                    onActivated: idx => {
+                        if (idx !== DbSpectrum.averaging)
+                            DbSpectrum.averaging = idx;
+                    }
+                }
+
+                EeSpinBox {
+                    id: averagingTime
+
+                    label: i18n("Averaging time") // qmllint disable
+                    maximumLineCount: -1
+                    from: DbSpectrum.getMinValue("averagingTime")
+                    to: DbSpectrum.getMaxValue("averagingTime")
+                    value: DbSpectrum.averagingTime
+                    decimals: 0
+                    stepSize: 10
+                    unit: Units.ms
+                    enabled: DbSpectrum.averaging !== 0
+                    onValueModified: v => {
+                        DbSpectrum.averagingTime = v;
+                    }
+                }
+            }
+
             FormCard.FormHeader {
                 title: i18n("Graph") // qmllint disable
             }
@@ -25,7 +25,6 @@
 #include <qobjectdefs.h>
 #include <qpoint.h>
 #include <qstandardpaths.h>
-#include <qthread.h>
 #include <qtmetamacros.h>
 #include <qtypes.h>
 #include <sched.h>
@@ -43,6 +42,7 @@
 #include <vector>
 #include "convolver_kernel_fft.hpp"
 #include "convolver_kernel_manager.hpp"
+#include "convolver_kernel_store.hpp"
 #include "db_manager.hpp"
 #include "easyeffects_db_convolver.h"
 #include "pipeline_type.hpp"
@@ -50,6 +50,7 @@
 #include "pw_manager.hpp"
 #include "tags_plugin_name.hpp"
 #include "util.hpp"
+#include "worker_pool.hpp"
 
 Convolver::Convolver(const std::string& tag, pw::Manager* pipe_manager, PipelineType pipe_type, QString instance_id)
     : PluginBase(tag,
@@ -71,6 +72,12 @@ Convolver::Convolver(const std::string& tag, pw::Manager* pipe_manager, Pipeline
 
   connect(settings, &DbConvolver::kernelNameChanged, [&]() { load_kernel_file(true, rate); });
 
+  connect(settings, &DbConvolver::trimTailChanged, [&]() { load_kernel_file(true, rate); });
+
+  connect(settings, &DbConvolver::trimThresholdChanged, [&]() { load_kernel_file(true, rate); });
+
+  connect(settings, &DbConvolver::maxKernelDurationChanged, [&]() { load_kernel_file(true, rate); });
+
   connect(settings, &DbConvolver::irWidthChanged, [&]() {
     std::scoped_lock<std::mutex> lock(data_mutex);
     zita.update_ir_width_and_autogain(settings->irWidth(), settings->autogain(), true);
@@ -91,15 +98,19 @@ Convolver::Convolver(const std::string& tag, pw::Manager* pipe_manager, Pipeline
         (settings->wet() <= util::minimum_db_d_level) ? 0.0F : static_cast<float>(util::db_to_linear(settings->wet()));
   });
 
-  // Preparing the worker thread
+  // Preparing the worker thread. Loading a kernel can take a while, so the convolver does not share a pool thread.
 
-  worker->moveToThread(&workerThread);
+  use_dedicated_worker();
 
-  connect(&workerThread, &QThread::finished, worker, &QObject::deleteLater);
+  // Same thread as the base worker so that kernel loading stays ordered with the instance creation.
+
+  WorkerPool::self().attach(worker, baseWorker);
 
   connect(
       worker, &ConvolverWorker::onNewKernel, this,
-      [this](ConvolverKernelManager::KernelData data, bool init_zita) {
+      [this](ConvolverKernelStore::Kernel kernel, bool init_zita) {
+        const auto& data = *kernel;
+
         kernel_is_initialized = data.isValid();
 
         if (kernel_is_initialized) {
@@ -109,11 +120,22 @@ Convolver::Convolver(const std::string& tag, pw::Manager* pipe_manager, Pipeline
           kernelDuration = QString::fromStdString(util::to_string(data.duration()));
           kernelChannels = data.channels;
 
+          /**
+           * The cost of the partitioned convolution grows linearly with the kernel
+           * length, so the removed fraction of the response is a fair estimate of
+           * the saved work.
+           */
+
+          kernelTrimSavings = data.untrimmed_duration > 0.0
+                                  ? std::clamp(1.0 - (data.duration() / data.untrimmed_duration), 0.0, 1.0)
+                                  : 0.0;
+
           Q_EMIT kernelIsSofaChanged();
           Q_EMIT kernelRateChanged();
           Q_EMIT kernelDurationChanged();
           Q_EMIT kernelSamplesChanged();
           Q_EMIT kernelChannelsChanged();
+          Q_EMIT kernelTrimSavingsChanged();
           Q_EMIT newKernelLoaded(data.name, true);
 
           if (data.is_sofa) {
@@ -149,7 +171,7 @@ Convolver::Convolver(const std::string& tag, pw::Manager* pipe_manager, Pipeline
           if (init_zita) {
             std::scoped_lock<std::mutex> lock(data_mutex);
 
-            auto success = zita.init(data, blocksize, settings->irWidth(), settings->autogain());
+            auto success = zita.init(kernel, blocksize, settings->irWidth(), settings->autogain());
 
             if (!success) {
               util::warning(std::format("{} Zita init failed", log_tag));
@@ -221,6 +243,10 @@ Convolver::Convolver(const std::string& tag, pw::Manager* pipe_manager, Pipeline
 }
 
 Convolver::~Convolver() {
+  WorkerPool::self().release(worker);
+
+  worker = nullptr;
+
   stop_worker();
 
   std::scoped_lock<std::mutex> lock(data_mutex);
@@ -247,6 +273,43 @@ void Convolver::clear_data() {
   setup();
 }
 
+void Convolver::park_engine(const bool& state) {
+  if (!state) {
+    setup();
+
+    return;
+  }
+
+  {
+    std::scoped_lock<std::mutex> lock(data_mutex);
+
+    ready = false;
+  }
+
+  // Stopping zita ends its partition threads. setup() initializes it again with the cached kernel when unparked.
+
+  // NOLINTBEGIN(clang-analyzer-cplusplus.NewDeleteLeaks)
+
+  QMetaObject::invokeMethod(
+      worker,
+      [this] {
+        if (destructor_called) {
+          return;
+        }
+
+        {
+          std::scoped_lock<std::mutex> lock(data_mutex);
+
+          ready = false;
+        }
+
+        zita.stop();
+      },
+      Qt::QueuedConnection);
+
+  // NOLINTEND(clang-analyzer-cplusplus.NewDeleteLeaks)
+}
+
 void Convolver::setup() {
   if (rate == 0 || n_samples == 0) {
     // Some signals may be emitted before PipeWire calls our setup function
@@ -416,20 +479,21 @@ void Convolver::load_kernel_file(const bool& init_zita, const uint& server_sampl
 
   const auto name = settings->kernelName();
 
-  auto kernel_data = kernel_manager.loadKernel(name.toStdString());
+  const auto file_path = kernel_manager.searchKernelPath(name.toStdString());
+
+  // Instances using the same file with the same settings share the decoded kernel.
 
-  if (!kernel_data.isValid()) {
+  const auto kernel = ConvolverKernelStore::self().get_decoded(
+      ConvolverKernelStore::make_key(file_path, ConvolverKernelManager::options_from(settings), server_sampling_rate),
+      [&]() { return kernel_manager.loadKernel(name.toStdString(), server_sampling_rate); });
+
+  if (!kernel->isValid()) {
     Q_EMIT worker->onInvalidKernel(name);
 
     return;
   }
 
-  if (server_sampling_rate != 0 && kernel_data.rate != server_sampling_rate) {
-    util::debug(std::format("{}{} kernel has {} rate. Resampling it to {}", log_tag, name.toStdString(),
-                            kernel_data.rate, server_sampling_rate));
-
-    kernel_data = ConvolverKernelManager::resampleKernel(kernel_data, server_sampling_rate);
-  }
+  const auto& kernel_data = *kernel;
 
   const auto dt = 1.0 / kernel_data.rate;
 
@@ -471,13 +535,17 @@ void Convolver::load_kernel_file(const bool& init_zita, const uint& server_sampl
 
   Q_EMIT worker->onNewSpectrum(kernel_fft.linear_L, kernel_fft.linear_R, kernel_fft.log_L, kernel_fft.log_R);
 
-  Q_EMIT worker->onNewKernel(kernel_data, init_zita);
+  Q_EMIT worker->onNewKernel(kernel, init_zita);
 }
 
 auto Convolver::get_latency_seconds() -> float {
   return this->latency_value;
 }
 
+auto Convolver::is_primed() -> bool {
+  return rate != 0U && ready;
+}
+
 void Convolver::combine_kernels(const std::string& kernel_1_name,
                                 const std::string& kernel_2_name,
                                 const std::string& output_file_name) {
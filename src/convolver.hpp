@@ -27,23 +27,24 @@
 #include <sys/types.h>
 #include <zita-convolver.h>
 #include <QString>
-#include <QThread>
 #include <span>
 #include <string>
 #include <vector>
 #include "convolver_kernel_fft.hpp"
 #include "convolver_kernel_manager.hpp"
+#include "convolver_kernel_store.hpp"
 #include "convolver_zita.hpp"
 #include "easyeffects_db_convolver.h"
 #include "pipeline_type.hpp"
 #include "plugin_base.hpp"
 #include "pw_manager.hpp"
+#include "worker_pool.hpp"
 
-class ConvolverWorker : public QObject {
+class ConvolverWorker : public PoolWorker {
   Q_OBJECT
 
  Q_SIGNALS:
-  void onNewKernel(ConvolverKernelManager::KernelData data, bool init_zita);
+  void onNewKernel(ConvolverKernelStore::Kernel data, bool init_zita);
 
   void onNewChartMag(QList<QPointF> mag_L, QList<QPointF> mag_R);
 
@@ -64,6 +65,7 @@ class Convolver : public PluginBase {
   Q_PROPERTY(QString kernelRate MEMBER kernelRate NOTIFY kernelRateChanged)
   Q_PROPERTY(QString kernelSamples MEMBER kernelSamples NOTIFY kernelSamplesChanged)
   Q_PROPERTY(QString kernelDuration MEMBER kernelDuration NOTIFY kernelDurationChanged)
+  Q_PROPERTY(double kernelTrimSavings MEMBER kernelTrimSavings NOTIFY kernelTrimSavingsChanged)
 
   Q_PROPERTY(QString sofaDatabase MEMBER sofaDatabase NOTIFY sofaDatabaseChanged)
   Q_PROPERTY(float sofaMeasurements MEMBER sofaMeasurements NOTIFY sofaMeasurementsChanged)
@@ -116,6 +118,8 @@ class Convolver : public PluginBase {
 
   auto get_latency_seconds() -> float override;
 
+  auto is_primed() -> bool override;
+
   Q_INVOKABLE void combineKernels(const QString& kernel1, const QString& kernel2, const QString& outputName);
 
   Q_INVOKABLE void applySofaOrientation();
@@ -128,6 +132,7 @@ class Convolver : public PluginBase {
   void kernelRateChanged();
   void kernelSamplesChanged();
   void kernelDurationChanged();
+  void kernelTrimSavingsChanged();
   void kernelChannelsChanged();
 
   void sofaDatabaseChanged();
@@ -155,6 +160,9 @@ class Convolver : public PluginBase {
 
   void kernelCombinationStopped();
 
+ protected:
+  void park_engine(const bool& state) override;
+
  private:
   DbConvolver* settings = nullptr;
 
@@ -190,6 +198,8 @@ class Convolver : public PluginBase {
   QString kernelSamples;
   QString kernelDuration;
 
+  double kernelTrimSavings = 0.0;  // Estimated fraction of convolution work saved by trimming.
+
   std::vector<float> data_L, data_R;
   std::vector<float> buf_in_L, buf_in_R;
   std::vector<float> buf_out_L, buf_out_R;
@@ -31,6 +31,7 @@
 #include <filesystem>
 #include <format>
 #include <memory>
+#include <numbers>
 #include <numeric>
 #include <sndfile.hh>
 #include <string>
@@ -44,7 +45,12 @@
 #include "util.hpp"
 
 ConvolverKernelManager::ConvolverKernelManager(DbConvolver* settings, const PipelineType& pipeline_type)
-    : settings(settings),
+    : ConvolverKernelManager(Options{}, pipeline_type) {
+  this->settings = settings;
+}
+
+ConvolverKernelManager::ConvolverKernelManager(const Options& options, const PipelineType& pipeline_type)
+    : fixed_options(options),
       pipeline_type(pipeline_type),
       app_data_dir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation).toStdString()),
       local_dir_irs(app_data_dir + "/irs") {
@@ -64,6 +70,19 @@ ConvolverKernelManager::ConvolverKernelManager(DbConvolver* settings, const Pipe
   }
 }
 
+auto ConvolverKernelManager::options_from(DbConvolver* settings) -> Options {
+  return {.trim_tail = settings->trimTail(),
+          .trim_threshold = settings->trimThreshold(),
+          .max_duration = settings->maxKernelDuration(),
+          .sofa_azimuth = settings->targetSofaAzimuth(),
+          .sofa_elevation = settings->targetSofaElevation(),
+          .sofa_radius = settings->targetSofaRadius()};
+}
+
+auto ConvolverKernelManager::options() const -> Options {
+  return (settings != nullptr) ? options_from(settings) : fixed_options;
+}
+
 auto ConvolverKernelManager::KernelData::isValid() const -> bool {
   return rate > 0 && !channel_L.empty() && !channel_R.empty() && channel_L.size() == channel_R.size();
 }
@@ -118,6 +137,24 @@ auto ConvolverKernelManager::loadKernel(const std::string& name) -> KernelData {
   return kernel_data;
 }
 
+auto ConvolverKernelManager::loadKernel(const std::string& name, const uint& rate) -> KernelData {
+  auto kernel_data = loadKernel(name);
+
+  if (!kernel_data.isValid()) {
+    return kernel_data;
+  }
+
+  trimKernel(kernel_data);
+
+  if (rate != 0 && kernel_data.rate != rate) {
+    util::debug(std::format("{} kernel has {} rate. Resampling it to {}", name, kernel_data.rate, rate));
+
+    kernel_data = resampleKernel(kernel_data, rate);
+  }
+
+  return kernel_data;
+}
+
 auto ConvolverKernelManager::combineKernels(const std::string& kernel1_name,
                                             const std::string& kernel2_name,
                                             const std::string& output_name) -> bool {
@@ -304,6 +341,101 @@ void ConvolverKernelManager::normalizeKernel(KernelData& kernel) {
   }
 }
 
+auto ConvolverKernelManager::trimKernel(KernelData& kernel) -> bool {
+  if (!kernel.isValid()) {
+    return false;
+  }
+
+  kernel.untrimmed_duration = kernel.duration();
+
+  const auto n_samples = kernel.sampleCount();
+
+  const auto energy_at = [&](const size_t& n) {
+    auto e = (static_cast<double>(kernel.channel_L[n]) * kernel.channel_L[n]) +
+             (static_cast<double>(kernel.channel_R[n]) * kernel.channel_R[n]);
+
+    if (kernel.channels == 4) {
+      e += (static_cast<double>(kernel.channel_LR[n]) * kernel.channel_LR[n]) +
+           (static_cast<double>(kernel.channel_RL[n]) * kernel.channel_RL[n]);
+    }
+
+    return e;
+  };
+
+  const auto opts = options();
+
+  auto length = n_samples;
+
+  if (opts.trim_tail) {
+    /**
+     * Schroeder backward integration of the energy summed over all channels.
+     * The tail is cut where the energy that remains after it falls below the
+     * threshold relative to the total energy of the response.
+     */
+
+    double total = 0.0;
+
+    for (size_t n = 0U; n < n_samples; n++) {
+      total += energy_at(n);
+    }
+
+    if (total > 0.0) {
+      const auto limit = total * std::pow(10.0, opts.trim_threshold / 10.0);
+
+      double tail = 0.0;
+
+      while (length > 1U) {
+        const auto e = energy_at(length - 1U);
+
+        if (tail + e > limit) {
+          break;
+        }
+
+        tail += e;
+
+        length--;
+      }
+    }
+  }
+
+  if (opts.max_duration > 0.0) {
+    const auto max_length = std::max<size_t>(1U, static_cast<size_t>(opts.max_duration * 0.001 * kernel.rate));
+
+    length = std::min(length, max_length);
+  }
+
+  if (length >= n_samples) {
+    return false;
+  }
+
+  // A short raised cosine fade avoids the click a hard cut of the tail would add.
+
+  const auto fade_length = std::min(static_cast<size_t>(0.005 * kernel.rate), length / 2U);
+
+  const auto fade_and_resize = [&](std::vector<float>& channel) {
+    channel.resize(length);
+
+    for (size_t n = 0U; n < fade_length; n++) {
+      const auto w = 0.5 * (1.0 + std::cos(std::numbers::pi * static_cast<double>(n + 1U) /
+                                           static_cast<double>(fade_length + 1U)));
+
+      channel[length - fade_length + n] *= static_cast<float>(w);
+    }
+  };
+
+  fade_and_resize(kernel.channel_L);
+  fade_and_resize(kernel.channel_R);
+
+  if (kernel.channels == 4) {
+    fade_and_resize(kernel.channel_LR);
+    fade_and_resize(kernel.channel_RL);
+  }
+
+  util::debug(std::format("Trimmed kernel '{}' from {} to {} samples", kernel.name.toStdString(), n_samples, length));
+
+  return true;
+}
+
 auto ConvolverKernelManager::saveKernel(const KernelData& kernel, const std::string& file_name) -> bool {
   if (!kernel.isValid() || file_name.empty()) {
     return false;
@@ -612,9 +744,10 @@ auto ConvolverKernelManager::readSofaKernelFile(const std::string& file_path) ->
       kernel_data.sofaMetadata.min_radius = lookup->radius_min;
       kernel_data.sofaMetadata.max_radius = lookup->radius_max;
 
-      float coords[3] = {static_cast<float>(settings->targetSofaAzimuth()),
-                         static_cast<float>(settings->targetSofaElevation()),
-                         static_cast<float>(settings->targetSofaRadius())};
+      const auto opts = options();
+
+      float coords[3] = {static_cast<float>(opts.sofa_azimuth), static_cast<float>(opts.sofa_elevation),
+                         static_cast<float>(opts.sofa_radius)};
 
       mysofa_s2c(coords);
 
@@ -624,7 +757,7 @@ auto ConvolverKernelManager::readSofaKernelFile(const std::string& file_path) ->
 
       util::debug(std::format(
           "For the desired azimuth = {}, elevation = {} and radius = {} the nearest SOFA measurement index is {}",
-          settings->targetSofaAzimuth(), settings->targetSofaElevation(), settings->targetSofaRadius(), m));
+          opts.sofa_azimuth, opts.sofa_elevation, opts.sofa_radius, m));
 
       mysofa_lookup_free(lookup);
 
@@ -40,6 +40,8 @@ class ConvolverKernelManager {
     uint original_rate = 0;
     uint channels = 0;
 
+    double untrimmed_duration = 0.0;
+
     QString name;
     QString file_path;
 
@@ -74,10 +76,29 @@ class ConvolverKernelManager {
     [[nodiscard]] auto sampleCount() const -> size_t;
   };
 
+  // Settings that change the decoded kernel.
+  struct Options {
+    bool trim_tail = false;
+
+    double trim_threshold = 0.0;
+
+    double max_duration = 0.0;  // milliseconds
+
+    double sofa_azimuth = 0.0, sofa_elevation = 0.0, sofa_radius = 0.0;
+  };
+
   ConvolverKernelManager(DbConvolver* settings, const PipelineType& pipeline_type);
 
+  // Used when there is no settings instance to read from, as when prewarming the kernels of a preset.
+  ConvolverKernelManager(const Options& options, const PipelineType& pipeline_type);
+
+  static auto options_from(DbConvolver* settings) -> Options;
+
   auto loadKernel(const std::string& name) -> KernelData;
 
+  // Loads the kernel, trims it and resamples it to rate. This is the decoded kernel kept by ConvolverKernelStore.
+  auto loadKernel(const std::string& name, const uint& rate) -> KernelData;
+
   auto combineKernels(const std::string& kernel1_name, const std::string& kernel2_name, const std::string& output_name)
       -> bool;
 
@@ -87,6 +108,8 @@ class ConvolverKernelManager {
 
   static void normalizeKernel(KernelData& kernel);
 
+  auto trimKernel(KernelData& kernel) -> bool;
+
   auto saveKernel(const KernelData& kernel, const std::string& file_name) -> bool;
 
   auto readSofaKernelFile(const std::string& file_path) -> KernelData;
@@ -94,6 +117,8 @@ class ConvolverKernelManager {
  private:
   DbConvolver* settings = nullptr;
 
+  Options fixed_options;
+
   PipelineType pipeline_type;
 
   std::string app_data_dir;
@@ -101,6 +126,8 @@ class ConvolverKernelManager {
 
   std::vector<std::string> system_data_dir_irs;
 
+  [[nodiscard]] auto options() const -> Options;
+
   static auto readKernelFile(const std::string& file_path) -> KernelData;
 
   static auto validateKernel(const KernelData& kernel) -> bool;
@@ -0,0 +1,251 @@
+/**
+ * Copyright © 2017-2026 Wellington Wallace
+ *
+ * This file is part of Easy Effects.
+ *
+ * Easy Effects is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Easy Effects is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "convolver_kernel_store.hpp"
+#include <qtypes.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <tuple>
+#include <utility>
+#include "convolver_kernel_manager.hpp"
+#include "util.hpp"
+
+namespace {
+
+// Keeps the decoded kernel alive for as long as a kernel shaped from it is in use.
+struct ShapedKernel {
+  ConvolverKernelStore::Kernel decoded;
+
+  ConvolverKernelManager::KernelData data;
+};
+
+}  // namespace
+
+auto ConvolverKernelStore::make_key(const std::string& file_path,
+                                   const ConvolverKernelManager::Options& options,
+                                   const uint& rate) -> Key {
+  Key key;
+
+  key.file_path = file_path;
+
+  std::error_code ec;
+
+  const auto time = std::filesystem::last_write_time(file_path, ec);
+
+  if (!ec) {
+    key.modification_time =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+  }
+
+  key.rate = rate;
+
+  key.trim_tail = options.trim_tail;
+  key.trim_threshold = options.trim_threshold;
+  key.max_duration = options.max_duration;
+
+  key.sofa_azimuth = options.sofa_azimuth;
+  key.sofa_elevation = options.sofa_elevation;
+  key.sofa_radius = options.sofa_radius;
+
+  return key;
+}
+
+auto ConvolverKernelStore::get_decoded(const Key& key, const std::function<ConvolverKernelManager::KernelData()>& load)
+    -> Kernel {
+  {
+    std::scoped_lock<std::mutex> lock(mutex);
+
+    if (auto it = decoded_kernels.find(key); it != decoded_kernels.end()) {
+      if (auto kernel = it->second.lock()) {
+        util::debug(std::format("sharing the kernel {} at {} Hz", key.file_path, key.rate));
+
+        return kernel;
+      }
+    }
+  }
+
+  // Loading can take a while. It is done without the lock so other instances are not held back.
+
+  auto kernel = std::make_shared<const ConvolverKernelManager::KernelData>(load());
+
+  if (!kernel->isValid()) {
+    return kernel;
+  }
+
+  std::scoped_lock<std::mutex> lock(mutex);
+
+  remove_expired();
+
+  auto& entry = decoded_kernels[key];
+
+  // Another instance may have loaded the same kernel in the meantime. Its copy wins so only one stays in memory.
+
+  if (auto existing = entry.lock()) {
+    return existing;
+  }
+
+  entry = kernel;
+
+  return kernel;
+}
+
+auto ConvolverKernelStore::get_shaped(const Kernel& decoded, const int& ir_width, const bool& autogain) -> Kernel {
+  if (decoded == nullptr || !decoded->isValid()) {
+    return decoded;
+  }
+
+  // With the default width and no autogain the decoded kernel is used as it is.
+
+  if (ir_width == 100 && !autogain) {
+    return decoded;
+  }
+
+  const auto key = std::make_tuple(decoded.get(), ir_width, autogain);
+
+  {
+    std::scoped_lock<std::mutex> lock(mutex);
+
+    if (auto it = shaped_kernels.find(key); it != shaped_kernels.end()) {
+      if (auto kernel = it->second.lock()) {
+        return kernel;
+      }
+    }
+  }
+
+  auto shaped = std::make_shared<ShapedKernel>(decoded, *decoded);
+
+  apply_stereo_width(shaped->data, ir_width);
+
+  if (autogain) {
+    apply_autogain(shaped->data);
+  }
+
+  Kernel kernel(shaped, &shaped->data);
+
+  std::scoped_lock<std::mutex> lock(mutex);
+
+  remove_expired();
+
+  auto& entry = shaped_kernels[key];
+
+  if (auto existing = entry.lock()) {
+    return existing;
+  }
+
+  entry = kernel;
+
+  return kernel;
+}
+
+void ConvolverKernelStore::remove_expired() {
+  std::erase_if(decoded_kernels, [](const auto& entry) { return entry.second.expired(); });
+  std::erase_if(shaped_kernels, [](const auto& entry) { return entry.second.expired(); });
+}
+
+/**
+ * Mid-Side based Stereo width effect
+ * taken from https://github.com/tomszilagyi/ir.lv2/blob/automatable/ir.cc
+ */
+void ConvolverKernelStore::apply_stereo_width(ConvolverKernelManager::KernelData& kernel, const int& ir_width) {
+  if (!kernel.isValid()) {
+    return;
+  }
+
+  const float w = static_cast<float>(ir_width) * 0.01F;
+  const float x = (1.0F - w) / (1.0F + w);  // M-S coeff.; L_out = L + x*R; R_out = R + x*L
+
+  for (uint i = 0; i < kernel.sampleCount(); i++) {
+    const float LL = kernel.channel_L[i];
+    const float RR = kernel.channel_R[i];
+
+    float LR = 0.0F;
+    float RL = 0.0F;
+
+    if (kernel.channels == 4) {
+      LR = kernel.channel_LR[i];
+      RL = kernel.channel_RL[i];
+    }
+
+    // Apply width to direct paths
+    float new_LL = LL + (x * RR);
+    float new_RR = RR + (x * LL);
+
+    // Apply complementary width to cross paths
+    float new_LR = LR - (x * RL);
+    float new_RL = RL - (x * LR);
+
+    kernel.channel_L[i] = new_LL;
+    kernel.channel_R[i] = new_RR;
+
+    if (kernel.channels == 4) {
+      kernel.channel_LR[i] = new_LR;
+      kernel.channel_RL[i] = new_RL;
+    }
+  }
+}
+
+void ConvolverKernelStore::apply_autogain(ConvolverKernelManager::KernelData& kernel) {
+  if (!kernel.isValid()) {
+    return;
+  }
+
+  ConvolverKernelManager::normalizeKernel(kernel);
+
+  // find average power
+
+  float power_LL = 0.0F;
+  float power_RR = 0.0F;
+  float power_LR = 0.0F;
+  float power_RL = 0.0F;
+
+  for (uint i = 0; i < kernel.sampleCount(); i++) {
+    power_LL += kernel.channel_L[i] * kernel.channel_L[i];
+    power_RR += kernel.channel_R[i] * kernel.channel_R[i];
+
+    if (kernel.channels == 4) {
+      power_LR += kernel.channel_LR[i] * kernel.channel_LR[i];
+      power_RL += kernel.channel_RL[i] * kernel.channel_RL[i];
+    }
+  }
+
+  const float power = std::max({power_LL, power_RR, power_LR, power_RL});
+
+  const float autogain = std::min(1.0F, 1.0F / std::sqrt(power));
+
+  util::debug(std::format("autogain factor: {}", autogain));
+
+  for (uint i = 0; i < kernel.sampleCount(); i++) {
+    kernel.channel_L[i] *= autogain;
+    kernel.channel_R[i] *= autogain;
+
+    if (kernel.channels == 4) {
+      kernel.channel_LR[i] *= autogain;
+      kernel.channel_RL[i] *= autogain;
+    }
+  }
+}
@@ -0,0 +1,106 @@
+/**
+ * Copyright © 2017-2026 Wellington Wallace
+ *
+ * This file is part of Easy Effects.
+ *
+ * Easy Effects is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Easy Effects is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <qtypes.h>
+#include <compare>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include "convolver_kernel_manager.hpp"
+
+/**
+ * Process wide store of convolver kernels. Convolver instances that use the same impulse response share one copy of
+ * it instead of each one decoding, resampling and shaping its own. This matters for long responses used on both
+ * pipelines or by several instances at once.
+ *
+ * Kernels are handed out as shared pointers to immutable data. The store only keeps weak references, so a kernel is
+ * freed when the last instance using it lets it go.
+ */
+class ConvolverKernelStore {
+ public:
+  ConvolverKernelStore() = default;
+  ConvolverKernelStore(const ConvolverKernelStore&) = delete;
+  auto operator=(const ConvolverKernelStore&) -> ConvolverKernelStore& = delete;
+  ConvolverKernelStore(const ConvolverKernelStore&&) = delete;
+  auto operator=(const ConvolverKernelStore&&) -> ConvolverKernelStore& = delete;
+  ~ConvolverKernelStore() = default;
+
+  static ConvolverKernelStore& self() {
+    static ConvolverKernelStore store;
+    return store;
+  }
+
+  using Kernel = std::shared_ptr<const ConvolverKernelManager::KernelData>;
+
+  // Everything that changes the decoded kernel. The modification time makes a rewritten file load again.
+  struct Key {
+    std::string file_path;
+
+    int64_t modification_time = 0;
+
+    uint rate = 0U;
+
+    bool trim_tail = false;
+
+    double trim_threshold = 0.0;
+
+    double max_duration = 0.0;
+
+    double sofa_azimuth = 0.0, sofa_elevation = 0.0, sofa_radius = 0.0;
+
+    auto operator<=>(const Key&) const = default;
+  };
+
+  /**
+   * Returns the decoded kernel of the key, calling load to create it when no instance holds it. Invalid kernels are
+   * returned but not stored.
+   */
+  auto get_decoded(const Key& key, const std::function<ConvolverKernelManager::KernelData()>& load) -> Kernel;
+
+  // The decoded kernel with the stereo width and the autogain applied. This is what zita is fed with.
+  auto get_shaped(const Kernel& decoded, const int& ir_width, const bool& autogain) -> Kernel;
+
+  static auto make_key(const std::string& file_path, const ConvolverKernelManager::Options& options, const uint& rate)
+      -> Key;
+
+ private:
+  std::mutex mutex;
+
+  std::map<Key, std::weak_ptr<const ConvolverKernelManager::KernelData>> decoded_kernels;
+
+  /**
+   * Keyed by the address of the decoded kernel. A shaped kernel keeps its decoded one alive, so the address can not
+   * be reused while the entry is valid.
+   */
+  std::map<std::tuple<const ConvolverKernelManager::KernelData*, int, bool>,
+           std::weak_ptr<const ConvolverKernelManager::KernelData>>
+      shaped_kernels;
+
+  void remove_expired();
+
+  static void apply_stereo_width(ConvolverKernelManager::KernelData& kernel, const int& ir_width);
+
+  static void apply_autogain(ConvolverKernelManager::KernelData& kernel);
+};
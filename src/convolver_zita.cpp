@@ -23,12 +23,13 @@
 #include <zita-convolver.h>
 #include <algorithm>
 #include <chrono>
-#include <cmath>
 #include <format>
 #include <mutex>
 #include <span>
 #include <thread>
-#include "convolver_kernel_manager.hpp"
+#include <utility>
+#include <vector>
+#include "convolver_kernel_store.hpp"
 #include "util.hpp"
 
 namespace {
@@ -62,7 +63,7 @@ void ConvolverZita::stop() {
   }
 }
 
-auto ConvolverZita::init(ConvolverKernelManager::KernelData data,
+auto ConvolverZita::init(ConvolverKernelStore::Kernel data,
                          uint bufferSize,
                          const int& ir_width,
                          const bool& apply_autogain) -> bool {
@@ -91,24 +92,31 @@ auto ConvolverZita::init(ConvolverKernelManager::KernelData data,
 
   conv->set_options(0);
 
-  kernel = data;
-  original_kernel = kernel;
+  decoded = std::move(data);
 
   this->bufferSize = bufferSize;
 
   update_ir_width_and_autogain(ir_width, apply_autogain, false);
 
+  if (kernel == nullptr || !kernel->isValid()) {
+    util::warning("Zita: the kernel is not valid");
+
+    delete conv;
+    conv = nullptr;
+
+    return false;
+  }
+
   float density = 0.5F;
 
-  if (auto ret = conv->configure(2, 2, kernel.sampleCount(), bufferSize, bufferSize, Convproc::MAXPART, density);
+  if (auto ret = conv->configure(2, 2, kernel->sampleCount(), bufferSize, bufferSize, Convproc::MAXPART, density);
       ret != 0) {
     util::warning(std::format("Zita: configure failed: {}", ret));
 
     return false;
   }
 
-  if (auto ret = conv->impdata_create(0, 0, 1, kernel.channel_L.data(), 0, static_cast<int>(kernel.sampleCount()));
-      ret != 0) {
+  if (auto ret = set_impdata(0, 0, kernel->channel_L, false); ret != 0) {
     util::warning(std::format("Zita: left impdata_create failed: {}", ret));
 
     delete conv;
@@ -117,8 +125,7 @@ auto ConvolverZita::init(ConvolverKernelManager::KernelData data,
     return false;
   }
 
-  if (auto ret = conv->impdata_create(1, 1, 1, kernel.channel_R.data(), 0, static_cast<int>(kernel.sampleCount()));
-      ret != 0) {
+  if (auto ret = set_impdata(1, 1, kernel->channel_R, false); ret != 0) {
     util::warning(std::format("Zita: right impdata_create failed: {}", ret));
 
     delete conv;
@@ -127,9 +134,8 @@ auto ConvolverZita::init(ConvolverKernelManager::KernelData data,
     return false;
   }
 
-  if (kernel.channels == 4) {
-    if (auto ret = conv->impdata_create(0, 1, 1, kernel.channel_LR.data(), 0, static_cast<int>(kernel.sampleCount()));
-        ret != 0) {
+  if (kernel->channels == 4) {
+    if (auto ret = set_impdata(0, 1, kernel->channel_LR, false); ret != 0) {
       util::warning(std::format("Zita: LR impdata_create failed: {}", ret));
 
       delete conv;
@@ -138,8 +144,7 @@ auto ConvolverZita::init(ConvolverKernelManager::KernelData data,
       return false;
     }
 
-    if (auto ret = conv->impdata_create(1, 0, 1, kernel.channel_RL.data(), 0, static_cast<int>(kernel.sampleCount()));
-        ret != 0) {
+    if (auto ret = set_impdata(1, 0, kernel->channel_RL, false); ret != 0) {
       util::warning(std::format("Zita: RL impdata_create failed: {}", ret));
 
       delete conv;
@@ -204,117 +209,38 @@ auto ConvolverZita::process(std::span<float> left, std::span<float> right) -> bo
   return true;
 }
 
-void ConvolverZita::reset_kernel_to_original() {
-  kernel = original_kernel;
-}
-
-void ConvolverZita::apply_kernel_autogain() {
-  if (!kernel.isValid()) {
-    return;
-  }
-
-  ConvolverKernelManager::normalizeKernel(kernel);
-
-  // find average power
-
-  float power_LL = 0.0F;
-  float power_RR = 0.0F;
-  float power_LR = 0.0F;
-  float power_RL = 0.0F;
-
-  for (uint i = 0; i < kernel.sampleCount(); i++) {
-    power_LL += kernel.channel_L[i] * kernel.channel_L[i];
-    power_RR += kernel.channel_R[i] * kernel.channel_R[i];
-
-    if (kernel.channels == 4) {
-      power_LR += kernel.channel_LR[i] * kernel.channel_LR[i];
-      power_RL += kernel.channel_RL[i] * kernel.channel_RL[i];
-    }
-  }
-
-  const float power = std::max({power_LL, power_RR, power_LR, power_RL});
-
-  const float autogain = std::min(1.0F, 1.0F / std::sqrt(power));
-
-  util::debug(std::format("autogain factor: {}", autogain));
-
-  for (uint i = 0; i < kernel.sampleCount(); i++) {
-    kernel.channel_L[i] *= autogain;
-    kernel.channel_R[i] *= autogain;
-
-    if (kernel.channels == 4) {
-      kernel.channel_LR[i] *= autogain;
-      kernel.channel_RL[i] *= autogain;
-    }
-  }
-}
-
-/**
- * Mid-Side based Stereo width effect
- * taken from https://github.com/tomszilagyi/ir.lv2/blob/automatable/ir.cc
- */
-void ConvolverZita::set_kernel_stereo_width(const int& ir_width) {
-  if (!kernel.isValid()) {
-    return;
-  }
-
-  const float w = static_cast<float>(ir_width) * 0.01F;
-  const float x = (1.0F - w) / (1.0F + w);  // M-S coeff.; L_out = L + x*R; R_out = R + x*L
-
-  for (uint i = 0; i < kernel.sampleCount(); i++) {
-    const float LL = kernel.channel_L[i];
-    const float RR = kernel.channel_R[i];
-
-    float LR = 0.0F;
-    float RL = 0.0F;
-
-    if (kernel.channels == 4) {
-      LR = kernel.channel_LR[i];
-      RL = kernel.channel_RL[i];
-    }
-
-    // Apply width to direct paths
-    float new_LL = LL + (x * RR);
-    float new_RR = RR + (x * LL);
-
-    // Apply complementary width to cross paths
-    float new_LR = LR - (x * RL);
-    float new_RL = RL - (x * LR);
-
-    kernel.channel_L[i] = new_LL;
-    kernel.channel_R[i] = new_RR;
-
-    if (kernel.channels == 4) {
-      kernel.channel_LR[i] = new_LR;
-      kernel.channel_RL[i] = new_RL;
-    }
-  }
-}
-
 void ConvolverZita::update_ir_width_and_autogain(const int& ir_width,
                                                  const bool& apply_autogain,
                                                  const bool& clear_zita) {
-  reset_kernel_to_original();
-
-  set_kernel_stereo_width(ir_width);
-
-  if (apply_autogain) {
-    apply_kernel_autogain();
-  }
+  kernel = ConvolverKernelStore::self().get_shaped(decoded, ir_width, apply_autogain);
 
-  if (clear_zita && conv) {
+  if (clear_zita && conv && kernel) {
     conv->impdata_clear(0, 0);
     conv->impdata_clear(1, 1);
 
-    conv->impdata_update(0, 0, 1, kernel.channel_L.data(), 0, static_cast<int>(kernel.sampleCount()));
-    conv->impdata_update(1, 1, 1, kernel.channel_R.data(), 0, static_cast<int>(kernel.sampleCount()));
+    set_impdata(0, 0, kernel->channel_L, true);
+    set_impdata(1, 1, kernel->channel_R, true);
 
-    if (kernel.channels == 4) {
+    if (kernel->channels == 4) {
       conv->impdata_clear(0, 1);
       conv->impdata_clear(1, 0);
 
-      conv->impdata_update(0, 1, 1, kernel.channel_LR.data(), 0, static_cast<int>(kernel.sampleCount()));
-      conv->impdata_update(1, 0, 1, kernel.channel_RL.data(), 0, static_cast<int>(kernel.sampleCount()));
+      set_impdata(0, 1, kernel->channel_LR, true);
+      set_impdata(1, 0, kernel->channel_RL, true);
     }
   }
 }
+
+/**
+ * Zita copies the response into its own partitions and never writes to the
+ * buffer it is given, so the const_cast is safe. It only exists because its
+ * api takes a float*.
+ */
+auto ConvolverZita::set_impdata(const uint& in, const uint& out, const std::vector<float>& channel, const bool& update)
+    -> int {
+  auto* data = const_cast<float*>(channel.data());  // NOLINT(cppcoreguidelines-pro-type-const-cast)
+
+  const auto size = static_cast<int>(channel.size());
+
+  return update ? conv->impdata_update(in, out, 1, data, 0, size) : conv->impdata_create(in, out, 1, data, 0, size);
+}
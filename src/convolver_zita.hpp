@@ -22,7 +22,8 @@
 #include <qtypes.h>
 #include <zita-convolver.h>
 #include <span>
-#include "convolver_kernel_manager.hpp"
+#include <vector>
+#include "convolver_kernel_store.hpp"
 
 class ConvolverZita {
  public:
@@ -36,15 +37,13 @@ class ConvolverZita {
   ConvolverZita(ConvolverZita&&) noexcept = default;
   auto operator=(ConvolverZita&&) noexcept -> ConvolverZita& = default;
 
-  auto init(ConvolverKernelManager::KernelData data, uint bufferSize, const int& ir_width, const bool& apply_autogain)
+  auto init(ConvolverKernelStore::Kernel data, uint bufferSize, const int& ir_width, const bool& apply_autogain)
       -> bool;
 
   auto process(std::span<float> dataLeft, std::span<float> dataRight) -> bool;
 
   void stop();
 
-  void reset_kernel_to_original();
-
   void update_ir_width_and_autogain(const int& ir_width, const bool& apply_autogain, const bool& clear_zita);
 
  private:
@@ -52,11 +51,10 @@ class ConvolverZita {
 
   uint bufferSize = 0;
 
-  ConvolverKernelManager::KernelData kernel, original_kernel;
+  // Both come from the kernel store and may be shared with other instances. They must not be modified.
+  ConvolverKernelStore::Kernel decoded, kernel;
 
   Convproc* conv = nullptr;
 
-  void apply_kernel_autogain();
-
-  void set_kernel_stereo_width(const int& ir_width);
+  auto set_impdata(const uint& in, const uint& out, const std::vector<float>& channel, const bool& update) -> int;
 };
@@ -22,6 +22,7 @@
 #include <qnamespace.h>
 #include <qobjectdefs.h>
 #include <algorithm>
+#include <cmath>
 #include <format>
 #include <memory>
 #include <mutex>
@@ -58,17 +59,47 @@ Crusher::Crusher(const std::string& tag, pw::Manager* pipe_manager, PipelineType
 
   init_common_controls<DbCrusher>(settings);
 
+  enable_oversampling();
+
   // specific plugin controls
 
   BIND_LV2_PORT("mode", mode, setMode, DbCrusher::modeChanged);
   BIND_LV2_PORT("bits", bitReduction, setBitReduction, DbCrusher::bitReductionChanged);
   BIND_LV2_PORT("morph", morph, setMorph, DbCrusher::morphChanged);
   BIND_LV2_PORT("anti_aliasing", antiAliasing, setAntiAliasing, DbCrusher::antiAliasingChanged);
-  BIND_LV2_PORT("samples", sampleReduction, setSampleReduction, DbCrusher::sampleReductionChanged);
   BIND_LV2_PORT("lfo", lfoActive, setLfoActive, DbCrusher::lfoActiveChanged);
   BIND_LV2_PORT("lforange", lfoRange, setLfoRange, DbCrusher::lfoRangeChanged);
   BIND_LV2_PORT("lforate", lfoRate, setLfoRate, DbCrusher::lfoRateChanged);
   BIND_LV2_PORT_DB("dc", dc, setDc, DbCrusher::dcChanged, false);
+
+  /**
+   * The sample reduction counts frames at the rate of the instance. With
+   * oversampling it runs at twice the graph rate, so the value is scaled to
+   * keep the same reduced rate. setup() applies it again when the factor
+   * changes. Values the port cannot take are clamped there and the setting
+   * is left alone, so it is only written back when the native UI moves the
+   * port away from what we sent.
+   */
+
+  lv2_wrapper->set_control_port_value("samples", sample_reduction_port_value());
+
+  lv2_wrapper->sync_funcs.emplace_back([&]() {
+    const auto value = lv2_wrapper->get_control_port_value("samples");
+
+    if (value == sample_reduction_port_value()) {
+      return;
+    }
+
+    settings->setSampleReduction(static_cast<int>(std::round(value / static_cast<float>(oversampling_factor()))));
+  });
+
+  connect(settings, &DbCrusher::sampleReductionChanged, [this]() {
+    if (settings == nullptr || lv2_wrapper == nullptr) {
+      return;
+    }
+
+    lv2_wrapper->set_control_port_value("samples", sample_reduction_port_value());
+  });
 }
 
 Crusher::~Crusher() {
@@ -83,6 +114,11 @@ Crusher::~Crusher() {
   util::debug(std::format("{}{} destroyed", log_tag, name.toStdString()));
 }
 
+auto Crusher::sample_reduction_port_value() const -> float {
+  return std::min(static_cast<float>(settings->sampleReduction() * static_cast<int>(oversampling_factor())),
+                  max_sample_reduction);
+}
+
 void Crusher::reset() {
   settings->setDefaults();
 }
@@ -115,13 +151,17 @@ void Crusher::setup() {
     return;
   }
 
-  lv2_wrapper->set_n_samples(n_samples);
+  setup_oversampling();
+
+  lv2_wrapper->set_n_samples(lv2_n_samples());
 
   // NOLINTBEGIN(clang-analyzer-cplusplus.NewDeleteLeaks)
   QMetaObject::invokeMethod(
       baseWorker,
       [this] {
-        lv2_wrapper->create_instance(rate);
+        lv2_wrapper->set_control_port_value("samples", sample_reduction_port_value());
+
+        lv2_wrapper->create_instance(lv2_rate());
 
         std::scoped_lock<std::mutex> lock(data_mutex);
 
@@ -153,8 +193,13 @@ void Crusher::process(std::span<float>& left_in,
     return;
   }
 
-  lv2_wrapper->connect_data_ports(left_in, right_in, left_out, right_out);
-  lv2_wrapper->run();
+  run_lv2(left_in, right_in, left_out, right_out);
+
+  if (latency_value != oversampling_latency()) {
+    latency_value = oversampling_latency();
+
+    update_filter_params();
+  }
 
   if (output_gain != 1.0F) {
     apply_gain(left_out, right_out, output_gain);
@@ -173,5 +218,5 @@ void Crusher::process([[maybe_unused]] std::span<float>& left_in,
                       [[maybe_unused]] std::span<float>& probe_right) {}
 
 auto Crusher::get_latency_seconds() -> float {
-  return 0.0F;
+  return latency_value;
 }
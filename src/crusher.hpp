@@ -66,4 +66,9 @@ class Crusher : public PluginBase {
   DbCrusher* settings = nullptr;
 
   bool ready = false;
+
+  // Upper bound of the samples port of Calf Crusher. Same as the maximum of the sampleReduction setting.
+  static constexpr float max_sample_reduction = 250.0F;
+
+  [[nodiscard]] auto sample_reduction_port_value() const -> float;
 };
@@ -38,7 +38,7 @@
 #include "pipeline_type.hpp"
 #include "plugin_base.hpp"
 #include "pw_manager.hpp"
-#include "resampler.hpp"
+#include "multichannel_resampler.hpp"
 #include "tags_plugin_name.hpp"
 #include "util.hpp"
 
@@ -116,20 +116,12 @@ Crystalizer::Crystalizer(const std::string& tag, pw::Manager* pipe_manager, Pipe
   connect(settings, &DbCrystalizer::oversamplingQualityChanged, [&]() {
     std::scoped_lock<std::mutex> lock(data_mutex);
 
-    if (resampler_inL) {
-      resampler_inL->set_quality(settings->oversamplingQuality());
+    if (upsampler) {
+      upsampler->set_quality(settings->oversamplingQuality());
     }
 
-    if (resampler_inR) {
-      resampler_inR->set_quality(settings->oversamplingQuality());
-    }
-
-    if (resampler_outL) {
-      resampler_outL->set_quality(settings->oversamplingQuality());
-    }
-
-    if (resampler_outR) {
-      resampler_outR->set_quality(settings->oversamplingQuality());
+    if (downsampler) {
+      downsampler->set_quality(settings->oversamplingQuality());
     }
   });
 }
@@ -158,6 +150,43 @@ void Crystalizer::clear_data() {
   setup();
 }
 
+void Crystalizer::park_engine(const bool& state) {
+  if (!state) {
+    setup();
+
+    return;
+  }
+
+  {
+    std::scoped_lock<std::mutex> lock(data_mutex);
+
+    filters_are_ready = false;
+  }
+
+  // The band filters are freed in the thread that created their fftw plans. setup() builds them again when unparked.
+
+  // NOLINTBEGIN(clang-analyzer-cplusplus.NewDeleteLeaks)
+
+  QMetaObject::invokeMethod(
+      baseWorker,
+      [this] {
+        {
+          std::scoped_lock<std::mutex> lock(data_mutex);
+
+          filters_are_ready = false;
+        }
+
+        std::scoped_lock<std::mutex> lock(util::fftw_lock());
+
+        for (auto& filter : filters) {
+          filter->free_zita();
+        }
+      },
+      Qt::QueuedConnection);
+
+  // NOLINTEND(clang-analyzer-cplusplus.NewDeleteLeaks)
+}
+
 void Crystalizer::setup() {
   if (rate == 0 || n_samples == 0) {
     // Some signals may be emitted before PipeWire calls our setup function
@@ -266,19 +295,13 @@ void Crystalizer::setup() {
           filters.at(n)->setup();
         }
 
-        resampler_inL = std::make_unique<Resampler>(rate, 2 * rate);
-        resampler_inR = std::make_unique<Resampler>(rate, 2 * rate);
-
-        resampler_outL = std::make_unique<Resampler>(2 * rate, rate);
-        resampler_outR = std::make_unique<Resampler>(2 * rate, rate);
-
-        resampler_inL->set_quality(settings->oversamplingQuality());
-
-        resampler_inR->set_quality(settings->oversamplingQuality());
+        const auto quality = static_cast<int>(settings->oversamplingQuality());
 
-        resampler_outL->set_quality(settings->oversamplingQuality());
+        upsampler = std::make_unique<MultichannelResampler>(2U, rate, 2U * rate, n_samples, quality);
+        downsampler = std::make_unique<MultichannelResampler>(2U, 2U * rate, rate, blocksize, quality);
 
-        resampler_outR->set_quality(settings->oversamplingQuality());
+        resampled_L.resize(std::max(upsampler->max_output_frames(), downsampler->max_output_frames()));
+        resampled_R.resize(resampled_L.size());
 
         std::scoped_lock<std::mutex> lock(data_mutex);
 
@@ -327,11 +350,10 @@ void Crystalizer::process(std::span<float>& left_in,
       buf_in_L.insert(buf_in_L.end(), left_in.begin(), left_in.end());
       buf_in_R.insert(buf_in_R.end(), right_in.begin(), right_in.end());
     } else {
-      const auto resampled_inL = resampler_inL->process(left_in);
-      const auto resampled_inR = resampler_inR->process(right_in);
+      const auto count = static_cast<long>(upsampler->process(left_in, right_in, resampled_L, resampled_R));
 
-      buf_in_L.insert(buf_in_L.end(), resampled_inL.begin(), resampled_inL.end());
-      buf_in_R.insert(buf_in_R.end(), resampled_inR.begin(), resampled_inR.end());
+      buf_in_L.insert(buf_in_L.end(), resampled_L.begin(), resampled_L.begin() + count);
+      buf_in_R.insert(buf_in_R.end(), resampled_R.begin(), resampled_R.begin() + count);
     }
 
     // util::warning(std::format("size 1: {}, size 2: {}, size 3: {}", buf_in_L.size(), left_in.size(), data_L.size()));
@@ -346,11 +368,10 @@ void Crystalizer::process(std::span<float>& left_in,
         buf_out_L.insert(buf_out_L.end(), data_L.begin(), data_L.end());
         buf_out_R.insert(buf_out_R.end(), data_R.begin(), data_R.end());
       } else {
-        auto resampled_outL = resampler_outL->process(data_L);
-        auto resampled_outR = resampler_outR->process(data_R);
+        const auto count = static_cast<long>(downsampler->process(data_L, data_R, resampled_L, resampled_R));
 
-        buf_out_L.insert(buf_out_L.end(), resampled_outL.begin(), resampled_outL.end());
-        buf_out_R.insert(buf_out_R.end(), resampled_outR.begin(), resampled_outR.end());
+        buf_out_L.insert(buf_out_L.end(), resampled_L.begin(), resampled_L.begin() + count);
+        buf_out_R.insert(buf_out_R.end(), resampled_R.begin(), resampled_R.begin() + count);
       }
     }
 
@@ -35,7 +35,7 @@
 #include "pipeline_type.hpp"
 #include "plugin_base.hpp"
 #include "pw_manager.hpp"
-#include "resampler.hpp"
+#include "multichannel_resampler.hpp"
 #include "util.hpp"
 
 class Crystalizer : public PluginBase {
@@ -77,6 +77,9 @@ class Crystalizer : public PluginBase {
 
   Q_INVOKABLE QList<float> getAdaptiveIntensities();
 
+ protected:
+  void park_engine(const bool& state) override;
+
  private:
   bool n_samples_is_power_of_2 = true;
   bool filters_are_ready = false;
@@ -148,8 +151,9 @@ class Crystalizer : public PluginBase {
   std::vector<float> buf_in_L, buf_in_R;
   std::vector<float> buf_out_L, buf_out_R;
 
-  std::unique_ptr<Resampler> resampler_inL, resampler_outL;
-  std::unique_ptr<Resampler> resampler_inR, resampler_outR;
+  std::vector<float> resampled_L, resampled_R;
+
+  std::unique_ptr<MultichannelResampler> upsampler, downsampler;
 
   QList<float> adaptive_intensities;
 
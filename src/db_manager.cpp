@@ -163,6 +163,17 @@ void Manager::resetAll() const {
   }
 }
 
+void Manager::create_plugin_dbs(PipelineType pipeline_type, const QStringList& plugins_list) {
+  switch (pipeline_type) {
+    case PipelineType::input:
+      create_plugin_db("sie", plugins_list, siePluginsDB);
+      break;
+    case PipelineType::output:
+      create_plugin_db("soe", plugins_list, soePluginsDB);
+      break;
+  }
+}
+
 void Manager::create_plugin_db(const QString& parentGroup,
                                const auto& plugins_list,
                                QMap<QString, QVariant>& plugins_map) {
@@ -20,6 +20,7 @@
 #pragma once
 
 #include <qassert.h>
+#include <qcontainerfwd.h>
 #include <qjsengine.h>
 #include <qmap.h>
 #include <qobject.h>
@@ -81,6 +82,11 @@ class Manager : public QObject {
 
   Q_INVOKABLE void enableAutosave(const bool& state);
 
+  /**
+   * Creates the settings of plugins that are not in the pipeline list yet.
+   */
+  void create_plugin_dbs(PipelineType pipeline_type, const QStringList& plugins_list);
+
   DbGraph* graph;
   DbMain* main;
   DbSpectrum* spectrum;
@@ -34,7 +34,7 @@
 #include "pipeline_type.hpp"
 #include "plugin_base.hpp"
 #include "pw_manager.hpp"
-#include "resampler.hpp"
+#include "multichannel_resampler.hpp"
 #include "tags_plugin_name.hpp"
 #include "util.hpp"
 
@@ -55,6 +55,10 @@ DeepFilterNet::DeepFilterNet(const std::string& tag,
 
   packageInstalled = ladspa_wrapper->found_plugin();
 
+  // Creating an instance loads the model, which can hold a shared pool thread for a long time.
+
+  use_dedicated_worker();
+
   if (!packageInstalled) {
     util::debug(std::format("{}libdeep_filter_ladspa is not installed", log_tag));
   }
@@ -110,6 +114,43 @@ void DeepFilterNet::clear_data() {
   setup();
 }
 
+void DeepFilterNet::park_engine(const bool& state) {
+  if (ladspa_wrapper == nullptr || !ladspa_wrapper->found_plugin()) {
+    return;
+  }
+
+  if (!state) {
+    setup();
+
+    return;
+  }
+
+  {
+    std::scoped_lock<std::mutex> lock(data_mutex);
+
+    ready = false;
+  }
+
+  // Destroying the LADSPA instance frees the model. It is destroyed in the thread that creates it.
+
+  // NOLINTBEGIN(clang-analyzer-cplusplus.NewDeleteLeaks)
+
+  QMetaObject::invokeMethod(
+      baseWorker,
+      [this] {
+        std::scoped_lock<std::mutex> lock(data_mutex);
+
+        ready = false;
+
+        if (ladspa_wrapper->has_instance()) {
+          ladspa_wrapper->destroy_instance();
+        }
+      },
+      Qt::QueuedConnection);
+
+  // NOLINTEND(clang-analyzer-cplusplus.NewDeleteLeaks)
+}
+
 void DeepFilterNet::setup() {
   if (rate == 0 || n_samples == 0) {
     // Some signals may be emitted before PipeWire calls our setup function
@@ -136,21 +177,26 @@ void DeepFilterNet::setup() {
         ladspa_wrapper->create_instance(48000);
 
         if (resample && !resampler_ready) {
-          resampler_inL = std::make_unique<Resampler>(rate, 48000);
-          resampler_inR = std::make_unique<Resampler>(rate, 48000);
-          resampler_outL = std::make_unique<Resampler>(48000, rate);
-          resampler_outR = std::make_unique<Resampler>(48000, rate);
+          resampler_in = std::make_unique<MultichannelResampler>(2U, rate, 48000U, n_samples);
+          resampler_out =
+              std::make_unique<MultichannelResampler>(2U, 48000U, rate, resampler_in->max_output_frames());
 
-          std::vector<float> dummy(n_samples);
+          resampled_inL.resize(resampler_in->max_output_frames());
+          resampled_inR.resize(resampled_inL.size());
+          resampled_outL.resize(resampled_inL.size());
+          resampled_outR.resize(resampled_inL.size());
+          downsampled_L.resize(resampler_out->max_output_frames());
+          downsampled_R.resize(downsampled_L.size());
 
-          const auto resampled_inL = resampler_inL->process(dummy);
-          const auto resampled_inR = resampler_inR->process(dummy);
+          // Priming both resamplers with one block of silence, as the speex path did before.
 
-          resampled_outL.resize(resampled_inL.size());
-          resampled_outR.resize(resampled_inR.size());
+          const std::vector<float> dummy(n_samples);
 
-          resampler_outL->process(resampled_inL);
-          resampler_outR->process(resampled_inR);
+          const auto n_resampled = resampler_in->process(dummy, dummy, resampled_inL, resampled_inR);
+
+          resampler_out->process(std::span<const float>(resampled_inL.data(), n_resampled),
+                                 std::span<const float>(resampled_inR.data(), n_resampled), downsampled_L,
+                                 downsampled_R);
 
           carryover_l.clear();
           carryover_r.clear();
@@ -189,14 +235,13 @@ void DeepFilterNet::process(std::span<float>& left_in,
   }
 
   if (resample) {
-    const auto& resampled_inL = resampler_inL->process(left_in);
-    const auto& resampled_inR = resampler_inR->process(right_in);
-
-    resampled_outL.resize(resampled_inL.size());
-    resampled_outR.resize(resampled_inR.size());
+    const auto n_resampled = resampler_in->process(left_in, right_in, resampled_inL, resampled_inR);
 
-    ladspa_wrapper->n_samples = resampled_inL.size();
-    ladspa_wrapper->connect_data_ports(resampled_inL, resampled_inR, resampled_outL, resampled_outR);
+    ladspa_wrapper->n_samples = n_resampled;
+    ladspa_wrapper->connect_data_ports(std::span<const float>(resampled_inL.data(), n_resampled),
+                                       std::span<const float>(resampled_inR.data(), n_resampled),
+                                       std::span<float>(resampled_outL.data(), n_resampled),
+                                       std::span<float>(resampled_outR.data(), n_resampled));
   } else {
     ladspa_wrapper->connect_data_ports(left_in, right_in, left_out, right_out);
   }
@@ -204,8 +249,14 @@ void DeepFilterNet::process(std::span<float>& left_in,
   ladspa_wrapper->run();
 
   if (resample) {
-    const auto& outL = resampler_outL->process(resampled_outL);
-    const auto& outR = resampler_outR->process(resampled_outR);
+    const auto n_resampled = static_cast<size_t>(ladspa_wrapper->n_samples);
+
+    const auto n_out = resampler_out->process(std::span<const float>(resampled_outL.data(), n_resampled),
+                                              std::span<const float>(resampled_outR.data(), n_resampled),
+                                              downsampled_L, downsampled_R);
+
+    const auto outL = std::span<const float>(downsampled_L.data(), n_out);
+    const auto outR = std::span<const float>(downsampled_R.data(), n_out);
 
     const auto carryover_end_l = std::min(carryover_l.size(), left_out.size());
     const auto carryover_end_r = std::min(carryover_r.size(), right_out.size());
@@ -257,6 +308,10 @@ auto DeepFilterNet::get_latency_seconds() -> float {
   return 0.02F + (1.0F / rate);
 }
 
+auto DeepFilterNet::is_primed() -> bool {
+  return rate != 0U && ready;
+}
+
 void DeepFilterNet::resetHistory() {
   clear_data();
 }
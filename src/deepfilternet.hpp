@@ -31,7 +31,7 @@
 #include "pipeline_type.hpp"
 #include "plugin_base.hpp"
 #include "pw_manager.hpp"
-#include "resampler.hpp"
+#include "multichannel_resampler.hpp"
 
 class DeepFilterNet : public PluginBase {
   Q_OBJECT
@@ -66,8 +66,13 @@ class DeepFilterNet : public PluginBase {
 
   auto get_latency_seconds() -> float override;
 
+  auto is_primed() -> bool override;
+
   Q_INVOKABLE void resetHistory();
 
+ protected:
+  void park_engine(const bool& state) override;
+
  private:
   DbDeepFilterNet* settings = nullptr;
 
@@ -77,9 +82,10 @@ class DeepFilterNet : public PluginBase {
   bool resample = false;
   bool resampler_ready = true;
 
-  std::unique_ptr<Resampler> resampler_inL, resampler_outL;
-  std::unique_ptr<Resampler> resampler_inR, resampler_outR;
+  std::unique_ptr<MultichannelResampler> resampler_in, resampler_out;
 
+  std::vector<float> resampled_inL, resampled_inR;
   std::vector<float> resampled_outL, resampled_outR;
+  std::vector<float> downsampled_L, downsampled_R;
   std::vector<float> carryover_l, carryover_r;
 };
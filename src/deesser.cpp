@@ -58,6 +58,8 @@ Deesser::Deesser(const std::string& tag, pw::Manager* pipe_manager, PipelineType
 
   init_common_controls<DbDeesser>(settings);
 
+  enable_lv2_extra_channels();
+
   BIND_LV2_PORT("mode", mode, setMode, DbDeesser::modeChanged);
   BIND_LV2_PORT("detection", detection, setDetection, DbDeesser::detectionChanged);
   BIND_LV2_PORT("ratio", ratio, setRatio, DbDeesser::ratioChanged);
@@ -0,0 +1,184 @@
+/**
+ * Copyright © 2017-2026 Wellington Wallace
+ *
+ * This file is part of Easy Effects.
+ *
+ * Easy Effects is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Easy Effects is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "delay_estimator.hpp"
+#include <sys/types.h>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace {
+
+// Normalized correlation the peak must reach. Below it the echo path is too weak or too nonlinear to trust the lag.
+constexpr double min_correlation = 0.25;
+
+// Mean square level of the decimated far end below which it is considered silent (about -60 dBFS).
+constexpr double min_far_power = 1e-6;
+
+}  // namespace
+
+void DelayEstimator::init(const uint& rate) {
+  factor = std::max(1U, rate / decimated_rate);
+
+  const auto decimated = static_cast<double>(rate) / factor;
+
+  window = static_cast<size_t>(window_seconds * decimated);
+  max_lag = static_cast<size_t>(max_delay_seconds * decimated);
+
+  far_history.assign(window + max_lag, 0.0F);
+  near_history.assign(window + max_lag, 0.0F);
+
+  reset();
+}
+
+void DelayEstimator::reset() {
+  std::ranges::fill(far_history, 0.0F);
+  std::ranges::fill(near_history, 0.0F);
+
+  write_index = 0U;
+  filled = false;
+
+  n_accumulated = 0U;
+  far_sum = near_sum = 0.0F;
+}
+
+void DelayEstimator::push(std::span<const float> far_left,
+                          std::span<const float> far_right,
+                          std::span<const float> near_left,
+                          std::span<const float> near_right) {
+  if (far_history.empty()) {
+    return;
+  }
+
+  for (size_t n = 0U; n < near_left.size(); n++) {
+    far_sum += far_left[n] + far_right[n];
+    near_sum += near_left[n] + near_right[n];
+
+    if (++n_accumulated < factor) {
+      continue;
+    }
+
+    const auto scale = 0.5F / static_cast<float>(factor);
+
+    far_history[write_index] = far_sum * scale;
+    near_history[write_index] = near_sum * scale;
+
+    if (++write_index == far_history.size()) {
+      write_index = 0U;
+      filled = true;
+    }
+
+    n_accumulated = 0U;
+    far_sum = near_sum = 0.0F;
+  }
+}
+
+auto DelayEstimator::snapshot(Snapshot& output) const -> bool {
+  if (!filled) {
+    return false;
+  }
+
+  output.far.resize(far_history.size());
+  output.near.resize(near_history.size());
+
+  const auto split = static_cast<std::ptrdiff_t>(write_index);
+
+  std::rotate_copy(far_history.begin(), far_history.begin() + split, far_history.end(), output.far.begin());
+  std::rotate_copy(near_history.begin(), near_history.begin() + split, near_history.end(), output.near.begin());
+
+  output.factor = factor;
+  output.window = window;
+
+  return true;
+}
+
+auto DelayEstimator::estimate(const Snapshot& snapshot) -> int {
+  const auto& far = snapshot.far;
+  const auto& near = snapshot.near;
+  const auto window = snapshot.window;
+
+  if (window == 0U || far.size() < window || near.size() != far.size()) {
+    return -1;
+  }
+
+  const auto max_lag = far.size() - window;
+
+  // The near window is the most recent one. For a lag L it is compared to the far window that ended L frames ago.
+
+  const auto* near_window = near.data() + max_lag;
+
+  double near_energy = 0.0;
+
+  for (size_t n = 0U; n < window; n++) {
+    near_energy += static_cast<double>(near_window[n]) * near_window[n];
+  }
+
+  // Far energy of the window at lag 0. It is slid one frame back for every lag.
+
+  double far_energy = 0.0;
+
+  for (size_t n = max_lag; n < far.size(); n++) {
+    far_energy += static_cast<double>(far[n]) * far[n];
+  }
+
+  if (near_energy <= 0.0 || far_energy / static_cast<double>(window) < min_far_power) {
+    return -1;
+  }
+
+  double best = 0.0;
+  size_t best_lag = 0U;
+
+  for (size_t lag = 0U; lag <= max_lag; lag++) {
+    const auto* far_window = far.data() + max_lag - lag;
+
+    float dot = 0.0F;
+
+    for (size_t n = 0U; n < window; n++) {
+      dot += near_window[n] * far_window[n];
+    }
+
+    if (far_energy > 0.0) {
+      const auto c = std::fabs(dot) / std::sqrt(near_energy * far_energy);
+
+      if (c > best) {
+        best = c;
+        best_lag = lag;
+      }
+    }
+
+    if (lag < max_lag) {
+      const auto leaving = static_cast<double>(far_window[window - 1U]);
+      const auto entering = static_cast<double>(far_window[-1]);
+
+      far_energy = std::max(0.0, far_energy - leaving * leaving + entering * entering);
+    }
+  }
+
+  if (best < min_correlation) {
+    return -1;
+  }
+
+  return static_cast<int>(best_lag * snapshot.factor);
+}
+
+auto DelayEstimator::max_delay_frames() const -> uint {
+  return static_cast<uint>(max_lag * factor);
+}
@@ -0,0 +1,88 @@
+/**
+ * Copyright © 2017-2026 Wellington Wallace
+ *
+ * This file is part of Easy Effects.
+ *
+ * Easy Effects is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Easy Effects is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <sys/types.h>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+/**
+ * Estimates how long the far end signal takes to show up in the near end one, like the speaker to microphone path
+ * seen by an echo canceller. Both ends are mixed to mono, decimated by averaging to about decimated_rate and kept in
+ * two histories. estimate() cross-correlates the last window of the near end with the far end over the whole delay
+ * range and returns the lag of the normalized peak when it stands out.
+ *
+ * push() is allocation free and meant for the realtime thread. estimate() is too slow for it and works on copies
+ * taken with snapshot().
+ */
+class DelayEstimator {
+ public:
+  static constexpr uint decimated_rate = 4000U;
+
+  static constexpr double max_delay_seconds = 0.5;
+
+  static constexpr double window_seconds = 1.0;
+
+  // Allocates the histories. Not for the realtime thread.
+  void init(const uint& rate);
+
+  void reset();
+
+  void push(std::span<const float> far_left,
+            std::span<const float> far_right,
+            std::span<const float> near_left,
+            std::span<const float> near_right);
+
+  struct Snapshot {
+    std::vector<float> far, near;
+
+    uint factor = 1U;
+
+    size_t window = 0U;
+  };
+
+  // Copies both histories in time order. Returns false until they have been filled once.
+  auto snapshot(Snapshot& output) const -> bool;
+
+  /**
+   * Delay of the near end relative to the far end, in frames at the full rate. It is negative when the far end is
+   * too quiet or when the correlation has no clear peak, as happens when the microphone does not pick up the
+   * speakers at all.
+   */
+  static auto estimate(const Snapshot& snapshot) -> int;
+
+  [[nodiscard]] auto max_delay_frames() const -> uint;
+
+ private:
+  uint factor = 1U;  // decimation factor
+
+  size_t window = 0U, max_lag = 0U;  // in decimated frames
+
+  std::vector<float> far_history, near_history;
+
+  size_t write_index = 0U;
+
+  bool filled = false;
+
+  uint n_accumulated = 0U;
+
+  float far_sum = 0.0F, near_sum = 0.0F;
+};
@@ -19,15 +19,21 @@
 
 #include "echo_canceller.hpp"
 #include <api/audio/audio_processing.h>
+#include <qnamespace.h>
 #include <qobject.h>
+#include <qtimer.h>
 #include <sys/types.h>
 #include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
 #include <format>
 #include <mutex>
 #include <span>
 #include <string>
 #include <vector>
 #include "db_manager.hpp"
+#include "delay_estimator.hpp"
 #include "easyeffects_db_echo_canceller.h"
 #include "pipeline_type.hpp"
 #include "plugin_base.hpp"
@@ -35,6 +41,19 @@
 #include "tags_plugin_name.hpp"
 #include "util.hpp"
 
+namespace {
+
+// Part of the estimated delay left to webrtc, so an echo arriving a bit earlier than estimated is still cancelled.
+constexpr uint delay_margin_ms = 10U;
+
+// Estimates closer than this to the applied one do not move the probe, which would disturb the converged filter.
+constexpr uint delay_tolerance_ms = 2U;
+
+// Consecutive estimates, one per second, that have to agree before the probe alignment is changed.
+constexpr uint delay_agreement_count = 3U;
+
+}  // namespace
+
 EchoCanceller::EchoCanceller(const std::string& tag,
                              pw::Manager* pipe_manager,
                              PipelineType pipe_type,
@@ -48,9 +67,12 @@ EchoCanceller::EchoCanceller(const std::string& tag,
                  true),
       settings(db::Manager::self().get_plugin_db<DbEchoCanceller>(
           pipe_type,
-          tags::plugin_name::BaseName::echoCanceller + "#" + instance_id)) {
+          tags::plugin_name::BaseName::echoCanceller + "#" + instance_id)),
+      estimation_timer(new QTimer(this)) {
   init_common_controls<DbEchoCanceller>(settings);
 
+  delay_estimation = settings->enableDelayEstimation();
+
   ap_cfg.pipeline.multi_channel_render = true;
   ap_cfg.pipeline.multi_channel_capture = true;
 
@@ -105,6 +127,24 @@ EchoCanceller::EchoCanceller(const std::string& tag,
     ap_builder->ApplyConfig(ap_cfg);
   });
 
+  connect(settings, &DbEchoCanceller::enableDelayEstimationChanged, [&]() {
+    std::scoped_lock<std::mutex> lock(data_mutex);
+
+    delay_estimation = settings->enableDelayEstimation();
+
+    delay_estimator.reset();
+
+    clear_delay_estimate();
+  });
+
+  // The estimation is too heavy for the realtime thread. It runs on the worker once per second.
+
+  estimation_timer->setInterval(1000);
+
+  connect(estimation_timer, &QTimer::timeout, this, &EchoCanceller::estimate_delay);
+
+  estimation_timer->start();
+
   // Noise Suppression
 
   connect(settings, &DbEchoCanceller::enableNoiseSuppressionChanged, [&]() {
@@ -174,6 +214,10 @@ EchoCanceller::EchoCanceller(const std::string& tag,
 }
 
 EchoCanceller::~EchoCanceller() {
+  estimation_timer->stop();
+
+  stop_worker();
+
   if (connected_to_pw) {
     disconnect_from_pw();
   }
@@ -248,48 +292,83 @@ void EchoCanceller::process(std::span<float>& left_in,
     apply_gain(left_in, right_in, input_gain);
   }
 
-  buf_near_L.insert(buf_near_L.end(), left_in.begin(), left_in.end());
-  buf_near_R.insert(buf_near_R.end(), right_in.begin(), right_in.end());
-  buf_far_L.insert(buf_far_L.end(), probe_left.begin(), probe_left.end());
-  buf_far_R.insert(buf_far_R.end(), probe_right.begin(), probe_right.end());
+  if (delay_estimation && ap_cfg.echo_canceller.enabled) {
+    delay_estimator.push(probe_left, probe_right, left_in, right_in);
+  }
 
-  while (buf_near_L.size() >= near_L.size()) {
-    util::copy_bulk(buf_near_L, near_L);
-    util::copy_bulk(buf_near_R, near_R);
-    util::copy_bulk(buf_far_L, far_L);
-    util::copy_bulk(buf_far_R, far_R);
+  align_far(probe_left, probe_right);
 
-    float* near_ptrs[2] = {near_L.data(), near_R.data()};
-    float* far_ptrs[2] = {far_L.data(), far_R.data()};
+  if (n_samples % blocksize == 0U) {
+    // The quantum holds a whole number of webrtc blocks. They are processed straight from the PipeWire buffers.
 
-    ap_builder->ProcessReverseStream(far_ptrs, stream_config, stream_config, far_ptrs);
-    ap_builder->ProcessStream(near_ptrs, stream_config, stream_config, near_ptrs);
+    for (size_t offset = 0U; offset < n_samples; offset += blocksize) {
+      const float* far_ptrs[2] = {aligned_far_L.data() + offset, aligned_far_R.data() + offset};
+      const float* near_ptrs[2] = {left_in.data() + offset, right_in.data() + offset};
+      float* out_ptrs[2] = {left_out.data() + offset, right_out.data() + offset};
 
-    buf_out_L.insert(buf_out_L.end(), near_L.begin(), near_L.end());
-    buf_out_R.insert(buf_out_R.end(), near_R.begin(), near_R.end());
-  }
+      ap_builder->AnalyzeReverseStream(far_ptrs, stream_config);
 
-  if (buf_out_L.size() >= n_samples) {
-    util::copy_bulk(buf_out_L, left_out);
-    util::copy_bulk(buf_out_R, right_out);
-  } else {
-    const uint offset = n_samples - buf_out_L.size();
+      if (stream_delay_ms >= 0) {
+        ap_builder->set_stream_delay_ms(stream_delay_ms);
+      }
 
-    if (offset != latency_n_frames) {
-      latency_n_frames = offset;
+      ap_builder->ProcessStream(near_ptrs, stream_config, stream_config, out_ptrs);
+    }
+
+    if (latency_n_frames != 0U) {
+      latency_n_frames = 0U;
 
       notify_latency = true;
     }
+  } else {
+    buf_near_L.insert(buf_near_L.end(), left_in.begin(), left_in.end());
+    buf_near_R.insert(buf_near_R.end(), right_in.begin(), right_in.end());
+    buf_far_L.insert(buf_far_L.end(), aligned_far_L.begin(), aligned_far_L.end());
+    buf_far_R.insert(buf_far_R.end(), aligned_far_R.begin(), aligned_far_R.end());
 
-    // Fill beginning with zeros
-    std::fill_n(left_out.begin(), offset, 0.0F);
-    std::fill_n(right_out.begin(), offset, 0.0F);
+    while (buf_near_L.size() >= near_L.size()) {
+      util::copy_bulk(buf_near_L, near_L);
+      util::copy_bulk(buf_near_R, near_R);
+      util::copy_bulk(buf_far_L, far_L);
+      util::copy_bulk(buf_far_R, far_R);
 
-    std::ranges::copy(buf_out_L, left_out.begin() + offset);
-    std::ranges::copy(buf_out_R, right_out.begin() + offset);
+      float* near_ptrs[2] = {near_L.data(), near_R.data()};
+      float* far_ptrs[2] = {far_L.data(), far_R.data()};
 
-    buf_out_L.clear();
-    buf_out_R.clear();
+      ap_builder->ProcessReverseStream(far_ptrs, stream_config, stream_config, far_ptrs);
+
+      if (stream_delay_ms >= 0) {
+        ap_builder->set_stream_delay_ms(stream_delay_ms);
+      }
+
+      ap_builder->ProcessStream(near_ptrs, stream_config, stream_config, near_ptrs);
+
+      buf_out_L.insert(buf_out_L.end(), near_L.begin(), near_L.end());
+      buf_out_R.insert(buf_out_R.end(), near_R.begin(), near_R.end());
+    }
+
+    if (buf_out_L.size() >= n_samples) {
+      util::copy_bulk(buf_out_L, left_out);
+      util::copy_bulk(buf_out_R, right_out);
+    } else {
+      const uint offset = n_samples - buf_out_L.size();
+
+      if (offset != latency_n_frames) {
+        latency_n_frames = offset;
+
+        notify_latency = true;
+      }
+
+      // Fill beginning with zeros
+      std::fill_n(left_out.begin(), offset, 0.0F);
+      std::fill_n(right_out.begin(), offset, 0.0F);
+
+      std::ranges::copy(buf_out_L, left_out.begin() + offset);
+      std::ranges::copy(buf_out_R, right_out.begin() + offset);
+
+      buf_out_L.clear();
+      buf_out_R.clear();
+    }
   }
 
   if (output_gain != 1.0F) {
@@ -297,7 +376,7 @@ void EchoCanceller::process(std::span<float>& left_in,
   }
 
   if (notify_latency) {
-    const float latency_value = static_cast<float>(latency_n_frames) / static_cast<float>(rate);
+    latency_value = static_cast<float>(latency_n_frames) / static_cast<float>(rate);
 
     util::debug(std::format("{}{} latency: {} s", log_tag, name.toStdString(), latency_value));
 
@@ -338,9 +417,142 @@ void EchoCanceller::init_webrtc() {
 
   stream_config = webrtc::StreamConfig(rate, 2);
 
+  delay_estimator.init(rate);
+
+  // Power of two so the read and write positions can wrap with a mask.
+
+  size_t ring_size = 1U;
+
+  while (ring_size < delay_estimator.max_delay_frames() + n_samples) {
+    ring_size <<= 1U;
+  }
+
+  far_ring_L.assign(ring_size, 0.0F);
+  far_ring_R.assign(ring_size, 0.0F);
+
+  far_ring_position = 0U;
+
+  aligned_far_L.resize(n_samples);
+  aligned_far_R.resize(n_samples);
+
+  clear_delay_estimate();
+
   ready = true;
 }
 
+void EchoCanceller::align_far(const std::span<float>& probe_left, const std::span<float>& probe_right) {
+  const auto mask = far_ring_L.size() - 1U;
+
+  for (size_t n = 0U; n < probe_left.size(); n++) {
+    far_ring_L[(far_ring_position + n) & mask] = probe_left[n];
+    far_ring_R[(far_ring_position + n) & mask] = probe_right[n];
+  }
+
+  const auto start = far_ring_position + far_ring_L.size() - far_delay_frames;
+
+  for (size_t n = 0U; n < aligned_far_L.size(); n++) {
+    aligned_far_L[n] = far_ring_L[(start + n) & mask];
+    aligned_far_R[n] = far_ring_R[(start + n) & mask];
+  }
+
+  far_ring_position = (far_ring_position + probe_left.size()) & mask;
+}
+
+void EchoCanceller::estimate_delay() {
+  if (!ready || bypass || !delay_estimation || !settings->enableEchoCanceller() || estimating.exchange(true)) {
+    return;
+  }
+
+  // NOLINTBEGIN(clang-analyzer-cplusplus.NewDeleteLeaks)
+  QMetaObject::invokeMethod(
+      baseWorker,
+      [this] {
+        DelayEstimator::Snapshot snapshot;
+
+        bool filled = false;
+
+        {
+          std::scoped_lock<std::mutex> lock(data_mutex);
+
+          filled = delay_estimator.snapshot(snapshot);
+        }
+
+        if (filled) {
+          const auto delay = DelayEstimator::estimate(snapshot);
+
+          std::scoped_lock<std::mutex> lock(data_mutex);
+
+          apply_delay_estimate(delay);
+        }
+
+        estimating = false;
+      },
+      Qt::QueuedConnection);
+  // NOLINTEND(clang-analyzer-cplusplus.NewDeleteLeaks)
+}
+
+void EchoCanceller::apply_delay_estimate(const int& delay_frames) {
+  /**
+   * There is no estimate while the far end is silent, as in every pause of a
+   * call. That says nothing about the echo path, so the applied alignment is
+   * kept and webrtc does not have to converge again when the far end resumes.
+   */
+
+  if (delay_frames < 0 || rate == 0U) {
+    return;
+  }
+
+  // A run of estimates that agree with each other is needed before the probe is moved.
+
+  const auto tolerance = static_cast<int>(delay_tolerance_ms * rate / 1000U);
+
+  if (last_estimate >= 0 && std::abs(delay_frames - last_estimate) <= tolerance) {
+    agreeing_estimates++;
+  } else {
+    agreeing_estimates = 1U;
+  }
+
+  last_estimate = delay_frames;
+
+  if (agreeing_estimates < delay_agreement_count) {
+    return;
+  }
+
+  estimated_delay_ms = 1000.0F * static_cast<float>(delay_frames) / static_cast<float>(rate);
+
+  const auto margin = static_cast<int>(delay_margin_ms * rate / 1000U);
+  const auto max_delay = static_cast<int>(far_ring_L.size() - n_samples);
+
+  const auto target = static_cast<uint>(std::clamp(delay_frames - margin, 0, std::max(max_delay, 0)));
+
+  if (std::abs(static_cast<int>(target) - static_cast<int>(far_delay_frames)) > tolerance) {
+    far_delay_frames = target;
+
+    util::debug(std::format("{}{} estimated echo delay: {:.1f} ms", log_tag, name.toStdString(),
+                            estimated_delay_ms.load()));
+  }
+
+  const auto residual = std::max(0, delay_frames - static_cast<int>(far_delay_frames));
+
+  stream_delay_ms = static_cast<int>(std::lround(1000.0 * residual / rate));
+}
+
+void EchoCanceller::clear_delay_estimate() {
+  // Without an estimate the probe goes straight to webrtc and it searches the whole range on its own.
+
+  far_delay_frames = 0U;
+  stream_delay_ms = -1;
+
+  last_estimate = -1;
+  agreeing_estimates = 0U;
+
+  estimated_delay_ms = 0.0F;
+}
+
 auto EchoCanceller::get_latency_seconds() -> float {
   return latency_value;
 }
+
+float EchoCanceller::getEstimatedDelay() const {
+  return estimated_delay_ms;
+}
@@ -24,10 +24,14 @@
 #include <qobject.h>
 #include <qqmlintegration.h>
 #include <qtmetamacros.h>
+#include <qtimer.h>
 #include <qtypes.h>
+#include <atomic>
+#include <cstddef>
 #include <span>
 #include <string>
 #include <vector>
+#include "delay_estimator.hpp"
 #include "easyeffects_db_echo_canceller.h"
 #include "pipeline_type.hpp"
 #include "plugin_base.hpp"
@@ -66,6 +70,9 @@ class EchoCanceller : public PluginBase {
 
   auto get_latency_seconds() -> float override;
 
+  // Milliseconds. Zero while there is no estimate.
+  Q_INVOKABLE [[nodiscard]] float getEstimatedDelay() const;
+
  private:
   DbEchoCanceller* settings = nullptr;
 
@@ -88,5 +95,44 @@ class EchoCanceller : public PluginBase {
 
   webrtc::StreamConfig stream_config;
 
+  /**
+   * The probe is delayed by the estimated speaker to microphone delay minus a
+   * small margin before it reaches webrtc, so its own delay search only has to
+   * cover what is left. The rest is given to it with set_stream_delay_ms.
+   */
+  DelayEstimator delay_estimator;
+
+  bool delay_estimation = true;
+
+  QTimer* estimation_timer;
+
+  std::atomic<bool> estimating = false;
+
+  std::atomic<float> estimated_delay_ms = 0.0F;
+
+  int last_estimate = -1;
+
+  uint agreeing_estimates = 0U;
+
+  uint far_delay_frames = 0U;
+
+  int stream_delay_ms = -1;
+
+  std::vector<float> far_ring_L, far_ring_R;
+
+  size_t far_ring_position = 0U;
+
+  std::vector<float> aligned_far_L, aligned_far_R;
+
   void init_webrtc();
+
+  void align_far(const std::span<float>& probe_left, const std::span<float>& probe_right);
+
+  void estimate_delay();
+
+  // Must be called with data_mutex locked. A negative delay means there is no estimate and changes nothing.
+  void apply_delay_estimate(const int& delay_frames);
+
+  // Must be called with data_mutex locked. Used when the estimation is turned off or the rate changes.
+  void clear_delay_estimate();
 };
@@ -18,26 +18,29 @@
  */
 
 #include "effects_base.hpp"
-#include <gsl/gsl_interp.h>
-#include <gsl/gsl_spline.h>
+#include <pipewire/proxy.h>
 #include <qcontainerfwd.h>
 #include <qnamespace.h>
 #include <qobjectdefs.h>
 #include <qpoint.h>
-#include <qthread.h>
 #include <qtmetamacros.h>
+#include <qtimer.h>
 #include <qtypes.h>
 #include <spa/utils/defs.h>
 #include <QSharedPointer>
 #include <QString>
 #include <algorithm>
 #include <cstddef>
+#include <deque>
+#include <format>
 #include <map>
 #include <memory>
 #include <ranges>
+#include <set>
 #include <string>
 #include <utility>
 #include <vector>
+#include "analysis_bus.hpp"
 #include "autogain.hpp"
 #include "bass_enhancer.hpp"
 #include "bass_loudness.hpp"
@@ -76,26 +79,26 @@
 #include "tags_plugin_name.hpp"
 #include "util.hpp"
 #include "voice_suppressor.hpp"
+#include "worker_pool.hpp"
 
 EffectsBase::EffectsBase(pw::Manager* pipe_manager, PipelineType pipe_type)
     : log_tag(pipe_type == PipelineType::output ? "soe: " : "sie: "),
       pm(pipe_manager),
       pipeline_type(pipe_type),
-      baseWorker(new EffectsBaseWorker) {
+      baseWorker(new EffectsBaseWorker),
+      switch_timer(new QTimer(this)) {
   using namespace std::string_literals;
 
-  output_level = std::make_shared<OutputLevel>(log_tag, pm, pipeline_type, "0");
+  analysis_bus = std::make_shared<AnalysisBus>();
 
-  spectrum = std::make_shared<Spectrum>(log_tag, pm, pipeline_type, "0");
+  output_level = std::make_shared<OutputLevel>(log_tag, pm, pipeline_type, "0", analysis_bus);
+
+  spectrum = std::make_shared<Spectrum>(log_tag, analysis_bus);
 
   if (!output_level->connected_to_pw) {
     output_level->connect_to_pw();
   }
 
-  if (!spectrum->connected_to_pw) {
-    spectrum->connect_to_pw();
-  }
-
   create_filters_if_necessary();
 
   switch (pipeline_type) {
@@ -115,26 +118,21 @@ EffectsBase::EffectsBase(pw::Manager* pipe_manager, PipelineType pipe_type)
     }
   });
 
-  // worker thread for the native ui and maybe also other things
+  connect(DbMain::self(), &DbMain::idlePluginPoolSizeChanged, this, [&]() { trim_idle_plugins(); });
+
+  switch_timer->setInterval(10);
 
-  baseWorker->moveToThread(&workerThread);
+  connect(switch_timer, &QTimer::timeout, this, &EffectsBase::on_switch_timer);
 
-  workerThread.start();
+  // worker for the native ui and maybe also other things
 
-  connect(&workerThread, &QThread::finished, baseWorker, &QObject::deleteLater);
+  WorkerPool::self().attach(baseWorker);
 }
 
 EffectsBase::~EffectsBase() {
-  workerThread.quit();
-  workerThread.wait();
+  cancel_chain_switch();
 
-  if (gsl_acc != nullptr) {
-    gsl_interp_accel_free(gsl_acc);
-  }
-
-  if (spline != nullptr) {
-    gsl_spline_free(spline);
-  }
+  WorkerPool::self().release(baseWorker);
 
   util::debug("effects_base: destroyed");
 }
@@ -142,6 +140,12 @@ EffectsBase::~EffectsBase() {
 void EffectsBase::create_filters_if_necessary() {
   auto list = (pipeline_type == PipelineType::output ? DbStreamOutputs::plugins() : DbStreamInputs::plugins());
 
+  // The list was changed by something else while a new chain was being prepared.
+
+  if (switch_state != SwitchState::idle && list != standby_list) {
+    cancel_chain_switch();
+  }
+
   if (list.empty()) {
     return;
   }
@@ -151,148 +155,219 @@ void EffectsBase::create_filters_if_necessary() {
       continue;
     }
 
-    auto instance_id = tags::plugin_name::get_id(name);
+    if (auto node = idle_plugins.extract(name); !node.empty()) {
+      util::debug(std::format("{}reusing the idle instance of {}", log_tag, name.toStdString()));
 
-    std::unique_ptr<PluginBase> filter = nullptr;
+      std::erase(idle_order, name);
 
-    if (name.startsWith(tags::plugin_name::BaseName::autogain)) {
-      filter = std::make_unique<Autogain>(log_tag, pm, pipeline_type, instance_id);
+      plugins.insert(std::move(node));
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::bassEnhancer)) {
-      filter = std::make_unique<BassEnhancer>(log_tag, pm, pipeline_type, instance_id);
+      continue;
+    }
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::bassLoudness)) {
-      filter = std::make_unique<BassLoudness>(log_tag, pm, pipeline_type, instance_id);
+    plugins.insert(std::make_pair(name, make_plugin(name)));
+  }
+}
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::compressor)) {
-      filter = std::make_unique<Compressor>(log_tag, pm, pipeline_type, instance_id);
+auto EffectsBase::make_plugin(const QString& name) -> std::unique_ptr<PluginBase> {
+  auto instance_id = tags::plugin_name::get_id(name);
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::convolver)) {
-      filter = std::make_unique<Convolver>(log_tag, pm, pipeline_type, instance_id);
+  std::unique_ptr<PluginBase> filter = nullptr;
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::crossfeed)) {
-      filter = std::make_unique<Crossfeed>(log_tag, pm, pipeline_type, instance_id);
+  if (name.startsWith(tags::plugin_name::BaseName::autogain)) {
+    filter = std::make_unique<Autogain>(log_tag, pm, pipeline_type, instance_id);
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::crusher)) {
-      filter = std::make_unique<Crusher>(log_tag, pm, pipeline_type, instance_id);
+  } else if (name.startsWith(tags::plugin_name::BaseName::bassEnhancer)) {
+    filter = std::make_unique<BassEnhancer>(log_tag, pm, pipeline_type, instance_id);
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::crystalizer)) {
-      filter = std::make_unique<Crystalizer>(log_tag, pm, pipeline_type, instance_id);
+  } else if (name.startsWith(tags::plugin_name::BaseName::bassLoudness)) {
+    filter = std::make_unique<BassLoudness>(log_tag, pm, pipeline_type, instance_id);
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::deepfilternet)) {
-      filter = std::make_unique<DeepFilterNet>(log_tag, pm, pipeline_type, instance_id);
+  } else if (name.startsWith(tags::plugin_name::BaseName::compressor)) {
+    filter = std::make_unique<Compressor>(log_tag, pm, pipeline_type, instance_id);
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::deesser)) {
-      filter = std::make_unique<Deesser>(log_tag, pm, pipeline_type, instance_id);
+  } else if (name.startsWith(tags::plugin_name::BaseName::convolver)) {
+    filter = std::make_unique<Convolver>(log_tag, pm, pipeline_type, instance_id);
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::delay)) {
-      filter = std::make_unique<Delay>(log_tag, pm, pipeline_type, instance_id);
+  } else if (name.startsWith(tags::plugin_name::BaseName::crossfeed)) {
+    filter = std::make_unique<Crossfeed>(log_tag, pm, pipeline_type, instance_id);
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::echoCanceller)) {
-      filter = std::make_unique<EchoCanceller>(log_tag, pm, pipeline_type, instance_id);
+  } else if (name.startsWith(tags::plugin_name::BaseName::crusher)) {
+    filter = std::make_unique<Crusher>(log_tag, pm, pipeline_type, instance_id);
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::exciter)) {
-      filter = std::make_unique<Exciter>(log_tag, pm, pipeline_type, instance_id);
+  } else if (name.startsWith(tags::plugin_name::BaseName::crystalizer)) {
+    filter = std::make_unique<Crystalizer>(log_tag, pm, pipeline_type, instance_id);
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::expander)) {
-      filter = std::make_unique<Expander>(log_tag, pm, pipeline_type, instance_id);
+  } else if (name.startsWith(tags::plugin_name::BaseName::deepfilternet)) {
+    filter = std::make_unique<DeepFilterNet>(log_tag, pm, pipeline_type, instance_id);
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::equalizer)) {
-      filter = std::make_unique<Equalizer>(log_tag, pm, pipeline_type, instance_id);
+  } else if (name.startsWith(tags::plugin_name::BaseName::deesser)) {
+    filter = std::make_unique<Deesser>(log_tag, pm, pipeline_type, instance_id);
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::filter)) {
-      filter = std::make_unique<Filter>(log_tag, pm, pipeline_type, instance_id);
+  } else if (name.startsWith(tags::plugin_name::BaseName::delay)) {
+    filter = std::make_unique<Delay>(log_tag, pm, pipeline_type, instance_id);
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::gate)) {
-      filter = std::make_unique<Gate>(log_tag, pm, pipeline_type, instance_id);
+  } else if (name.startsWith(tags::plugin_name::BaseName::echoCanceller)) {
+    filter = std::make_unique<EchoCanceller>(log_tag, pm, pipeline_type, instance_id);
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::voiceSuppressor)) {
-      filter = std::make_unique<VoiceSuppressor>(log_tag, pm, pipeline_type, instance_id);
+  } else if (name.startsWith(tags::plugin_name::BaseName::exciter)) {
+    filter = std::make_unique<Exciter>(log_tag, pm, pipeline_type, instance_id);
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::lcc)) {
-      filter = std::make_unique<Lcc>(log_tag, pm, pipeline_type, instance_id);
+  } else if (name.startsWith(tags::plugin_name::BaseName::expander)) {
+    filter = std::make_unique<Expander>(log_tag, pm, pipeline_type, instance_id);
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::levelMeter)) {
-      filter = std::make_unique<LevelMeter>(log_tag, pm, pipeline_type, instance_id);
+  } else if (name.startsWith(tags::plugin_name::BaseName::equalizer)) {
+    filter = std::make_unique<Equalizer>(log_tag, pm, pipeline_type, instance_id);
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::limiter)) {
-      filter = std::make_unique<Limiter>(log_tag, pm, pipeline_type, instance_id);
+  } else if (name.startsWith(tags::plugin_name::BaseName::filter)) {
+    filter = std::make_unique<Filter>(log_tag, pm, pipeline_type, instance_id);
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::loudness)) {
-      filter = std::make_unique<Loudness>(log_tag, pm, pipeline_type, instance_id);
+  } else if (name.startsWith(tags::plugin_name::BaseName::gate)) {
+    filter = std::make_unique<Gate>(log_tag, pm, pipeline_type, instance_id);
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::maximizer)) {
-      filter = std::make_unique<Maximizer>(log_tag, pm, pipeline_type, instance_id);
+  } else if (name.startsWith(tags::plugin_name::BaseName::voiceSuppressor)) {
+    filter = std::make_unique<VoiceSuppressor>(log_tag, pm, pipeline_type, instance_id);
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::multibandCompressor)) {
-      filter = std::make_unique<MultibandCompressor>(log_tag, pm, pipeline_type, instance_id);
+  } else if (name.startsWith(tags::plugin_name::BaseName::lcc)) {
+    filter = std::make_unique<Lcc>(log_tag, pm, pipeline_type, instance_id);
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::multibandGate)) {
-      filter = std::make_unique<MultibandGate>(log_tag, pm, pipeline_type, instance_id);
+  } else if (name.startsWith(tags::plugin_name::BaseName::levelMeter)) {
+    filter = std::make_unique<LevelMeter>(log_tag, pm, pipeline_type, instance_id);
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::pitch)) {
-      filter = std::make_unique<Pitch>(log_tag, pm, pipeline_type, instance_id);
+  } else if (name.startsWith(tags::plugin_name::BaseName::limiter)) {
+    filter = std::make_unique<Limiter>(log_tag, pm, pipeline_type, instance_id);
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::reverb)) {
-      filter = std::make_unique<Reverb>(log_tag, pm, pipeline_type, instance_id);
+  } else if (name.startsWith(tags::plugin_name::BaseName::loudness)) {
+    filter = std::make_unique<Loudness>(log_tag, pm, pipeline_type, instance_id);
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::rnnoise)) {
-      filter = std::make_unique<RNNoise>(log_tag, pm, pipeline_type, instance_id);
+  } else if (name.startsWith(tags::plugin_name::BaseName::maximizer)) {
+    filter = std::make_unique<Maximizer>(log_tag, pm, pipeline_type, instance_id);
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::speex)) {
-      filter = std::make_unique<Speex>(log_tag, pm, pipeline_type, instance_id);
+  } else if (name.startsWith(tags::plugin_name::BaseName::multibandCompressor)) {
+    filter = std::make_unique<MultibandCompressor>(log_tag, pm, pipeline_type, instance_id);
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::stereoTools)) {
-      filter = std::make_unique<StereoTools>(log_tag, pm, pipeline_type, instance_id);
-    }
+  } else if (name.startsWith(tags::plugin_name::BaseName::multibandGate)) {
+    filter = std::make_unique<MultibandGate>(log_tag, pm, pipeline_type, instance_id);
 
-    if (filter != nullptr) {
-      /**
-       * The filters inherit from QObject and we do not want QML to take
-       * ownership of them. Double free may happen in this case when closing
-       * the window or doing similar actions that trigger qml cleanup. The way
-       * to avoid this is making sure that the objects managed by the C++
-       * backend already have a parent by the time they are used on QML.
-       */
-      filter->setParent(this);
-    }
+  } else if (name.startsWith(tags::plugin_name::BaseName::pitch)) {
+    filter = std::make_unique<Pitch>(log_tag, pm, pipeline_type, instance_id);
 
-    plugins.insert(std::make_pair(name, std::move(filter)));
+  } else if (name.startsWith(tags::plugin_name::BaseName::reverb)) {
+    filter = std::make_unique<Reverb>(log_tag, pm, pipeline_type, instance_id);
+
+  } else if (name.startsWith(tags::plugin_name::BaseName::rnnoise)) {
+    filter = std::make_unique<RNNoise>(log_tag, pm, pipeline_type, instance_id);
+
+  } else if (name.startsWith(tags::plugin_name::BaseName::speex)) {
+    filter = std::make_unique<Speex>(log_tag, pm, pipeline_type, instance_id);
+
+  } else if (name.startsWith(tags::plugin_name::BaseName::stereoTools)) {
+    filter = std::make_unique<StereoTools>(log_tag, pm, pipeline_type, instance_id);
+  }
+
+  if (filter != nullptr) {
+    /**
+     * The filters inherit from QObject and we do not want QML to take
+     * ownership of them. Double free may happen in this case when closing
+     * the window or doing similar actions that trigger qml cleanup. The way
+     * to avoid this is making sure that the objects managed by the C++
+     * backend already have a parent by the time they are used on QML.
+     */
+    filter->setParent(this);
+
+    // With the splice option the pipeline has to be relinked when a plugin is bypassed or reinstated.
+
+    connect(
+        filter.get(), &PluginBase::bypassChanged, this,
+        [this]() {
+          if (DbMain::spliceBypassedPlugins()) {
+            Q_EMIT pluginBypassChanged();
+          }
+        },
+        Qt::QueuedConnection);
   }
+
+  return filter;
 }
 
 void EffectsBase::remove_unused_filters() {
   auto list = (pipeline_type == PipelineType::output ? DbStreamOutputs::plugins() : DbStreamInputs::plugins());
 
-  if (list.empty()) {
-    plugins.clear();
-
-    return;
-  }
-
   for (auto it = plugins.begin(); it != plugins.end();) {
     auto key = it->first;
 
     if (std::ranges::find(list, key) == list.end()) {
-      auto plugin = std::move(it->second);  // Move the unique_ptr
-
-      if (plugin == nullptr) {
+      if (it->second == nullptr) {
         it = plugins.erase(it);
 
         continue;
       }
 
-      plugin->bypass = true;
-
-      if (plugin->connected_to_pw) {
-        plugin->disconnect_from_pw();
-      }
-
-      it = plugins.erase(it);
+      move_to_idle(plugins.extract(it++));
     } else {
       it++;
     }
   }
+
+  trim_idle_plugins();
+}
+
+void EffectsBase::move_to_idle(std::map<QString, std::unique_ptr<PluginBase>>::node_type node) {
+  auto& plugin = node.mapped();
+
+  const bool bypass = plugin->bypass;
+
+  plugin->bypass = true;
+
+  if (plugin->connected_to_pw) {
+    plugin->disconnect_from_pw();
+  }
+
+  // Nothing is processed anymore. Restore the state given by the settings for when it is reused.
+
+  plugin->bypass = bypass;
+
+  plugin->start_fade(true, 0U);
+
+  idle_order.push_back(node.key());
+
+  idle_plugins.insert(std::move(node));
+}
+
+void EffectsBase::trim_idle_plugins() {
+  const auto max_size = static_cast<size_t>(DbMain::idlePluginPoolSize());
+
+  while (idle_order.size() > max_size) {
+    util::debug(std::format("{}destroying the idle instance of {}", log_tag, idle_order.front().toStdString()));
+
+    idle_plugins.erase(idle_order.front());
+
+    idle_order.pop_front();
+  }
+}
+
+auto EffectsBase::get_linked_plugins(const QStringList& list) -> QStringList {
+  const auto splice = DbMain::spliceBypassedPlugins();
+
+  QStringList linked;
+
+  for (const auto& name : list) {
+    if (!plugins.contains(name) || plugins[name] == nullptr) {
+      continue;
+    }
+
+    if (splice && plugins[name]->bypass) {
+      plugins[name]->park(true);
+
+      continue;
+    }
+
+    plugins[name]->park(false);
+
+    linked.append(name);
+  }
+
+  return linked;
 }
 
 void EffectsBase::activate_filters() {
@@ -307,6 +382,339 @@ void EffectsBase::deactivate_filters() {
   }
 }
 
+auto EffectsBase::chain_source_node_id() -> uint {
+  return SPA_ID_INVALID;
+}
+
+auto EffectsBase::find_linked_tail() -> QString {
+  const auto level_id = output_level->get_node_id();
+
+  for (const auto& [name, plugin] : plugins) {
+    if (plugin == nullptr || !plugin->connected_to_pw) {
+      continue;
+    }
+
+    if (std::ranges::any_of(pm->get_links(), [&](const auto& link) {
+          return link.output_node_id == plugin->get_node_id() && link.input_node_id == level_id;
+        })) {
+      return name;
+    }
+  }
+
+  return {};
+}
+
+void EffectsBase::set_plugins_list(const QStringList& list) const {
+  switch (pipeline_type) {
+    case PipelineType::input:
+      DbStreamInputs::setPlugins(list);
+      break;
+    case PipelineType::output:
+      DbStreamOutputs::setPlugins(list);
+      break;
+  }
+}
+
+auto EffectsBase::switch_chain(const QStringList& list) -> bool {
+  cancel_chain_switch();
+
+  if (DbMain::bypass() || !filtersLinked || list.empty()) {
+    return false;
+  }
+
+  // The echo canceller also needs its probe linked and some time to converge. It is loaded the usual way.
+
+  if (std::ranges::any_of(list, [](const auto& name) {
+        return name.startsWith(tags::plugin_name::BaseName::echoCanceller);
+      })) {
+    return false;
+  }
+
+  const auto source_id = chain_source_node_id();
+
+  live_tail = find_linked_tail();
+
+  if (source_id == SPA_ID_INVALID || live_tail.isEmpty()) {
+    return false;
+  }
+
+  // Both chains run at the same time, so they can not share plugin instances.
+
+  if (std::ranges::any_of(list, [&](const auto& name) { return plugins.contains(name); })) {
+    return false;
+  }
+
+  for (const auto& name : list) {
+    if (auto node = idle_plugins.extract(name); !node.empty()) {
+      std::erase(idle_order, name);
+
+      standby_plugins.insert(std::move(node));
+
+      continue;
+    }
+
+    if (auto filter = make_plugin(name); filter != nullptr) {
+      standby_plugins.insert(std::make_pair(name, std::move(filter)));
+    }
+  }
+
+  const auto splice = DbMain::spliceBypassedPlugins();
+
+  for (const auto& name : list) {
+    if (!standby_plugins.contains(name)) {
+      continue;
+    }
+
+    auto& plugin = standby_plugins[name];
+
+    if (splice && plugin->bypass) {
+      plugin->park(true);
+
+      continue;
+    }
+
+    plugin->park(false);
+
+    standby_linked.append(name);
+  }
+
+  if (standby_linked.empty()) {
+    cancel_chain_switch();
+
+    return false;
+  }
+
+  // The new chain is linked with its output muted until it is primed.
+
+  standby_plugins[standby_linked.back()]->mute_output();
+
+  uint next_node_id = output_level->get_node_id();
+
+  for (const auto& name : std::ranges::reverse_view(standby_linked)) {
+    auto& plugin = standby_plugins[name];
+
+    if (!plugin->connected_to_pw && !plugin->connect_to_pw()) {
+      cancel_chain_switch();
+
+      return false;
+    }
+
+    const auto links = pm->link_nodes(plugin->get_node_id(), next_node_id);
+
+    standby_proxies.insert(standby_proxies.end(), links.begin(), links.end());
+
+    if (links.empty()) {
+      util::warning(std::format("{}link from node {} to node {} failed", log_tag, plugin->get_node_id(), next_node_id));
+
+      cancel_chain_switch();
+
+      return false;
+    }
+
+    plugin->update_probe_links();
+
+    next_node_id = plugin->get_node_id();
+  }
+
+  const auto links = pm->link_nodes(source_id, next_node_id);
+
+  standby_proxies.insert(standby_proxies.end(), links.begin(), links.end());
+
+  if (links.empty()) {
+    util::warning(std::format("{}link from node {} to node {} failed", log_tag, source_id, next_node_id));
+
+    cancel_chain_switch();
+
+    return false;
+  }
+
+  util::debug(std::format("{}priming the new chain before switching to it", log_tag));
+
+  standby_list = list;
+
+  switch_state = SwitchState::priming;
+
+  primed_at = -1;
+
+  switch_clock.start();
+
+  switch_timer->start();
+
+  return true;
+}
+
+void EffectsBase::on_switch_timer() {
+  const auto elapsed = switch_clock.elapsed();
+
+  const auto duration = DbMain::presetCrossfadeDuration();
+
+  if (switch_state == SwitchState::priming) {
+    if (!std::ranges::all_of(standby_linked, [&](const auto& name) { return standby_plugins[name]->is_primed(); })) {
+      if (elapsed > switch_prime_timeout) {
+        util::warning(std::format("{}the new chain took too long to be ready. Loading it the usual way", log_tag));
+
+        const auto list = standby_list;
+
+        cancel_chain_switch();
+
+        set_plugins_list(list);
+      }
+
+      return;
+    }
+
+    if (primed_at < 0) {
+      primed_at = elapsed;
+    }
+
+    /**
+     * Plugins with lookahead and internal buffers only output the processed signal after their latency has passed.
+     * The chain keeps running muted for twice that time, and for at least a few quanta.
+     */
+
+    auto latency = 0.0F;
+
+    for (const auto& name : standby_linked) {
+      latency += standby_plugins[name]->get_latency_seconds();
+    }
+
+    if (elapsed - primed_at < std::max(switch_min_settle, static_cast<qint64>(2000.0F * latency))) {
+      return;
+    }
+
+    if (!plugins.contains(live_tail) || plugins[live_tail] == nullptr) {
+      const auto list = standby_list;
+
+      cancel_chain_switch();
+
+      set_plugins_list(list);
+
+      return;
+    }
+
+    plugins[live_tail]->start_fade(false, duration);
+
+    standby_plugins[standby_linked.back()]->start_fade(true, duration);
+
+    switch_state = SwitchState::crossfading;
+
+    fade_started_at = elapsed;
+
+    return;
+  }
+
+  // A couple of quanta of margin so the realtime thread has finished the fade before the old chain is unlinked.
+
+  if (elapsed - fade_started_at < duration + switch_fade_margin) {
+    return;
+  }
+
+  commit_chain_switch();
+}
+
+void EffectsBase::commit_chain_switch() {
+  switch_timer->stop();
+
+  // The old chain is silent now. Unlinking it does not change what is heard.
+
+  std::set<uint> old_nodes;
+
+  for (const auto& plugin : plugins | std::views::values) {
+    if (plugin != nullptr && plugin->connected_to_pw) {
+      old_nodes.insert(plugin->get_node_id());
+    }
+  }
+
+  std::vector<pw_proxy*> old_links;
+
+  std::erase_if(list_proxies, [&](pw_proxy* proxy) {
+    const auto id = pw_proxy_get_bound_id(proxy);
+
+    const auto is_old = std::ranges::any_of(pm->get_links(), [&](const auto& link) {
+      return link.id == id && (old_nodes.contains(link.input_node_id) || old_nodes.contains(link.output_node_id));
+    });
+
+    if (is_old) {
+      old_links.push_back(proxy);
+    }
+
+    return is_old;
+  });
+
+  pm->destroy_links(old_links);
+
+  while (!plugins.empty()) {
+    auto node = plugins.extract(plugins.begin());
+
+    if (node.mapped() != nullptr) {
+      node.mapped()->clear_data();
+
+      move_to_idle(std::move(node));
+    }
+  }
+
+  plugins.merge(standby_plugins);
+
+  list_proxies.insert(list_proxies.end(), standby_proxies.begin(), standby_proxies.end());
+
+  adopted_list = standby_list;
+
+  standby_plugins.clear();
+  standby_proxies.clear();
+  standby_linked.clear();
+  standby_list.clear();
+  live_tail.clear();
+
+  switch_state = SwitchState::idle;
+
+  trim_idle_plugins();
+
+  util::debug(std::format("{}switched to the new chain", log_tag));
+
+  set_plugins_list(adopted_list);
+}
+
+void EffectsBase::cancel_chain_switch() {
+  if (switch_state == SwitchState::idle && standby_plugins.empty()) {
+    return;
+  }
+
+  switch_timer->stop();
+
+  pm->destroy_links(standby_proxies);
+
+  if (switch_state == SwitchState::crossfading && plugins.contains(live_tail) && plugins[live_tail] != nullptr) {
+    plugins[live_tail]->start_fade(true, DbMain::presetCrossfadeDuration());
+  }
+
+  while (!standby_plugins.empty()) {
+    move_to_idle(standby_plugins.extract(standby_plugins.begin()));
+  }
+
+  standby_proxies.clear();
+  standby_linked.clear();
+  standby_list.clear();
+  live_tail.clear();
+
+  switch_state = SwitchState::idle;
+
+  trim_idle_plugins();
+}
+
+auto EffectsBase::take_adopted_chain() -> bool {
+  if (adopted_list.isEmpty()) {
+    return false;
+  }
+
+  const auto list = (pipeline_type == PipelineType::output ? DbStreamOutputs::plugins() : DbStreamInputs::plugins());
+
+  const auto adopted = (list == adopted_list);
+
+  adopted_list.clear();
+
+  return adopted;
+}
+
 auto EffectsBase::get_plugins_map() -> std::map<QString, std::unique_ptr<PluginBase>>& {
   return plugins;
 }
@@ -466,54 +874,12 @@ void EffectsBase::requestSpectrumData() {
   QMetaObject::invokeMethod(
       baseWorker,
       [this] {
-        auto [rate, bin_hz, list] = spectrum->compute_magnitudes();
+        auto output_data = spectrum->compute_magnitudes();
 
-        if (list.empty() || rate == 0) {
+        if (output_data.empty()) {
           return;
         }
 
-        const qsizetype n_bands = list.size();
-
-        QList<double> frequencies(n_bands);
-
-        for (qsizetype n = 0; n < n_bands; n++) {
-          frequencies[n] = static_cast<float>(n) * bin_hz;
-        }
-
-        const auto min_freq = static_cast<float>(DbSpectrum::minimumFrequency());
-        const auto max_freq = static_cast<float>(DbSpectrum::maximumFrequency());
-
-        if (min_freq > (max_freq - 100.0F)) {
-          return;
-        }
-
-        std::vector<float> x_axis;
-
-        if (DbSpectrum::logarithimicHorizontalAxis()) {
-          x_axis = util::logspace(min_freq, max_freq, DbSpectrum::nPoints());
-        } else {
-          x_axis = util::linspace(min_freq, max_freq, DbSpectrum::nPoints());
-        }
-
-        if (spline == nullptr) {
-          // The spectrum plugin sends arrays that always have the same size. So we can do this only once.
-          spline = gsl_spline_alloc(gsl_interp_steffen, n_bands);
-        }
-
-        gsl_spline_init(spline, frequencies.data(), list.data(), n_bands);
-
-        QList<double> spectrum_mag(x_axis.size());
-
-        for (size_t n = 0; n < x_axis.size(); n++) {
-          spectrum_mag[n] = gsl_spline_eval(spline, x_axis[n], gsl_acc);
-        }
-
-        QList<QPointF> output_data(spectrum_mag.size());
-
-        for (qsizetype n = 0; n < spectrum_mag.size(); n++) {
-          output_data[n] = QPointF(x_axis[n], spectrum_mag[n]);
-        }
-
         Q_EMIT newSpectrumData(output_data);
       },
       Qt::QueuedConnection);
@@ -526,5 +892,5 @@ void EffectsBase::setUpdateLevelMeters(const bool& state) {
 }
 
 void EffectsBase::setSpectrumBypass(const bool& state) {
-  spectrum->bypass = state;
+  spectrum->set_bypass(state);
 }
@@ -19,27 +19,31 @@
 
 #pragma once
 
-#include <gsl/gsl_interp.h>
-#include <gsl/gsl_spline.h>
 #include <kconfigskeleton.h>
 #include <pipewire/proxy.h>
 #include <qlist.h>
 #include <qobject.h>
 #include <qpoint.h>
 #include <qtmetamacros.h>
+#include <qtimer.h>
 #include <qtypes.h>
+#include <QElapsedTimer>
 #include <QString>
+#include <QStringList>
+#include <deque>
 #include <map>
 #include <memory>
 #include <string>
 #include <vector>
+#include "analysis_bus.hpp"
 #include "output_level.hpp"
 #include "pipeline_type.hpp"
 #include "plugin_base.hpp"
 #include "pw_manager.hpp"
 #include "spectrum.hpp"
+#include "worker_pool.hpp"
 
-class EffectsBaseWorker : public QObject {
+class EffectsBaseWorker : public PoolWorker {
   Q_OBJECT
 };
 
@@ -62,6 +66,7 @@ class EffectsBase : public QObject {
 
   PipelineType pipeline_type;
 
+  std::shared_ptr<AnalysisBus> analysis_bus;
   std::shared_ptr<OutputLevel> output_level;
   std::shared_ptr<Spectrum> spectrum;
 
@@ -83,8 +88,20 @@ class EffectsBase : public QObject {
 
   Q_INVOKABLE void setSpectrumBypass(const bool& state);
 
+  /**
+   * Seamless switching to a new list of plugins. Their chain is built and linked next to the running one with its
+   * output muted, and it keeps running until every plugin is primed. Then the tails of both chains are crossfaded into
+   * the output level meter and the old chain is unlinked. The plugins of the list must not be in the running chain,
+   * so their settings can be loaded beforehand. Returns false when the switch can not be done this way and the list
+   * has to be applied as usual.
+   */
+  auto switch_chain(const QStringList& list) -> bool;
+
+  void cancel_chain_switch();
+
  Q_SIGNALS:
   void pipelineChanged();
+  void pluginBypassChanged();
   void newSpectrumData(QList<QPointF> newData);
   void filtersLinkedChanged();
 
@@ -93,21 +110,78 @@ class EffectsBase : public QObject {
 
   std::map<QString, std::unique_ptr<PluginBase>> plugins;
 
+  /**
+   * Plugins recently removed from the pipeline. They are disconnected from PipeWire but keep their plugin instances
+   * and settings bindings, so create_filters_if_necessary can take them back instead of building new ones.
+   * idle_order has the oldest one first.
+   */
+  std::map<QString, std::unique_ptr<PluginBase>> idle_plugins;
+
+  std::deque<QString> idle_order;
+
   std::vector<pw_proxy*> list_proxies, list_proxies_listen_mic;
 
   EffectsBaseWorker* baseWorker;
 
-  QThread workerThread;
-
   void create_filters_if_necessary();
 
   void remove_unused_filters();
 
+  void trim_idle_plugins();
+
+  /**
+   * Returns the plugins of the list that have to be linked. When the splice option is enabled the bypassed ones are
+   * left out of the graph and parked.
+   */
+  auto get_linked_plugins(const QStringList& list) -> QStringList;
+
   void activate_filters();
 
   void deactivate_filters();
 
+  auto make_plugin(const QString& name) -> std::unique_ptr<PluginBase>;
+
+  void move_to_idle(std::map<QString, std::unique_ptr<PluginBase>>::node_type node);
+
+  /**
+   * Node that feeds the first plugin of the pipeline.
+   */
+  virtual auto chain_source_node_id() -> uint;
+
+  /**
+   * Called when the plugins list changes. Returns true when the new list is the chain that was just switched to, which
+   * is already linked.
+   */
+  auto take_adopted_chain() -> bool;
+
  private:
-  gsl_interp_accel* gsl_acc = gsl_interp_accel_alloc();
-  gsl_spline* spline = nullptr;
+  enum class SwitchState { idle, priming, crossfading };
+
+  static constexpr qint64 switch_prime_timeout = 5000;  // ms
+  static constexpr qint64 switch_min_settle = 100;      // ms
+  static constexpr qint64 switch_fade_margin = 40;      // ms
+
+  SwitchState switch_state = SwitchState::idle;
+
+  std::map<QString, std::unique_ptr<PluginBase>> standby_plugins;
+
+  std::vector<pw_proxy*> standby_proxies;
+
+  QStringList standby_list, standby_linked, adopted_list;
+
+  QString live_tail;
+
+  QTimer* switch_timer = nullptr;
+
+  QElapsedTimer switch_clock;
+
+  qint64 primed_at = -1, fade_started_at = 0;
+
+  auto find_linked_tail() -> QString;
+
+  void set_plugins_list(const QStringList& list) const;
+
+  void on_switch_timer();
+
+  void commit_chain_switch();
 };
@@ -78,6 +78,8 @@ Equalizer::Equalizer(const std::string& tag, pw::Manager* pipe_manager, Pipeline
 
   init_common_controls<DbEqualizer>(settings);
 
+  enable_lv2_extra_channels();
+
   BIND_LV2_PORT("mode", mode, setMode, DbEqualizer::modeChanged);
   BIND_LV2_PORT("bal", balance, setBalance, DbEqualizer::balanceChanged);
   BIND_LV2_PORT("frqs_l", pitchLeft, setPitchLeft, DbEqualizer::pitchLeftChanged);
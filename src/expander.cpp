@@ -58,10 +58,22 @@ Expander::Expander(const std::string& tag, pw::Manager* pipe_manager, PipelineTy
 
   if (!packageInstalled) {
     util::debug(std::format("{}{} is not installed", log_tag, lv2_plugin_uri));
+  } else {
+    meter_ports = {.latency = lv2_wrapper->get_control_port_index("out_latency"),
+                   .reduction_left = lv2_wrapper->get_control_port_index("rlm_l"),
+                   .reduction_right = lv2_wrapper->get_control_port_index("rlm_r"),
+                   .sidechain_left = lv2_wrapper->get_control_port_index("slm_l"),
+                   .sidechain_right = lv2_wrapper->get_control_port_index("slm_r"),
+                   .curve_left = lv2_wrapper->get_control_port_index("clm_l"),
+                   .curve_right = lv2_wrapper->get_control_port_index("clm_r"),
+                   .envelope_left = lv2_wrapper->get_control_port_index("elm_l"),
+                   .envelope_right = lv2_wrapper->get_control_port_index("elm_r")};
   }
 
   init_common_controls<DbExpander>(settings);
 
+  enable_lv2_extra_channels();
+
   connect(settings, &DbExpander::sidechainTypeChanged, [&]() { update_sidechain_links(); });
   connect(settings, &DbExpander::sidechainInputDeviceChanged, [&]() { update_sidechain_links(); });
 
@@ -204,7 +216,7 @@ void Expander::process(std::span<float>& left_in,
 
   // This plugin gives the latency in number of samples
 
-  const auto lv = static_cast<uint>(lv2_wrapper->get_control_port_value("out_latency"));
+  const auto lv = static_cast<uint>(lv2_wrapper->get_control_port_value(meter_ports.latency));
 
   if (latency_n_frames != lv) {
     latency_n_frames = lv;
@@ -219,17 +231,16 @@ void Expander::process(std::span<float>& left_in,
   if (updateLevelMeters) {
     get_peaks(left_in, right_in, left_out, right_out);
 
-    reduction_left = util::linear_to_db(lv2_wrapper->get_control_port_value("rlm_l"));
-    reduction_right = util::linear_to_db(lv2_wrapper->get_control_port_value("rlm_r"));
-
-    sidechain_left = util::linear_to_db(lv2_wrapper->get_control_port_value("slm_l"));
-    sidechain_right = util::linear_to_db(lv2_wrapper->get_control_port_value("slm_r"));
-
-    curve_left = util::linear_to_db(lv2_wrapper->get_control_port_value("clm_l"));
-    curve_right = util::linear_to_db(lv2_wrapper->get_control_port_value("clm_r"));
+    auto db = [&](const uint& port) { return util::linear_to_db(lv2_wrapper->get_control_port_value(port)); };
 
-    envelope_left = util::linear_to_db(lv2_wrapper->get_control_port_value("elm_l"));
-    envelope_right = util::linear_to_db(lv2_wrapper->get_control_port_value("elm_r"));
+    meters.write({.reduction_left = db(meter_ports.reduction_left),
+                  .reduction_right = db(meter_ports.reduction_right),
+                  .sidechain_left = db(meter_ports.sidechain_left),
+                  .sidechain_right = db(meter_ports.sidechain_right),
+                  .curve_left = db(meter_ports.curve_left),
+                  .curve_right = db(meter_ports.curve_right),
+                  .envelope_left = db(meter_ports.envelope_left),
+                  .envelope_right = db(meter_ports.envelope_right)});
   }
 }
 
@@ -265,34 +276,38 @@ auto Expander::get_latency_seconds() -> float {
   return this->latency_value;
 }
 
+void Expander::refreshMeters() {
+  meters.read();
+}
+
 float Expander::getReductionLevelLeft() const {
-  return reduction_left;
+  return meters.latest().reduction_left;
 }
 
 float Expander::getReductionLevelRight() const {
-  return reduction_right;
+  return meters.latest().reduction_right;
 }
 
 float Expander::getSideChainLevelLeft() const {
-  return sidechain_left;
+  return meters.latest().sidechain_left;
 }
 
 float Expander::getSideChainLevelRight() const {
-  return sidechain_right;
+  return meters.latest().sidechain_right;
 }
 
 float Expander::getCurveLevelLeft() const {
-  return curve_left;
+  return meters.latest().curve_left;
 }
 
 float Expander::getCurveLevelRight() const {
-  return curve_right;
+  return meters.latest().curve_right;
 }
 
 float Expander::getEnvelopeLevelLeft() const {
-  return envelope_left;
+  return meters.latest().envelope_left;
 }
 
 float Expander::getEnvelopeLevelRight() const {
-  return envelope_right;
+  return meters.latest().envelope_right;
 }
@@ -59,6 +59,8 @@ Filter::Filter(const std::string& tag, pw::Manager* pipe_manager, PipelineType p
 
   init_common_controls<DbFilter>(settings);
 
+  enable_lv2_extra_channels();
+
   // specific plugin controls
 
   BIND_LV2_PORT("f", frequency, setFrequency, DbFilter::frequencyChanged);
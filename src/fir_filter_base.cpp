@@ -53,6 +53,8 @@ FirFilterBase::~FirFilterBase() {
 }
 
 void FirFilterBase::free_zita() {
+  zita_ready = false;
+
   if (conv != nullptr) {
     conv->stop_process();
 
@@ -58,10 +58,26 @@ Gate::Gate(const std::string& tag, pw::Manager* pipe_manager, PipelineType pipe_
 
   if (!packageInstalled) {
     util::debug(std::format("{}{} is not installed", log_tag, lv2_plugin_uri));
+  } else {
+    meter_ports = {.latency = lv2_wrapper->get_control_port_index("out_latency"),
+                   .reduction_left = lv2_wrapper->get_control_port_index("rlm_l"),
+                   .reduction_right = lv2_wrapper->get_control_port_index("rlm_r"),
+                   .sidechain_left = lv2_wrapper->get_control_port_index("slm_l"),
+                   .sidechain_right = lv2_wrapper->get_control_port_index("slm_r"),
+                   .curve_left = lv2_wrapper->get_control_port_index("clm_l"),
+                   .curve_right = lv2_wrapper->get_control_port_index("clm_r"),
+                   .envelope_left = lv2_wrapper->get_control_port_index("elm_l"),
+                   .envelope_right = lv2_wrapper->get_control_port_index("elm_r"),
+                   .attack_zone_start = lv2_wrapper->get_control_port_index("gzs"),
+                   .attack_threshold = lv2_wrapper->get_control_port_index("gt"),
+                   .release_zone_start = lv2_wrapper->get_control_port_index("hts"),
+                   .release_threshold = lv2_wrapper->get_control_port_index("hzs")};
   }
 
   init_common_controls<DbGate>(settings);
 
+  enable_lv2_extra_channels();
+
   // specific plugin controls
 
   connect(settings, &DbGate::sidechainTypeChanged, [&]() { update_sidechain_links(); });
@@ -209,7 +225,7 @@ void Gate::process(std::span<float>& left_in,
 
   // This plugin gives the latency in number of samples
 
-  const auto lv = static_cast<uint>(lv2_wrapper->get_control_port_value("out_latency"));
+  const auto lv = static_cast<uint>(lv2_wrapper->get_control_port_value(meter_ports.latency));
 
   if (latency_n_frames != lv) {
     latency_n_frames = lv;
@@ -224,23 +240,20 @@ void Gate::process(std::span<float>& left_in,
   if (updateLevelMeters) {
     get_peaks(left_in, right_in, left_out, right_out);
 
-    reduction_left = util::linear_to_db(lv2_wrapper->get_control_port_value("rlm_l"));
-    reduction_right = util::linear_to_db(lv2_wrapper->get_control_port_value("rlm_r"));
-
-    sidechain_left = util::linear_to_db(lv2_wrapper->get_control_port_value("slm_l"));
-    sidechain_right = util::linear_to_db(lv2_wrapper->get_control_port_value("slm_r"));
-
-    curve_left = util::linear_to_db(lv2_wrapper->get_control_port_value("clm_l"));
-    curve_right = util::linear_to_db(lv2_wrapper->get_control_port_value("clm_r"));
-
-    envelope_left = util::linear_to_db(lv2_wrapper->get_control_port_value("elm_l"));
-    envelope_right = util::linear_to_db(lv2_wrapper->get_control_port_value("elm_r"));
-
-    attack_zone_start = util::linear_to_db(lv2_wrapper->get_control_port_value("gzs"));
-    attack_threshold = util::linear_to_db(lv2_wrapper->get_control_port_value("gt"));
-
-    release_zone_start = util::linear_to_db(lv2_wrapper->get_control_port_value("hts"));
-    release_threshold = util::linear_to_db(lv2_wrapper->get_control_port_value("hzs"));
+    auto db = [&](const uint& port) { return util::linear_to_db(lv2_wrapper->get_control_port_value(port)); };
+
+    meters.write({.reduction_left = db(meter_ports.reduction_left),
+                  .reduction_right = db(meter_ports.reduction_right),
+                  .sidechain_left = db(meter_ports.sidechain_left),
+                  .sidechain_right = db(meter_ports.sidechain_right),
+                  .curve_left = db(meter_ports.curve_left),
+                  .curve_right = db(meter_ports.curve_right),
+                  .envelope_left = db(meter_ports.envelope_left),
+                  .envelope_right = db(meter_ports.envelope_right),
+                  .attack_zone_start = db(meter_ports.attack_zone_start),
+                  .attack_threshold = db(meter_ports.attack_threshold),
+                  .release_zone_start = db(meter_ports.release_zone_start),
+                  .release_threshold = db(meter_ports.release_threshold)});
   }
 }
 
@@ -276,50 +289,54 @@ auto Gate::get_latency_seconds() -> float {
   return this->latency_value;
 }
 
+void Gate::refreshMeters() {
+  meters.read();
+}
+
 float Gate::getReductionLevelLeft() const {
-  return reduction_left;
+  return meters.latest().reduction_left;
 }
 
 float Gate::getReductionLevelRight() const {
-  return reduction_right;
+  return meters.latest().reduction_right;
 }
 
 float Gate::getSideChainLevelLeft() const {
-  return sidechain_left;
+  return meters.latest().sidechain_left;
 }
 
 float Gate::getSideChainLevelRight() const {
-  return sidechain_right;
+  return meters.latest().sidechain_right;
 }
 
 float Gate::getCurveLevelLeft() const {
-  return curve_left;
+  return meters.latest().curve_left;
 }
 
 float Gate::getCurveLevelRight() const {
-  return curve_right;
+  return meters.latest().curve_right;
 }
 
 float Gate::getEnvelopeLevelLeft() const {
-  return envelope_left;
+  return meters.latest().envelope_left;
 }
 
 float Gate::getEnvelopeLevelRight() const {
-  return envelope_right;
+  return meters.latest().envelope_right;
 }
 
 float Gate::getAttackZoneStart() const {
-  return attack_zone_start;
+  return meters.latest().attack_zone_start;
 }
 
 float Gate::getAttackThreshold() const {
-  return attack_threshold;
+  return meters.latest().attack_threshold;
 }
 
 float Gate::getReleaseZoneStart() const {
-  return release_zone_start;
+  return meters.latest().release_zone_start;
 }
 
 float Gate::getReleaseThreshold() const {
-  return release_threshold;
+  return meters.latest().release_threshold;
 }
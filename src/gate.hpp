@@ -31,6 +31,7 @@
 #include "pipeline_type.hpp"
 #include "plugin_base.hpp"
 #include "pw_manager.hpp"
+#include "triple_buffer.hpp"
 
 class Gate : public PluginBase {
   Q_OBJECT
@@ -67,6 +68,9 @@ class Gate : public PluginBase {
 
   void update_probe_links() override;
 
+  // Takes the newest meter snapshot. Every getter below returns values from it until the next call.
+  Q_INVOKABLE void refreshMeters();
+
   Q_INVOKABLE [[nodiscard]] float getReductionLevelLeft() const;
   Q_INVOKABLE [[nodiscard]] float getReductionLevelRight() const;
 
@@ -88,14 +92,31 @@ class Gate : public PluginBase {
  private:
   uint latency_n_frames = 0U;
 
-  float reduction_left = 0.0F, reduction_right = 0.0F;
-  float sidechain_left = 0.0F, sidechain_right = 0.0F;
-  float curve_left = 0.0F, curve_right = 0.0F;
-  float envelope_left = 0.0F, envelope_right = 0.0F;
-  float attack_zone_start = 0.0F;
-  float attack_threshold = 0.0F;
-  float release_zone_start = 0.0F;
-  float release_threshold = 0.0F;
+  struct Meters {
+    float reduction_left = 0.0F, reduction_right = 0.0F;
+    float sidechain_left = 0.0F, sidechain_right = 0.0F;
+    float curve_left = 0.0F, curve_right = 0.0F;
+    float envelope_left = 0.0F, envelope_right = 0.0F;
+    float attack_zone_start = 0.0F;
+    float attack_threshold = 0.0F;
+    float release_zone_start = 0.0F;
+    float release_threshold = 0.0F;
+  };
+
+  // Indices of the ports read on every cycle. They are resolved once so the realtime thread does no string work.
+  struct MeterPorts {
+    uint latency = 0U;
+    uint reduction_left = 0U, reduction_right = 0U;
+    uint sidechain_left = 0U, sidechain_right = 0U;
+    uint curve_left = 0U, curve_right = 0U;
+    uint envelope_left = 0U, envelope_right = 0U;
+    uint attack_zone_start = 0U;
+    uint attack_threshold = 0U;
+    uint release_zone_start = 0U;
+    uint release_threshold = 0U;
+  } meter_ports;
+
+  TripleBuffer<Meters> meters;
 
   bool ready = false;
 
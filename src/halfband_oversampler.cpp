@@ -0,0 +1,181 @@
+/**
+ * Copyright © 2017-2026 Wellington Wallace
+ *
+ * This file is part of Easy Effects.
+ *
+ * Easy Effects is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Easy Effects is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "halfband_oversampler.hpp"
+#include <sys/types.h>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <numbers>
+#include <numeric>
+#include <span>
+
+namespace {
+
+auto bessel_i0(const double& x) -> double {
+  double sum = 1.0;
+  double term = 1.0;
+
+  for (int k = 1; k < 64; k++) {
+    term *= (x / (2.0 * k)) * (x / (2.0 * k));
+
+    sum += term;
+
+    if (term < sum * 1e-12) {
+      break;
+    }
+  }
+
+  return sum;
+}
+
+}  // namespace
+
+HalfbandOversampler::HalfbandOversampler(const size_t& max_input_frames)
+    : max_frames(std::max<size_t>(max_input_frames, 1U)) {
+  /**
+   * Kaiser windowed sinc with the cutoff at a quarter of the oversampled rate.
+   * Only the taps at an odd distance from the center are computed, the others
+   * are zero apart from the 0.5 center tap.
+   */
+
+  constexpr double beta = 8.0;
+
+  constexpr auto length = (4U * half_taps) - 1U;
+  constexpr auto center = static_cast<double>(length - 1U) / 2.0;
+
+  const auto window_norm = bessel_i0(beta);
+
+  std::array<double, n_phase_taps> h{};
+
+  for (size_t i = 0U; i < n_phase_taps; i++) {
+    const auto x = static_cast<double>(2U * i) - center;
+
+    const auto sinc = std::sin(std::numbers::pi * x / 2.0) / (std::numbers::pi * x);
+
+    const auto r = x / center;
+
+    h[i] = sinc * bessel_i0(beta * std::sqrt(std::max(0.0, 1.0 - (r * r)))) / window_norm;
+  }
+
+  // The even phase has to sum to 0.5 for unity gain at DC.
+
+  const auto scale = 0.5 / std::accumulate(h.begin(), h.end(), 0.0);
+
+  for (size_t i = 0U; i < n_phase_taps; i++) {
+    phase_taps[n_phase_taps - 1U - i] = static_cast<float>(h[i] * scale);
+  }
+
+  for (auto& c : channels) {
+    c.up_history.resize(n_phase_taps - 1U + max_frames);
+    c.down_even.resize(n_phase_taps - 1U + max_frames);
+    c.down_odd.resize(half_taps + max_frames);
+  }
+
+  reset();
+}
+
+void HalfbandOversampler::reset() {
+  for (auto& c : channels) {
+    std::ranges::fill(c.up_history, 0.0F);
+    std::ranges::fill(c.down_even, 0.0F);
+    std::ranges::fill(c.down_odd, 0.0F);
+  }
+}
+
+void HalfbandOversampler::upsample(std::span<const float> left_in,
+                                   std::span<const float> right_in,
+                                   std::span<float> left_out,
+                                   std::span<float> right_out) {
+  upsample_channel(channels[0], left_in, left_out);
+  upsample_channel(channels[1], right_in, right_out);
+}
+
+void HalfbandOversampler::downsample(std::span<const float> left_in,
+                                     std::span<const float> right_in,
+                                     std::span<float> left_out,
+                                     std::span<float> right_out) {
+  downsample_channel(channels[0], left_in, left_out);
+  downsample_channel(channels[1], right_in, right_out);
+}
+
+void HalfbandOversampler::upsample_channel(Channel& c, std::span<const float> in, std::span<float> out) const {
+  constexpr auto history_length = n_phase_taps - 1U;
+
+  const auto n_frames = std::min(in.size(), out.size() / 2U);
+
+  for (size_t offset = 0U; offset < n_frames;) {
+    const auto count = std::min(n_frames - offset, max_frames);
+
+    std::copy_n(in.begin() + static_cast<long>(offset), count,
+                c.up_history.begin() + static_cast<long>(history_length));
+
+    for (size_t n = 0U; n < count; n++) {
+      const auto* x = c.up_history.data() + n;
+
+      float acc = 0.0F;
+
+      for (size_t k = 0U; k < n_phase_taps; k++) {
+        acc += x[k] * phase_taps[k];
+      }
+
+      // The interpolation filter gain of 2 is folded in here and in the pure delay of the odd phase.
+
+      out[2U * (offset + n)] = 2.0F * acc;
+      out[(2U * (offset + n)) + 1U] = x[half_taps];
+    }
+
+    std::copy_n(c.up_history.begin() + static_cast<long>(count), history_length, c.up_history.begin());
+
+    offset += count;
+  }
+}
+
+void HalfbandOversampler::downsample_channel(Channel& c, std::span<const float> in, std::span<float> out) const {
+  constexpr auto even_history = n_phase_taps - 1U;
+  constexpr auto odd_history = half_taps;
+
+  const auto n_frames = std::min(in.size() / 2U, out.size());
+
+  for (size_t offset = 0U; offset < n_frames;) {
+    const auto count = std::min(n_frames - offset, max_frames);
+
+    for (size_t n = 0U; n < count; n++) {
+      c.down_even[even_history + n] = in[2U * (offset + n)];
+      c.down_odd[odd_history + n] = in[(2U * (offset + n)) + 1U];
+    }
+
+    for (size_t n = 0U; n < count; n++) {
+      const auto* x = c.down_even.data() + n;
+
+      float acc = 0.0F;
+
+      for (size_t k = 0U; k < n_phase_taps; k++) {
+        acc += x[k] * phase_taps[k];
+      }
+
+      out[offset + n] = acc + (0.5F * c.down_odd[n]);
+    }
+
+    std::copy_n(c.down_even.begin() + static_cast<long>(count), even_history, c.down_even.begin());
+    std::copy_n(c.down_odd.begin() + static_cast<long>(count), odd_history, c.down_odd.begin());
+
+    offset += count;
+  }
+}
@@ -0,0 +1,79 @@
+/**
+ * Copyright © 2017-2026 Wellington Wallace
+ *
+ * This file is part of Easy Effects.
+ *
+ * Easy Effects is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Easy Effects is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <sys/types.h>
+#include <array>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+/**
+ * Stereo 2x oversampler built on a linear phase half-band FIR. Half of the
+ * half-band coefficients are zero and the center one is 0.5, so upsampling
+ * needs one short FIR for the even outputs while the odd outputs are a delay,
+ * and downsampling needs the same FIR over the even inputs plus a delayed
+ * odd input. The filter passes up to about 0.42 of the base rate and
+ * attenuates the images by roughly 80 dB.
+ */
+class HalfbandOversampler {
+ public:
+  explicit HalfbandOversampler(const size_t& max_input_frames);
+
+  // Nonzero taps on each side of the center of the half-band filter.
+  static constexpr size_t half_taps = 16U;
+
+  // Delay of an upsample followed by a downsample, in frames at the base rate.
+  static constexpr uint latency_frames = (2U * half_taps) - 1U;
+
+  void reset();
+
+  // The output spans hold twice as many frames as the input ones.
+  void upsample(std::span<const float> left_in,
+                std::span<const float> right_in,
+                std::span<float> left_out,
+                std::span<float> right_out);
+
+  // The input spans hold twice as many frames as the output ones.
+  void downsample(std::span<const float> left_in,
+                  std::span<const float> right_in,
+                  std::span<float> left_out,
+                  std::span<float> right_out);
+
+ private:
+  static constexpr size_t n_phase_taps = 2U * half_taps;
+
+  size_t max_frames = 0U;
+
+  // Coefficients of the even phase in reversed order, so the inner product walks the history forward.
+  std::array<float, n_phase_taps> phase_taps{};
+
+  struct Channel {
+    std::vector<float> up_history;    // n_phase_taps - 1 past input frames followed by the block
+    std::vector<float> down_even;     // n_phase_taps - 1 past even frames followed by the block
+    std::vector<float> down_odd;      // half_taps past odd frames followed by the block
+  };
+
+  std::array<Channel, 2U> channels;
+
+  void upsample_channel(Channel& c, std::span<const float> in, std::span<float> out) const;
+
+  void downsample_channel(Channel& c, std::span<const float> in, std::span<float> out) const;
+};
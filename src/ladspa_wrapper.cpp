@@ -22,42 +22,26 @@
 #include <ladspa.h>
 #include <sys/types.h>
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cmath>
 #include <cstdlib>
 #include <cstring>
 #include <format>
 #include <limits>
+#include <memory>
+#include <mutex>
 #include <span>
 #include <string>
 #include <tuple>
+#include <unordered_map>
 #include <utility>
 #include "config.h"
+#include "db_manager.hpp"
 #include "util.hpp"
 
 namespace {
 
-struct dlhandle {
-  dlhandle(void* handle) : dl_handle(handle) {}
-
-  ~dlhandle() {
-    if (dl_handle != nullptr) {
-      dlclose(dl_handle);
-    }
-  }
-
-  dlhandle(const dlhandle&) = delete;
-  auto operator=(const dlhandle&) -> dlhandle& = delete;
-  dlhandle(dlhandle&& other) noexcept : dl_handle(std::exchange(other.dl_handle, nullptr)) {}
-  auto operator=(dlhandle&& other) noexcept -> dlhandle& {
-    std::swap(dl_handle, other.dl_handle);
-    return *this;
-  }
-
-  void disable() { dl_handle = nullptr; }
-  void* dl_handle;
-};
-
 struct ladspahandle {
   ladspahandle(LADSPA_Handle instance, void (*cleanup)(LADSPA_Handle)) : instance(instance), cleanup(cleanup) {}
 
@@ -129,90 +113,212 @@ static inline bool validate_ports(const LADSPA_Descriptor* descriptor) {
   return true;
 }
 
-LadspaWrapper::LadspaWrapper(const std::string& plugin_filename, const std::string& plugin_label)
-    : plugin_name(plugin_label) {
-  const char* ladspa_path = get_ladspa_path();
-  const char* p = nullptr;
-
-  do {
-    p = std::strchr(ladspa_path, ':');
+/**
+ * Libraries opened by any LadspaWrapper are kept in a process-wide registry. Loading some of them is expensive
+ * (DeepFilterNet initializes its model when the library is opened), so a new instance of a plugin that was already
+ * found, or the same plugin added again after a preset switch, reuses the handle and the descriptor without walking
+ * LADSPA_PATH or calling the dynamic loader. A library that provided a descriptor stays open until the process
+ * exits, even while no plugin uses it. Libraries that were only probed are closed right after the search.
+ */
+struct LadspaLibrary {
+  LadspaLibrary(void* handle) : dl_handle(handle) {}
 
-    if (!p) {
-      p = std::strchr(ladspa_path, '\0');
+  ~LadspaLibrary() {
+    if (dl_handle != nullptr) {
+      dlclose(dl_handle);
     }
+  }
+
+  LadspaLibrary(const LadspaLibrary&) = delete;
+  auto operator=(const LadspaLibrary&) -> LadspaLibrary& = delete;
+  LadspaLibrary(const LadspaLibrary&&) = delete;
+  auto operator=(const LadspaLibrary&&) -> LadspaLibrary& = delete;
+
+  void* dl_handle = nullptr;
+};
+
+namespace {
+
+class Registry {
+ public:
+  struct Entry {
+    std::shared_ptr<LadspaLibrary> library;
 
-    std::string path(ladspa_path, p - ladspa_path);
+    const LADSPA_Descriptor* descriptor = nullptr;
+  };
+
+  static auto self() -> Registry& {
+    static Registry r;
+    return r;
+  }
 
-    if (*p == ':') {
-      p++;
+  auto find(const std::string& plugin_filename, const std::string& plugin_label) -> Entry {
+    std::scoped_lock<std::mutex> lock(mutex);
+
+    const auto key = plugin_filename + '\0' + plugin_label;
+
+    if (auto it = descriptors.find(key); it != descriptors.end()) {
+      util::debug(std::format("reusing the cached LADSPA descriptor {} from {}", plugin_label, plugin_filename));
+
+      return it->second;
     }
 
-    if (path.empty() || path[path.length() - 1] != '/') {
-      path.push_back('/');
+    remove_closed();
+
+    // Plugins that were not found are not cached. They may be installed while we are running.
+
+    auto entry = search(plugin_filename, plugin_label);
+
+    if (entry.descriptor != nullptr) {
+      descriptors.insert(std::make_pair(key, entry));
     }
 
-    path.append(plugin_filename);
+    return entry;
+  }
+
+ private:
+  std::mutex mutex;
+
+  // Key is the library path. Only libraries exporting ladspa_descriptor are kept.
+  std::unordered_map<std::string, std::weak_ptr<LadspaLibrary>> libraries;
+
+  // Key is the library filename and the plugin label separated by a null character. Holds the libraries open.
+  std::unordered_map<std::string, Entry> descriptors;
+
+  void remove_closed() {
+    std::erase_if(libraries, [](const auto& entry) { return entry.second.expired(); });
+  }
+
+  /**
+   * A library that does not have the label we are looking for is released by the caller right after the search, so
+   * probing LADSPA_PATH does not leave libraries open.
+   */
+  auto open(const std::string& path) -> std::shared_ptr<LadspaLibrary> {
+    if (auto it = libraries.find(path); it != libraries.end()) {
+      if (auto library = it->second.lock()) {
+        return library;
+      }
+    }
 
     void* dl_handle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
 
     if (dl_handle == nullptr) {
-      continue;
+      return nullptr;
     }
 
-    dlhandle h(dl_handle);
-
-    auto func = reinterpret_cast<LADSPA_Descriptor_Function>(dlsym(dl_handle, "ladspa_descriptor"));
+    auto library = std::make_shared<LadspaLibrary>(dl_handle);
 
-    if (func == nullptr) {
-      continue;
+    if (dlsym(dl_handle, "ladspa_descriptor") == nullptr) {
+      return nullptr;
     }
 
-    unsigned long i = 0UL;
+    libraries.insert_or_assign(path, library);
 
-    const LADSPA_Descriptor* descriptor = nullptr;
+    return library;
+  }
+
+  auto search(const std::string& plugin_filename, const std::string& plugin_label) -> Entry {
+    const char* ladspa_path = get_ladspa_path();
+    const char* p = nullptr;
 
     do {
-      descriptor = func(i);
-      if (descriptor == nullptr) {
-        break;
+      p = std::strchr(ladspa_path, ':');
+
+      if (!p) {
+        p = std::strchr(ladspa_path, '\0');
       }
 
-      if (std::strcmp(descriptor->Label, plugin_label.c_str()) == 0) {
-        break;
+      std::string path(ladspa_path, p - ladspa_path);
+
+      if (*p == ':') {
+        p++;
       }
-    } while (i++ < std::numeric_limits<unsigned long>::max());
 
-    if (descriptor != nullptr) {
-      if (descriptor->instantiate != nullptr && descriptor->connect_port != nullptr && descriptor->run != nullptr &&
-          validate_ports(descriptor)) {
-        unsigned long count = 0UL;
+      if (path.empty() || path[path.length() - 1] != '/') {
+        path.push_back('/');
+      }
 
-        for (unsigned long i = 0UL; i < descriptor->PortCount; i++) {
-          if (LADSPA_IS_PORT_CONTROL(descriptor->PortDescriptors[i])) {
-            count++;
-          }
-        }
+      path.append(plugin_filename);
 
-        auto* control_ports = new LADSPA_Data[count]();
-        auto* control_ports_initialized = new bool[count]();
+      auto library = open(path);
 
-        h.disable();
+      if (library == nullptr) {
+        continue;
+      }
 
-        this->dl_handle = dl_handle;
-        this->descriptor = descriptor;
-        this->found = true;
-        this->control_ports = control_ports;
-        this->control_ports_initialized = control_ports_initialized;
+      auto func = reinterpret_cast<LADSPA_Descriptor_Function>(dlsym(library->dl_handle, "ladspa_descriptor"));
 
-        for (unsigned long i = 0UL, j = 0UL; i < descriptor->PortCount; i++) {
-          if (LADSPA_IS_PORT_CONTROL(descriptor->PortDescriptors[i])) {
-            map_cp_name_to_idx.insert(std::make_pair(descriptor->PortNames[i], j++));
-          }
+      unsigned long i = 0UL;
+
+      const LADSPA_Descriptor* descriptor = nullptr;
+
+      do {
+        descriptor = func(i);
+        if (descriptor == nullptr) {
+          break;
         }
+
+        if (std::strcmp(descriptor->Label, plugin_label.c_str()) == 0) {
+          break;
+        }
+      } while (i++ < std::numeric_limits<unsigned long>::max());
+
+      if (descriptor != nullptr) {
+        if (descriptor->instantiate != nullptr && descriptor->connect_port != nullptr && descriptor->run != nullptr &&
+            validate_ports(descriptor)) {
+          return {.library = library, .descriptor = descriptor};
+        }
+
+        break;
       }
-      break;
+    } while (*(ladspa_path = p) != '\0');
+
+    return {};
+  }
+};
+
+}  // namespace
+
+LadspaWrapper::LadspaWrapper(const std::string& plugin_filename, const std::string& plugin_label)
+    : plugin_name(plugin_label) {
+  auto entry = Registry::self().find(plugin_filename, plugin_label);
+
+  if (entry.descriptor == nullptr) {
+    return;
+  }
+
+  const auto* descriptor = entry.descriptor;
+
+  unsigned long count = 0UL;
+
+  for (unsigned long i = 0UL; i < descriptor->PortCount; i++) {
+    if (LADSPA_IS_PORT_CONTROL(descriptor->PortDescriptors[i])) {
+      count++;
+    }
+  }
+
+  this->library = entry.library;
+  this->descriptor = descriptor;
+  this->found = true;
+  this->control_ports = new LADSPA_Data[count]();
+  this->control_ports_initialized = new bool[count]();
+
+  control_targets = std::vector<std::atomic<LADSPA_Data>>(count);
+  control_dirty = std::vector<std::atomic<bool>>(count);
+  control_smooth.resize(count);
+  ramp_start.resize(count);
+  ramp_ports.reserve(count);
+
+  for (unsigned long i = 0UL, j = 0UL; i < descriptor->PortCount; i++) {
+    if (LADSPA_IS_PORT_CONTROL(descriptor->PortDescriptors[i])) {
+      const auto hint = descriptor->PortRangeHints[i].HintDescriptor;
+
+      control_smooth[j] = LADSPA_IS_PORT_INPUT(descriptor->PortDescriptors[i]) && !LADSPA_IS_HINT_TOGGLED(hint) &&
+                          !LADSPA_IS_HINT_INTEGER(hint);
+
+      map_cp_name_to_idx.insert(std::make_pair(descriptor->PortNames[i], j++));
     }
-  } while (*(ladspa_path = p) != '\0');
+  }
 }
 
 LadspaWrapper::~LadspaWrapper() {
@@ -358,6 +464,16 @@ auto LadspaWrapper::create_instance(uint rate) -> bool {
 
   ladspahandle h(new_instance, descriptor->cleanup);
 
+  // The realtime thread does not call run() while an instance is being created. So pending values can be applied.
+
+  has_pending_controls.store(false, std::memory_order_relaxed);
+
+  for (uint j = 0U; j < control_dirty.size(); j++) {
+    if (control_dirty[j].exchange(false, std::memory_order_relaxed)) {
+      control_ports[j] = control_targets[j].load(std::memory_order_relaxed);
+    }
+  }
+
   scale_control_ports(descriptor, control_ports, control_ports_initialized, this->rate, rate);
 
   for (unsigned long i = 0UL, j = 0UL; i < descriptor->PortCount; i++) {
@@ -379,6 +495,10 @@ auto LadspaWrapper::create_instance(uint rate) -> bool {
   this->instance = new_instance;
   this->rate = rate;
 
+  for (uint j = 0U; j < control_targets.size(); j++) {
+    control_targets[j].store(control_ports[j], std::memory_order_relaxed);
+  }
+
   activate();
 
   return true;
@@ -394,10 +514,6 @@ void LadspaWrapper::destroy_instance() {
   if (instance != nullptr && descriptor->cleanup != nullptr) {
     descriptor->cleanup(instance);
   }
-
-  if (dl_handle != nullptr) {
-    dlclose(std::exchange(dl_handle, nullptr));
-  }
 }
 
 static inline int stricmp(const char* str1, const char* str2) {
@@ -439,6 +555,8 @@ void LadspaWrapper::connect_data_ports(const std::span<const float>& left_in,
     return;
   }
 
+  n_audio_buffers = 0U;
+
   unsigned long left_in_idx = -1L;
   unsigned long right_in_idx = -1L;
   unsigned long first_in_idx = -1L;
@@ -490,11 +608,11 @@ void LadspaWrapper::connect_data_ports(const std::span<const float>& left_in,
     right_in_idx = second_in_idx;
   }
   if (left_in_idx != null_ul) {
-    descriptor->connect_port(instance, left_in_idx, const_cast<LADSPA_Data*>(left_in.data()));
+    connect_audio_buffer(left_in_idx, const_cast<LADSPA_Data*>(left_in.data()));
   }
 
   if (right_in_idx != null_ul) {
-    descriptor->connect_port(instance, right_in_idx, const_cast<LADSPA_Data*>(right_in.data()));
+    connect_audio_buffer(right_in_idx, const_cast<LADSPA_Data*>(right_in.data()));
   }
 
   if (left_out_idx == null_ul || right_out_idx == null_ul) {
@@ -502,11 +620,11 @@ void LadspaWrapper::connect_data_ports(const std::span<const float>& left_in,
     right_out_idx = second_out_idx;
   }
   if (left_out_idx != null_ul) {
-    descriptor->connect_port(instance, left_out_idx, left_out.data());
+    connect_audio_buffer(left_out_idx, left_out.data());
   }
 
   if (right_out_idx != null_ul) {
-    descriptor->connect_port(instance, right_out_idx, right_out.data());
+    connect_audio_buffer(right_out_idx, right_out.data());
   }
 }
 
@@ -535,6 +653,8 @@ void LadspaWrapper::connect_data_ports(const std::span<const float>& left_in,
     return;
   }
 
+  n_audio_buffers = 0U;
+
   unsigned long left_in_idx = -1L;
   unsigned long right_in_idx = -1L;
   unsigned long first_in_idx = -1L;
@@ -604,11 +724,11 @@ void LadspaWrapper::connect_data_ports(const std::span<const float>& left_in,
     right_in_idx = second_in_idx;
   }
   if (left_in_idx != null_ul) {
-    descriptor->connect_port(instance, left_in_idx, const_cast<LADSPA_Data*>(left_in.data()));
+    connect_audio_buffer(left_in_idx, const_cast<LADSPA_Data*>(left_in.data()));
   }
 
   if (right_in_idx != null_ul) {
-    descriptor->connect_port(instance, right_in_idx, const_cast<LADSPA_Data*>(right_in.data()));
+    connect_audio_buffer(right_in_idx, const_cast<LADSPA_Data*>(right_in.data()));
   }
 
   if (probe_left_idx == null_ul || probe_right_idx == null_ul) {
@@ -644,11 +764,11 @@ void LadspaWrapper::connect_data_ports(const std::span<const float>& left_in,
     }
   }
   if (probe_left_idx != null_ul) {
-    descriptor->connect_port(instance, probe_left_idx, const_cast<LADSPA_Data*>(probe_left.data()));
+    connect_audio_buffer(probe_left_idx, const_cast<LADSPA_Data*>(probe_left.data()));
   }
 
   if (probe_right_idx != null_ul) {
-    descriptor->connect_port(instance, probe_right_idx, const_cast<LADSPA_Data*>(probe_right.data()));
+    connect_audio_buffer(probe_right_idx, const_cast<LADSPA_Data*>(probe_right.data()));
   }
 
   if (left_out_idx == null_ul || right_out_idx == null_ul) {
@@ -656,11 +776,11 @@ void LadspaWrapper::connect_data_ports(const std::span<const float>& left_in,
     right_out_idx = second_out_idx;
   }
   if (left_out_idx != null_ul) {
-    descriptor->connect_port(instance, left_out_idx, left_out.data());
+    connect_audio_buffer(left_out_idx, left_out.data());
   }
 
   if (right_out_idx != null_ul) {
-    descriptor->connect_port(instance, right_out_idx, right_out.data());
+    connect_audio_buffer(right_out_idx, right_out.data());
   }
 }
 
@@ -680,11 +800,82 @@ void LadspaWrapper::deactivate() {
   active = false;
 }
 
-void LadspaWrapper::run() const {
+void LadspaWrapper::connect_audio_buffer(unsigned long port, LADSPA_Data* data) {
+  descriptor->connect_port(instance, port, data);
+
+  if (n_audio_buffers < audio_buffers.size()) {
+    audio_buffers[n_audio_buffers++] = std::make_pair(port, data);
+  }
+}
+
+void LadspaWrapper::run() {
   assert(active);
   assert(instance);
 
-  descriptor->run(instance, n_samples);
+  const bool ramp = DbMain::smoothControlPorts() && n_samples >= 2U * ramp_block;
+
+  if (!apply_pending_control_values(ramp)) {
+    descriptor->run(instance, n_samples);
+
+    return;
+  }
+
+  // Smoothed controls changed. Their values are interpolated across sub-blocks of ramp_block samples.
+
+  const uint n_blocks = n_samples / ramp_block;
+
+  for (uint b = 0U; b < n_blocks; b++) {
+    const uint offset = b * ramp_block;
+    const uint count = (b == n_blocks - 1U) ? n_samples - offset : ramp_block;
+    const LADSPA_Data t = static_cast<LADSPA_Data>(b + 1U) / static_cast<LADSPA_Data>(n_blocks);
+
+    for (const auto& j : ramp_ports) {
+      const auto target = control_targets[j].load(std::memory_order_relaxed);
+
+      control_ports[j] = ramp_start[j] + (t * (target - ramp_start[j]));
+    }
+
+    for (uint n = 0U; n < n_audio_buffers; n++) {
+      descriptor->connect_port(instance, audio_buffers[n].first, audio_buffers[n].second + offset);
+    }
+
+    descriptor->run(instance, count);
+  }
+
+  for (const auto& j : ramp_ports) {
+    control_ports[j] = control_targets[j].load(std::memory_order_relaxed);
+  }
+
+  for (uint n = 0U; n < n_audio_buffers; n++) {
+    descriptor->connect_port(instance, audio_buffers[n].first, audio_buffers[n].second);
+  }
+}
+
+auto LadspaWrapper::apply_pending_control_values(bool ramp) -> bool {
+  ramp_ports.clear();
+
+  if (!has_pending_controls.exchange(false, std::memory_order_acquire)) {
+    return false;
+  }
+
+  for (uint j = 0U; j < control_dirty.size(); j++) {
+    if (!control_dirty[j].exchange(false, std::memory_order_acquire)) {
+      continue;
+    }
+
+    const auto target = control_targets[j].load(std::memory_order_relaxed);
+
+    if (ramp && control_smooth[j] && target != control_ports[j] && std::isfinite(target) &&
+        std::isfinite(control_ports[j])) {
+      ramp_start[j] = control_ports[j];
+
+      ramp_ports.push_back(j);
+    } else {
+      control_ports[j] = target;
+    }
+  }
+
+  return !ramp_ports.empty();
 }
 
 auto LadspaWrapper::get_control_port_count() const -> uint {
@@ -760,6 +951,10 @@ auto LadspaWrapper::get_control_port_value(uint index) const -> float {
   assert(cp_to_port_idx(descriptor, index) != null_ul);
   assert(control_ports_initialized[index]);
 
+  if (instance != nullptr && !is_control_port_output(index)) {
+    return control_targets[index].load(std::memory_order_relaxed);
+  }
+
   return control_ports[index];
 }
 
@@ -783,7 +978,16 @@ auto LadspaWrapper::set_control_port_value_clamp(uint index, float value) -> flo
   // If the value is out of bounds, get a new clamped one in LADSPA_Data (float)
   value = clamp_port_value(descriptor, i, rate, value);
 
-  control_ports[index] = value;
+  control_targets[index].store(value, std::memory_order_relaxed);
+
+  if (instance == nullptr) {
+    control_ports[index] = value;
+  } else {
+    control_dirty[index].store(true, std::memory_order_release);
+
+    has_pending_controls.store(true, std::memory_order_release);
+  }
+
   control_ports_initialized[index] = true;
 
   return value;
@@ -22,15 +22,22 @@
 #include <dlfcn.h>
 #include <ladspa.h>
 #include <sys/types.h>
+#include <array>
+#include <atomic>
+#include <memory>
 #include <span>
 #include <string>
 #include <tuple>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace ladspa {
 
 using namespace std::string_literals;
 
+struct LadspaLibrary;
+
 class LadspaWrapper {
  public:
   LadspaWrapper(const std::string& plugin_filename, const std::string& plugin_label);
@@ -58,7 +65,7 @@ class LadspaWrapper {
   void activate();
   void deactivate();
 
-  void run() const;
+  void run();
 
   [[nodiscard]] auto get_control_port_count() const -> uint;
   [[nodiscard]] auto get_control_port_name(uint index) const -> std::string;
@@ -77,10 +84,13 @@ class LadspaWrapper {
 
   uint n_samples = 0U;
 
+  // Sub-block length used when smoothed control values are being ramped
+  static constexpr uint ramp_block = 32U;
+
  private:
   std::string plugin_name;
 
-  void* dl_handle = nullptr;
+  std::shared_ptr<LadspaLibrary> library;
 
   const LADSPA_Descriptor* descriptor = nullptr;
 
@@ -97,6 +107,31 @@ class LadspaWrapper {
   bool* control_ports_initialized = nullptr;
 
   std::unordered_map<std::string, unsigned long> map_cp_name_to_idx;
+
+  /**
+   * Control values set while an instance exists are not written directly to control_ports because the plugin reads
+   * them while run() is executing. The realtime thread copies them at the beginning of the next block.
+   */
+  std::vector<std::atomic<LADSPA_Data>> control_targets;
+
+  std::vector<std::atomic<bool>> control_dirty;
+
+  std::atomic<bool> has_pending_controls = false;
+
+  std::vector<bool> control_smooth;
+
+  std::vector<LADSPA_Data> ramp_start;
+
+  std::vector<uint> ramp_ports;
+
+  // Audio buffers given in the last call to connect_data_ports
+  std::array<std::pair<unsigned long, LADSPA_Data*>, 6> audio_buffers{};
+
+  uint n_audio_buffers = 0U;
+
+  void connect_audio_buffer(unsigned long port, LADSPA_Data* data);
+
+  auto apply_pending_control_values(bool ramp) -> bool;
 };
 
 }  // namespace ladspa
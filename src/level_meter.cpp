@@ -27,6 +27,7 @@
 #include <mutex>
 #include <span>
 #include <string>
+#include "channel_layout.hpp"
 #include "db_manager.hpp"
 #include "easyeffects_db_level_meter.h"
 #include "pipeline_type.hpp"
@@ -87,11 +88,19 @@ auto LevelMeter::init_ebur128() -> bool {
     ebur_state = nullptr;
   }
 
+  const auto& positions = channel_layout::positions();
+
   ebur_state = ebur128_init(
-      2U, rate, EBUR128_MODE_S | EBUR128_MODE_I | EBUR128_MODE_LRA | EBUR128_MODE_TRUE_PEAK | EBUR128_MODE_HISTOGRAM);
+      static_cast<uint>(positions.size()), rate,
+      EBUR128_MODE_S | EBUR128_MODE_I | EBUR128_MODE_LRA | EBUR128_MODE_TRUE_PEAK | EBUR128_MODE_HISTOGRAM);
 
-  ebur128_set_channel(ebur_state, 0U, EBUR128_LEFT);
-  ebur128_set_channel(ebur_state, 1U, EBUR128_RIGHT);
+  if (ebur_state == nullptr) {
+    return false;
+  }
+
+  for (uint n = 0U; n < positions.size(); n++) {
+    ebur128_set_channel(ebur_state, n, channel_layout::ebur128_channel(positions[n]));
+  }
 
   return ebur_state != nullptr;
 }
@@ -114,8 +123,8 @@ void LevelMeter::setup() {
           return;
         }
 
-        if (2U * static_cast<size_t>(n_samples) != data.size()) {
-          data.resize(static_cast<size_t>(n_samples) * 2U);
+        if (channel_layout::n_channels() * static_cast<size_t>(n_samples) != data.size()) {
+          data.resize(static_cast<size_t>(n_samples) * channel_layout::n_channels());
         }
 
         auto status = init_ebur128();
@@ -141,17 +150,27 @@ void LevelMeter::process(std::span<float>& left_in,
     return;
   }
 
+  const auto n_channels = 2U + extra_in.size();
+
   {
     const float* __restrict__ l = left_in.data();
     const float* __restrict__ r = right_in.data();
     float* __restrict__ d = data.data();
 
     for (size_t i = 0; i < n_samples; ++i) {
-      const size_t idx = i * 2;
+      const size_t idx = i * n_channels;
 
       d[idx] = l[i];
       d[idx + 1] = r[i];
     }
+
+    for (size_t n = 0U; n < extra_in.size(); n++) {
+      const float* __restrict__ e = extra_in[n].data();
+
+      for (size_t i = 0; i < n_samples; ++i) {
+        d[(i * n_channels) + 2U + n] = e[i];
+      }
+    }
   }
 
   ebur128_add_frames_float(ebur_state, data.data(), n_samples);
@@ -184,6 +203,23 @@ void LevelMeter::process(std::span<float>& left_in,
     true_peak_R = 0.0;
   }
 
+  // The extra channels count on the side they are downmixed to.
+
+  const auto& positions = channel_layout::positions();
+
+  for (uint n = 2U; n < n_channels; n++) {
+    double peak = 0.0;
+
+    if (EBUR128_SUCCESS != ebur128_true_peak(ebur_state, n, &peak)) {
+      continue;
+    }
+
+    const auto [gain_left, gain_right] = channel_layout::downmix_gains(positions[n]);
+
+    true_peak_L = gain_left > 0.0F ? std::max(true_peak_L, peak) : true_peak_L;
+    true_peak_R = gain_right > 0.0F ? std::max(true_peak_R, peak) : true_peak_R;
+  }
+
   true_peak_L = util::linear_to_db(true_peak_L);
   true_peak_R = util::linear_to_db(true_peak_R);
 
@@ -57,10 +57,18 @@ Limiter::Limiter(const std::string& tag, pw::Manager* pipe_manager, PipelineType
 
   if (!packageInstalled) {
     util::debug(std::format("{}{} is not installed", log_tag, lv2_plugin_uri));
+  } else {
+    meter_ports = {.latency = lv2_wrapper->get_control_port_index("out_latency"),
+                   .gain_left = lv2_wrapper->get_control_port_index("grlm_l"),
+                   .gain_right = lv2_wrapper->get_control_port_index("grlm_r"),
+                   .sidechain_left = lv2_wrapper->get_control_port_index("sclm_l"),
+                   .sidechain_right = lv2_wrapper->get_control_port_index("sclm_r")};
   }
 
   init_common_controls<DbLimiter>(settings);
 
+  enable_lv2_extra_channels();
+
   // specific plugin controls
 
   connect(settings, &DbLimiter::sidechainTypeChanged, [&]() { update_sidechain_links(); });
@@ -200,7 +208,7 @@ void Limiter::process(std::span<float>& left_in,
 
   // This plugin gives the latency in number of samples
 
-  const auto lv = static_cast<uint>(lv2_wrapper->get_control_port_value("out_latency"));
+  const auto lv = static_cast<uint>(lv2_wrapper->get_control_port_value(meter_ports.latency));
 
   if (latency_n_frames != lv) {
     latency_n_frames = lv;
@@ -215,10 +223,12 @@ void Limiter::process(std::span<float>& left_in,
   if (updateLevelMeters) {
     get_peaks(left_in, right_in, left_out, right_out);
 
-    gain_l_port_value = util::linear_to_db(lv2_wrapper->get_control_port_value("grlm_l"));
-    gain_r_port_value = util::linear_to_db(lv2_wrapper->get_control_port_value("grlm_r"));
-    sidechain_l_port_value = util::linear_to_db(lv2_wrapper->get_control_port_value("sclm_l"));
-    sidechain_r_port_value = util::linear_to_db(lv2_wrapper->get_control_port_value("sclm_r"));
+    auto db = [&](const uint& port) { return util::linear_to_db(lv2_wrapper->get_control_port_value(port)); };
+
+    meters.write({.gain_left = db(meter_ports.gain_left),
+                  .gain_right = db(meter_ports.gain_right),
+                  .sidechain_left = db(meter_ports.sidechain_left),
+                  .sidechain_right = db(meter_ports.sidechain_right)});
   }
 }
 
@@ -254,18 +264,22 @@ auto Limiter::get_latency_seconds() -> float {
   return this->latency_value;
 }
 
+void Limiter::refreshMeters() {
+  meters.read();
+}
+
 float Limiter::getGainLevelLeft() const {
-  return this->gain_l_port_value;
+  return meters.latest().gain_left;
 }
 
 float Limiter::getGainLevelRight() const {
-  return this->gain_r_port_value;
+  return meters.latest().gain_right;
 }
 
 float Limiter::getSideChainLevelLeft() const {
-  return this->sidechain_l_port_value;
+  return meters.latest().sidechain_left;
 }
 
 float Limiter::getSideChainLevelRight() const {
-  return this->sidechain_r_port_value;
+  return meters.latest().sidechain_right;
 }
@@ -31,6 +31,7 @@
 #include "pipeline_type.hpp"
 #include "plugin_base.hpp"
 #include "pw_manager.hpp"
+#include "triple_buffer.hpp"
 
 class Limiter : public PluginBase {
   Q_OBJECT
@@ -67,6 +68,9 @@ class Limiter : public PluginBase {
 
   auto get_latency_seconds() -> float override;
 
+  // Takes the newest meter snapshot. Every getter below returns values from it until the next call.
+  Q_INVOKABLE void refreshMeters();
+
   Q_INVOKABLE [[nodiscard]] float getGainLevelLeft() const;
   Q_INVOKABLE [[nodiscard]] float getGainLevelRight() const;
   Q_INVOKABLE [[nodiscard]] float getSideChainLevelLeft() const;
@@ -75,10 +79,19 @@ class Limiter : public PluginBase {
  private:
   uint latency_n_frames = 0U;
 
-  float gain_l_port_value = 0.0F;
-  float gain_r_port_value = 0.0F;
-  float sidechain_l_port_value = 0.0F;
-  float sidechain_r_port_value = 0.0F;
+  struct Meters {
+    float gain_left = 0.0F, gain_right = 0.0F;
+    float sidechain_left = 0.0F, sidechain_right = 0.0F;
+  };
+
+  // Indices of the ports read on every cycle. They are resolved once so the realtime thread does no string work.
+  struct MeterPorts {
+    uint latency = 0U;
+    uint gain_left = 0U, gain_right = 0U;
+    uint sidechain_left = 0U, sidechain_right = 0U;
+  } meter_ports;
+
+  TripleBuffer<Meters> meters;
 
   bool ready = false;
 
@@ -24,6 +24,7 @@
 #include <filesystem>
 #include <format>
 #include <memory>
+#include <nlohmann/json.hpp>
 #include <string>
 #include "pipeline_type.hpp"
 #include "tags_local_server.hpp"
@@ -42,9 +43,23 @@ LocalClient::LocalClient(QObject* parent) : QObject(parent), client(std::make_un
   }
 }
 
-void LocalClient::show_window() {
-  client->write(tags::local_server::show_window);
+auto LocalClient::show_window() -> std::string {
+  // Sent as a version 2 request so that a daemon, which has no window, can say so.
+
+  client->write(tags::local_server::show_window_v2);
   client->flush();
+
+  if (!client->waitForReadyRead(500)) {
+    return "";
+  }
+
+  const auto reply = nlohmann::json::parse(client->readLine().toStdString(), nullptr, false);
+
+  if (reply.is_discarded() || !reply.is_object() || reply.value("status", "") != "error") {
+    return "";
+  }
+
+  return reply.value("error", "");
 }
 
 void LocalClient::hide_window() {
@@ -84,7 +99,7 @@ auto LocalClient::getGlobalBypass() -> QString {
 }
 
 void LocalClient::toggleGlobalBypass() {
-  client->write(tags::local_server::toggle_global_bypass);
+  client->write(std::format("{}\n", tags::local_server::toggle_global_bypass).c_str());
   client->flush();
 }
 
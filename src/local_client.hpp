@@ -32,7 +32,8 @@ class LocalClient : public QObject {
  public:
   explicit LocalClient(QObject* parent = nullptr);
 
-  void show_window();
+  // Returns the error of the instance that was asked, or an empty string if it is showing its window.
+  auto show_window() -> std::string;
   void hide_window();
   void quit_app();
 
@@ -24,19 +24,31 @@
 #include <qtmetamacros.h>
 #include <QLocalServer>
 #include <QMetaType>
+#include <QSignalBlocker>
+#include <QTimer>
+#include <algorithm>
 #include <cstring>
 #include <filesystem>
 #include <format>
+#include <limits>
 #include <memory>
+#include <nlohmann/json.hpp>
+#include <optional>
 #include <regex>
 #include <string>
+#include <utility>
+#include <vector>
 #include "db_manager.hpp"
+#include "effects_base.hpp"
+#include "local_telemetry.hpp"
+#include "measurement.hpp"
 #include "pipeline_type.hpp"
 #include "presets_manager.hpp"
 #include "tags_local_server.hpp"
 #include "util.hpp"
 
-LocalServer::LocalServer(QObject* parent) : QObject(parent), server(std::make_unique<QLocalServer>(this)) {
+LocalServer::LocalServer(QObject* parent)
+    : QObject(parent), server(std::make_unique<QLocalServer>(this)), telemetry(new LocalTelemetry(this)) {
   connect(server.get(), &QLocalServer::newConnection, [&]() {
     auto* newSocket = server->nextPendingConnection();
 
@@ -67,6 +79,26 @@ void LocalServer::startServer() {
   }
 }
 
+void LocalServer::set_pipelines(EffectsBase* input, EffectsBase* output) {
+  telemetry->set_pipelines(input, output);
+}
+
+void LocalServer::set_windowless(const bool& state) {
+  windowless = state;
+}
+
+void LocalServer::set_measurement(Measurement* measurement) {
+  if (this->measurement != nullptr) {
+    disconnect(this->measurement, nullptr, this, nullptr);
+  }
+
+  this->measurement = measurement;
+
+  if (measurement != nullptr) {
+    connect(measurement, &Measurement::finished, this, &LocalServer::on_measurement_finished);
+  }
+}
+
 auto LocalServer::pipeline_from(const std::string& str) -> PipelineType {
   if (str == "input") {
     return PipelineType::input;
@@ -85,129 +117,167 @@ void LocalServer::onReadyRead() {
     return;
   }
 
-  while (!socket->atEnd()) {
-    char buf[1024];
+  bool too_long = false;
+
+  while (socket->canReadLine()) {
+    const auto line = socket->readLine(max_line_length);
 
-    auto lineLength = socket->readLine(buf, sizeof(buf));
+    if (!line.endsWith('\n')) {
+      too_long = true;
 
-    if (lineLength == -1) {
-      continue;
+      break;
     }
 
-    if (std::strcmp(buf, tags::local_server::quit_app) == 0) {
-      Q_EMIT onQuitApp();
-    } else if (std::strcmp(buf, tags::local_server::show_window) == 0) {
-      Q_EMIT onShowWindow();
-    } else if (std::strcmp(buf, tags::local_server::hide_window) == 0) {
-      Q_EMIT onHideWindow();
-    } else if (std::strncmp(buf, tags::local_server::global_bypass, strlen(tags::local_server::global_bypass)) == 0) {
-      std::string msg = buf;
+    if (line.startsWith('{')) {
+      process_v2(socket, line);
+    } else {
+      process_v1(socket, line.toStdString());
+    }
+  }
 
-      std::smatch matches;
+  if (too_long || (!socket->canReadLine() && socket->bytesAvailable() >= max_line_length)) {
+    util::warning(std::format("LocalServer: request longer than {} bytes, closing the connection", max_line_length));
 
-      static const auto re = std::regex("^global_bypass:([01])\n$");
+    socket->abort();
 
-      std::regex_search(msg, matches, re);
+    return;
+  }
 
-      if (matches.size() == 2U) {
-        int state = 0;
+  if (socket->bytesAvailable() > 0) {
+    QTimer::singleShot(partial_line_timeout_ms, socket, [this, socket]() { process_partial_line(socket, false); });
+  }
 
-        util::str_to_num(std::string(matches[1]), state);
+  socket->flush();
+}
 
-        DbMain::setBypass(state != 0);
-      }
-    } else if (std::strncmp(buf, tags::local_server::load_preset, strlen(tags::local_server::load_preset)) == 0) {
-      std::string msg = buf;
+void LocalServer::process_partial_line(QLocalSocket* socket, const bool& disconnected) {
+  if (socket->bytesAvailable() == 0 || socket->canReadLine()) {
+    return;
+  }
 
-      std::smatch matches;
+  // A v2 request may still be arriving. It is only taken unterminated when nothing more can come.
+
+  if (socket->peek(1).startsWith('{')) {
+    if (disconnected) {
+      process_v2(socket, socket->readAll());
+    }
 
-      static const auto re = std::regex("^load_preset:(input|output):([^\n]{1,100})\n$");
+    return;
+  }
 
-      std::regex_search(msg, matches, re);
+  process_v1(socket, socket->readAll().toStdString());
 
-      if (matches.size() == 3U) {
-        auto pipeline_type = pipeline_from(matches[1].str());
+  socket->flush();
+}
 
-        std::string preset_name = matches[2];
+void LocalServer::process_v1(QLocalSocket* socket, const std::string& msg) {
+  const auto* buf = msg.c_str();
 
-        presets::Manager::self().loadLocalPresetFile(pipeline_type, QString::fromStdString(preset_name));
-      }
-    } else if (std::strncmp(buf, tags::local_server::set_property, strlen(tags::local_server::set_property)) == 0) {
-      std::string msg = buf;
-
-      std::smatch matches;
-
-      /**
-       * Original regex:
-       * ^set_property:(input|output):([^:]+):([0-9]+):([^:]+):(.+)\n$
-       *
-       * Since the dot matches any character except line terminators, there's
-       * no need to search for final new line and end of line position.
-       */
-      static const auto re = std::regex("^set_property:(input|output):([^:]+):([0-9]+):([^:]+):([^\n]+)");
-
-      std::regex_search(msg, matches, re);
-
-      if (matches.size() == 6U) {
-        const auto& pipeline = matches[1].str();
-        const auto& plugin_name = matches[2].str();
-        const auto& instance_id = matches[3].str();
-        const auto& property = matches[4].str();
-        const auto& value = matches[5].str();
-
-        set_property(pipeline, plugin_name, instance_id, property, value);
-      }
-    } else if (std::strncmp(buf, tags::local_server::get_property, strlen(tags::local_server::get_property)) == 0) {
-      /**
-       * Example of client write that should be done:
-       * client->write(std::format("{}:output:loudness:0:volume\n", tags::local_server::get_property).c_str());
-       */
+  if (std::strcmp(buf, tags::local_server::quit_app) == 0) {
+    Q_EMIT onQuitApp();
+  } else if (std::strcmp(buf, tags::local_server::show_window) == 0) {
+    if (windowless) {
+      util::warning(std::format("LocalServer: {}", tags::local_server::no_window_error));
+    } else {
+      Q_EMIT onShowWindow();
+    }
+  } else if (std::strcmp(buf, tags::local_server::hide_window) == 0) {
+    Q_EMIT onHideWindow();
+  } else if (std::strncmp(buf, tags::local_server::global_bypass, strlen(tags::local_server::global_bypass)) == 0) {
+    std::smatch matches;
 
-      std::string msg = buf;
+    static const auto re = std::regex("^global_bypass:([01])\n$");
 
-      std::smatch matches;
+    std::regex_search(msg, matches, re);
 
-      static const auto re = std::regex("^get_property:(input|output):([^:]+):([0-9]+):([^\n]+)");
+    if (matches.size() == 2U) {
+      int state = 0;
 
-      std::regex_search(msg, matches, re);
+      util::str_to_num(std::string(matches[1]), state);
 
-      if (matches.size() == 5U) {
-        const auto& pipeline = matches[1].str();
-        const auto& plugin_name = matches[2].str();
-        const auto& instance_id = matches[3].str();
-        const auto& property = matches[4].str();
+      DbMain::setBypass(state != 0);
+    }
+  } else if (std::strncmp(buf, tags::local_server::load_preset, strlen(tags::local_server::load_preset)) == 0) {
+    std::smatch matches;
 
-        const auto value = get_property(pipeline, plugin_name, instance_id, property);
+    static const auto re = std::regex("^load_preset:(input|output):([^\n]{1,100})\n$");
 
-        socket->write((value + "\n").c_str());
-      }
-    } else if (std::strncmp(buf, tags::local_server::get_last_loaded_preset,
-                            strlen(tags::local_server::get_last_loaded_preset)) == 0) {
-      std::string msg = buf;
+    std::regex_search(msg, matches, re);
 
-      std::smatch matches;
+    if (matches.size() == 3U) {
+      auto pipeline_type = pipeline_from(matches[1].str());
 
-      static const auto re = std::regex("^get_last_loaded_preset:(input|output)\n$");
+      std::string preset_name = matches[2];
 
-      std::regex_search(msg, matches, re);
+      presets::Manager::self().loadLocalPresetFile(pipeline_type, QString::fromStdString(preset_name));
+    }
+  } else if (std::strncmp(buf, tags::local_server::set_property, strlen(tags::local_server::set_property)) == 0) {
+    std::smatch matches;
+
+    /**
+     * Original regex:
+     * ^set_property:(input|output):([^:]+):([0-9]+):([^:]+):(.+)\n$
+     *
+     * Since the dot matches any character except line terminators, there's
+     * no need to search for final new line and end of line position.
+     */
+    static const auto re = std::regex("^set_property:(input|output):([^:]+):([0-9]+):([^:]+):([^\n]+)");
+
+    std::regex_search(msg, matches, re);
+
+    if (matches.size() == 6U) {
+      const auto& pipeline = matches[1].str();
+      const auto& plugin_name = matches[2].str();
+      const auto& instance_id = matches[3].str();
+      const auto& property = matches[4].str();
+      const auto& value = matches[5].str();
+
+      set_property(pipeline, plugin_name, instance_id, property, value);
+    }
+  } else if (std::strncmp(buf, tags::local_server::get_property, strlen(tags::local_server::get_property)) == 0) {
+    /**
+     * Example of client write that should be done:
+     * client->write(std::format("{}:output:loudness:0:volume\n", tags::local_server::get_property).c_str());
+     */
 
-      if (matches.size() == 2U) {
-        auto pipeline_type = pipeline_from(matches[1].str());
+    std::smatch matches;
 
-        QString preset_name = (pipeline_type == PipelineType::input) ? DbMain::lastLoadedInputPreset() + "\n"
-                                                                     : DbMain::lastLoadedOutputPreset() + "\n";
+    static const auto re = std::regex("^get_property:(input|output):([^:]+):([0-9]+):([^\n]+)");
 
-        socket->write(preset_name.toUtf8());
-      }
-    } else if (std::strcmp(buf, tags::local_server::get_global_bypass) == 0) {
-      socket->write(DbMain::bypass() ? "1" : "2");
-    } else if (std::strncmp(buf, tags::local_server::toggle_global_bypass,
-                            strlen(tags::local_server::toggle_global_bypass)) == 0) {
-      DbMain::setBypass(!DbMain::bypass());
+    std::regex_search(msg, matches, re);
+
+    if (matches.size() == 5U) {
+      const auto& pipeline = matches[1].str();
+      const auto& plugin_name = matches[2].str();
+      const auto& instance_id = matches[3].str();
+      const auto& property = matches[4].str();
+
+      const auto value = get_property(pipeline, plugin_name, instance_id, property);
+
+      socket->write((value + "\n").c_str());
     }
-  }
+  } else if (std::strncmp(buf, tags::local_server::get_last_loaded_preset,
+                          strlen(tags::local_server::get_last_loaded_preset)) == 0) {
+    std::smatch matches;
 
-  socket->flush();
+    static const auto re = std::regex("^get_last_loaded_preset:(input|output)\n$");
+
+    std::regex_search(msg, matches, re);
+
+    if (matches.size() == 2U) {
+      auto pipeline_type = pipeline_from(matches[1].str());
+
+      QString preset_name = (pipeline_type == PipelineType::input) ? DbMain::lastLoadedInputPreset() + "\n"
+                                                                   : DbMain::lastLoadedOutputPreset() + "\n";
+
+      socket->write(preset_name.toUtf8());
+    }
+  } else if (std::strcmp(buf, tags::local_server::get_global_bypass) == 0) {
+    socket->write(DbMain::bypass() ? "1" : "2");
+  } else if (std::strncmp(buf, tags::local_server::toggle_global_bypass,
+                          strlen(tags::local_server::toggle_global_bypass)) == 0) {
+    DbMain::setBypass(!DbMain::bypass());
+  }
 }
 
 void LocalServer::onDisconnected() {
@@ -216,6 +286,15 @@ void LocalServer::onDisconnected() {
   auto* socket = qobject_cast<QLocalSocket*>(sender());
 
   if (socket) {
+    process_partial_line(socket, true);
+
+    // an unfinished transaction and the telemetry streams die with their connection
+    transactions.remove(socket);
+
+    telemetry->remove_client(socket);
+
+    measurement_waiters.removeAll(socket);
+
     socket->deleteLater();
     socket = nullptr;
   }
@@ -226,17 +305,9 @@ void LocalServer::set_property(const std::string& pipeline,
                                const std::string& instance_id,
                                const std::string& property,
                                const std::string& value) {
-  auto type = pipeline_from(pipeline);
   QString key = QString::fromStdString(plugin_name + "#" + instance_id);
 
-  auto& mgr = db::Manager::self();
-  QObject* db = nullptr;
-
-  if (type == PipelineType::input && mgr.siePluginsDB.contains(key)) {
-    db = mgr.siePluginsDB.value(key).value<KConfigSkeleton*>();
-  } else if (type == PipelineType::output && mgr.soePluginsDB.contains(key)) {
-    db = mgr.soePluginsDB.value(key).value<KConfigSkeleton*>();
-  }
+  auto* db = find_plugin_db(pipeline, plugin_name, instance_id);
 
   if (!db) {
     util::warning(std::format("LocalServer: Plugin DB not found: {}", key.toStdString()));
@@ -315,3 +386,467 @@ auto LocalServer::get_property(const std::string& pipeline,
 
   return val.toString().toStdString();
 }
+
+auto LocalServer::find_plugin_db(const std::string& pipeline,
+                                 const std::string& plugin_name,
+                                 const std::string& instance_id) -> QObject* {
+  auto type = pipeline_from(pipeline);
+  QString key = QString::fromStdString(plugin_name + "#" + instance_id);
+
+  auto& mgr = db::Manager::self();
+
+  if (type == PipelineType::input && mgr.siePluginsDB.contains(key)) {
+    return mgr.siePluginsDB.value(key).value<KConfigSkeleton*>();
+  }
+
+  if (type == PipelineType::output && mgr.soePluginsDB.contains(key)) {
+    return mgr.soePluginsDB.value(key).value<KConfigSkeleton*>();
+  }
+
+  return nullptr;
+}
+
+namespace {
+
+/**
+ * Converts a JSON value to the type of the database property it is going to
+ * replace. Strings are accepted for every type so that shell scripts do not
+ * have to care about quoting.
+ */
+auto to_property_value(const QVariant& current, const nlohmann::json& value) -> std::optional<QVariant> {
+  switch (current.typeId()) {
+    case QMetaType::Bool: {
+      if (value.is_boolean()) {
+        return QVariant(value.get<bool>());
+      }
+
+      if (value.is_number_integer()) {
+        return QVariant(value != 0);
+      }
+
+      if (value.is_string()) {
+        const auto str = value.get<std::string>();
+
+        return QVariant(str == "true" || str == "1" || str == "on");
+      }
+
+      break;
+    }
+    case QMetaType::Int:
+    case QMetaType::UInt:
+    case QMetaType::LongLong: {
+      // Out of range values are rejected instead of being wrapped by the narrowing conversion.
+
+      qlonglong v = 0;
+
+      if (value.is_number_unsigned()) {
+        if (value.get<qulonglong>() > static_cast<qulonglong>(std::numeric_limits<qlonglong>::max())) {
+          break;
+        }
+
+        v = value.get<qlonglong>();
+      } else if (value.is_number_integer()) {
+        v = value.get<qlonglong>();
+      } else if (!value.is_string() || !util::str_to_num(value.get<std::string>(), v)) {
+        break;
+      }
+
+      if (current.typeId() == QMetaType::Int) {
+        if (v < std::numeric_limits<int>::min() || v > std::numeric_limits<int>::max()) {
+          break;
+        }
+
+        return QVariant(static_cast<int>(v));
+      }
+
+      if (current.typeId() == QMetaType::UInt) {
+        if (v < 0 || v > std::numeric_limits<uint>::max()) {
+          break;
+        }
+
+        return QVariant(static_cast<uint>(v));
+      }
+
+      return QVariant(v);
+    }
+    case QMetaType::Double:
+    case QMetaType::Float: {
+      double v = 0.0;
+
+      if (value.is_number()) {
+        return QVariant(value.get<double>());
+      }
+
+      if (value.is_string() && util::str_to_num(value.get<std::string>(), v)) {
+        return QVariant(v);
+      }
+
+      break;
+    }
+    case QMetaType::QString: {
+      if (value.is_string()) {
+        return QVariant(QString::fromStdString(value.get<std::string>()));
+      }
+
+      break;
+    }
+    default:
+      break;
+  }
+
+  return std::nullopt;
+}
+
+auto to_json(const QVariant& value) -> nlohmann::json {
+  switch (value.typeId()) {
+    case QMetaType::Bool:
+      return value.toBool();
+    case QMetaType::Int:
+    case QMetaType::UInt:
+    case QMetaType::LongLong:
+      return value.toLongLong();
+    case QMetaType::Double:
+    case QMetaType::Float:
+      return value.toDouble();
+    default:
+      return value.toString().toStdString();
+  }
+}
+
+auto instance_from(const nlohmann::json& request) -> std::string {
+  const auto& instance = request.at("instance");
+
+  return instance.is_string() ? instance.get<std::string>() : util::to_string(instance.get<int>());
+}
+
+auto to_json(const Measurement::Result& result) -> nlohmann::json {
+  nlohmann::json json;
+
+  json["valid"] = result.valid;
+
+  if (!result.valid) {
+    json["error"] = result.error.toStdString();
+
+    return json;
+  }
+
+  json["rate"] = result.rate;
+  json["measured_latency_ms"] = result.measured_latency;
+  json["reported_latency_ms"] = result.reported_latency;
+  json["latency_left_ms"] = result.latency_left;
+  json["latency_right_ms"] = result.latency_right;
+
+  for (const auto& [name, response] :
+       {std::pair{"left", &result.response_left}, std::pair{"right", &result.response_right}}) {
+    std::vector<double> frequencies, magnitudes;
+
+    for (const auto& p : *response) {
+      frequencies.push_back(p.x());
+      magnitudes.push_back(p.y());
+    }
+
+    json["response"][name] = {{"frequencies", frequencies}, {"magnitudes", magnitudes}};
+  }
+
+  return json;
+}
+
+}  // namespace
+
+void LocalServer::on_measurement_finished() {
+  nlohmann::json line;
+
+  line["measurement"] = to_json(measurement->get_result());
+
+  const auto data = QByteArray::fromStdString(line.dump() + "\n");
+
+  for (auto* socket : measurement_waiters) {
+    socket->write(data);
+  }
+
+  measurement_waiters.clear();
+}
+
+void LocalServer::process_v2(QLocalSocket* socket, const QByteArray& line) {
+  const auto request = nlohmann::json::parse(line.toStdString(), nullptr, false);
+
+  nlohmann::json reply;
+
+  std::string error;
+
+  if (request.is_discarded() || !request.is_object()) {
+    reply["id"] = nullptr;
+
+    error = "invalid JSON request";
+  } else {
+    reply["id"] = request.contains("id") ? request["id"] : nlohmann::json(nullptr);
+
+    try {
+      error = process_v2_request(socket, request, reply);
+    } catch (const nlohmann::json::exception& e) {
+      error = e.what();
+    }
+  }
+
+  if (error.empty()) {
+    reply["status"] = "ok";
+  } else {
+    reply["status"] = "error";
+    reply["error"] = error;
+
+    util::warning(std::format("LocalServer: {}", error));
+  }
+
+  socket->write(QByteArray::fromStdString(reply.dump() + "\n"));
+}
+
+auto LocalServer::process_v2_request(QLocalSocket* socket, const nlohmann::json& request, nlohmann::json& reply)
+    -> std::string {
+  const auto op = request.at("op").get<std::string>();
+
+  if (op == "hello") {
+    reply["protocol"] = tags::local_server::protocol_version;
+  } else if (op == "set") {
+    std::vector<PendingWrite> writes;
+
+    if (auto error = prepare_writes(request, writes); !error.empty()) {
+      return error;
+    }
+
+    if (transactions.contains(socket)) {
+      auto& queue = transactions[socket];
+
+      queue.insert(queue.end(), writes.begin(), writes.end());
+
+      reply["queued"] = queue.size();
+    } else {
+      return apply_writes(writes);
+    }
+  } else if (op == "get") {
+    const auto pipeline = request.at("pipeline").get<std::string>();
+    const auto plugin_name = request.at("plugin").get<std::string>();
+    const auto instance_id = instance_from(request);
+
+    auto* db = find_plugin_db(pipeline, plugin_name, instance_id);
+
+    if (!db) {
+      return std::format("plugin not found: {}#{}", plugin_name, instance_id);
+    }
+
+    nlohmann::json values = nlohmann::json::object();
+
+    for (const auto& property : request.at("properties")) {
+      const auto name = property.get<std::string>();
+
+      const auto value = db->property(name.c_str());
+
+      if (!value.isValid()) {
+        return std::format("property not found: {}", name);
+      }
+
+      values[name] = to_json(value);
+    }
+
+    reply["values"] = values;
+  } else if (op == "begin") {
+    if (transactions.contains(socket)) {
+      return "a transaction is already open on this connection";
+    }
+
+    transactions.insert(socket, {});
+  } else if (op == "commit") {
+    if (!transactions.contains(socket)) {
+      return "no open transaction";
+    }
+
+    const auto writes = transactions.take(socket);
+
+    if (auto error = apply_writes(writes); !error.empty()) {
+      return error;
+    }
+
+    reply["applied"] = writes.size();
+  } else if (op == "rollback") {
+    if (!transactions.contains(socket)) {
+      return "no open transaction";
+    }
+
+    transactions.remove(socket);
+  } else if (op == "load_preset") {
+    const auto pipeline_type = pipeline_from(request.at("pipeline").get<std::string>());
+    const auto name = request.at("name").get<std::string>();
+
+    if (!presets::Manager::self().loadLocalPresetFile(pipeline_type, QString::fromStdString(name))) {
+      return std::format("could not load the preset: {}", name);
+    }
+  } else if (op == "get_last_loaded_preset") {
+    const auto pipeline_type = pipeline_from(request.at("pipeline").get<std::string>());
+
+    reply["name"] = ((pipeline_type == PipelineType::input) ? DbMain::lastLoadedInputPreset()
+                                                            : DbMain::lastLoadedOutputPreset())
+                        .toStdString();
+  } else if (op == "set_bypass") {
+    DbMain::setBypass(request.at("state").get<bool>());
+  } else if (op == "get_bypass") {
+    reply["state"] = DbMain::bypass();
+  } else if (op == "toggle_bypass") {
+    DbMain::setBypass(!DbMain::bypass());
+
+    reply["state"] = DbMain::bypass();
+  } else if (op == "subscribe") {
+    return telemetry->subscribe(socket, request, reply);
+  } else if (op == "unsubscribe") {
+    return telemetry->unsubscribe(socket, request);
+  } else if (op == "measure") {
+    if (measurement == nullptr) {
+      return "measurements are not available";
+    }
+
+    int stimulus = DbTestSignals::measurementStimulus();
+
+    if (request.contains("stimulus")) {
+      const auto name = request["stimulus"].get<std::string>();
+
+      if (name == "log_sweep") {
+        stimulus = static_cast<int>(Measurement::Stimulus::log_sweep);
+      } else if (name == "mls") {
+        stimulus = static_cast<int>(Measurement::Stimulus::mls);
+      } else {
+        return std::format("unknown stimulus: {}", name);
+      }
+    }
+
+    // Joining a measurement that is already running is fine. Everybody waiting gets the same result.
+
+    if (!measurement->is_running() && !measurement->start(stimulus)) {
+      return "could not start the measurement";
+    }
+
+    if (!measurement_waiters.contains(socket)) {
+      measurement_waiters.append(socket);
+    }
+  } else if (op == "get_measurement") {
+    if (measurement == nullptr) {
+      return "measurements are not available";
+    }
+
+    reply["measurement"] = to_json(measurement->get_result());
+    reply["running"] = measurement->is_running();
+  } else if (op == "show_window") {
+    if (windowless) {
+      return tags::local_server::no_window_error;
+    }
+
+    Q_EMIT onShowWindow();
+  } else if (op == "hide_window") {
+    Q_EMIT onHideWindow();
+  } else if (op == "quit") {
+    Q_EMIT onQuitApp();
+  } else {
+    return std::format("unknown operation: {}", op);
+  }
+
+  return "";
+}
+
+auto LocalServer::prepare_writes(const nlohmann::json& request, std::vector<PendingWrite>& writes) -> std::string {
+  const auto pipeline = request.at("pipeline").get<std::string>();
+  const auto plugin_name = request.at("plugin").get<std::string>();
+  const auto instance_id = instance_from(request);
+
+  auto* db = find_plugin_db(pipeline, plugin_name, instance_id);
+
+  if (!db) {
+    return std::format("plugin not found: {}#{}", plugin_name, instance_id);
+  }
+
+  for (const auto& [property, value] : request.at("properties").items()) {
+    const auto current = db->property(property.c_str());
+
+    if (!current.isValid()) {
+      return std::format("property not found: {}", property);
+    }
+
+    auto converted = to_property_value(current, value);
+
+    if (!converted) {
+      return std::format("invalid value for {}: {}", property, value.dump());
+    }
+
+    writes.push_back({pipeline, plugin_name, instance_id, property, std::move(*converted)});
+  }
+
+  return "";
+}
+
+auto LocalServer::apply_writes(const std::vector<PendingWrite>& writes) -> std::string {
+  /**
+   * The plugin databases may have been recreated since the writes were
+   * queued, so every target is resolved again before anything is written.
+   */
+
+  std::vector<QObject*> targets;
+
+  targets.reserve(writes.size());
+
+  for (const auto& w : writes) {
+    auto* db = find_plugin_db(w.pipeline, w.plugin_name, w.instance_id);
+
+    if (!db) {
+      return std::format("plugin not found: {}#{}", w.plugin_name, w.instance_id);
+    }
+
+    targets.push_back(db);
+  }
+
+  /**
+   * The writes are grouped by database. Signals are blocked while a database
+   * is written so that its plugin does not see a half applied transaction.
+   * Afterwards the notify signal of every property that changed is emitted
+   * once. The databases are saved by the usual autosave.
+   */
+
+  std::vector<QObject*> dbs;
+
+  for (auto* db : targets) {
+    if (std::ranges::find(dbs, db) == dbs.end()) {
+      dbs.push_back(db);
+    }
+  }
+
+  for (auto* db : dbs) {
+    std::vector<int> changed;
+
+    {
+      const QSignalBlocker blocker(db);
+
+      for (size_t n = 0U; n < writes.size(); n++) {
+        if (targets[n] != db) {
+          continue;
+        }
+
+        const auto index = db->metaObject()->indexOfProperty(writes[n].property.c_str());
+
+        const auto previous = db->property(writes[n].property.c_str());
+
+        db->setProperty(writes[n].property.c_str(), writes[n].value);
+
+        const auto is_new = std::ranges::find(changed, index) == changed.end();
+
+        if (is_new && db->property(writes[n].property.c_str()) != previous) {
+          changed.push_back(index);
+        }
+      }
+    }
+
+    for (const auto& index : changed) {
+      if (const auto notify = db->metaObject()->property(index).notifySignal(); notify.isValid()) {
+        notify.invoke(db, Qt::DirectConnection);
+      }
+    }
+  }
+
+  util::debug(std::format("LocalServer: applied {} property writes", writes.size()));
+
+  return "";
+}
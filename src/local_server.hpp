@@ -20,13 +20,43 @@
 #pragma once
 
 #include <qtmetamacros.h>
+#include <QByteArray>
+#include <QHash>
 #include <QLocalServer>
+#include <QList>
 #include <QLocalSocket>
 #include <QObject>
+#include <QVariant>
 #include <memory>
+#include <nlohmann/json_fwd.hpp>
 #include <string>
+#include <vector>
+#include "local_telemetry.hpp"
+#include "measurement.hpp"
 #include "pipeline_type.hpp"
 
+/**
+ * Two protocols share the socket. Lines that start with '{' are protocol v2
+ * requests: one JSON object per line, always answered with one JSON line that
+ * carries the request "id" and a "status" of "ok" or "error". Everything else
+ * is handled as a v1 command.
+ *
+ * A v2 "set" request carries a whole "properties" object for one plugin. All
+ * values are validated before the first one is written, so a batch is either
+ * applied completely or not at all. "begin" opens a transaction on the
+ * connection. The "set" requests that follow are validated and queued, and
+ * they are applied together by "commit" or dropped by "rollback".
+ *
+ * "subscribe" starts a telemetry stream (see LocalTelemetry). Its frames are
+ * pushed on the same connection and are told apart from replies by the
+ * "subscription" key and the missing "status".
+ *
+ * "measure" starts a latency and frequency response measurement (see
+ * Measurement). The reply only says it started. The result is pushed later on
+ * the same connection as a line with a "measurement" key, and the last one can
+ * be read again with "get_measurement".
+ */
+
 class LocalServer : public QObject {
   Q_OBJECT
 
@@ -35,6 +65,12 @@ class LocalServer : public QObject {
   ~LocalServer() override;
 
   void startServer();
+
+  void set_pipelines(EffectsBase* input, EffectsBase* output);
+  void set_measurement(Measurement* measurement);
+
+  // Set by the daemon. Requests to show the window are then answered with an error.
+  void set_windowless(const bool& state);
   void onNewConnection();
   void onReadyRead();
   void onDisconnected();
@@ -45,10 +81,57 @@ class LocalServer : public QObject {
   void onQuitApp();
 
  private:
+  // Longest request line accepted. A client that sends more without a newline is disconnected.
+  static constexpr qint64 max_line_length = 1024 * 1024;
+
+  /**
+   * Older clients wrote some v1 commands without a newline. What is left
+   * unterminated for this long, or when the client disconnects, is handled as
+   * a whole command, like the server did before it read by lines.
+   */
+  static constexpr int partial_line_timeout_ms = 100;
+
+  struct PendingWrite {
+    std::string pipeline;
+    std::string plugin_name;
+    std::string instance_id;
+    std::string property;
+    QVariant value;
+  };
+
   std::unique_ptr<QLocalServer> server;
 
   QLocalSocket* clientSocket = nullptr;
 
+  QHash<QLocalSocket*, std::vector<PendingWrite>> transactions;
+
+  LocalTelemetry* telemetry = nullptr;
+
+  Measurement* measurement = nullptr;
+
+  bool windowless = false;
+
+  // Connections waiting for the result of the running measurement.
+  QList<QLocalSocket*> measurement_waiters;
+
+  void on_measurement_finished();
+
+  void process_v1(QLocalSocket* socket, const std::string& msg);
+
+  void process_partial_line(QLocalSocket* socket, const bool& disconnected);
+
+  void process_v2(QLocalSocket* socket, const QByteArray& line);
+
+  auto process_v2_request(QLocalSocket* socket, const nlohmann::json& request, nlohmann::json& reply) -> std::string;
+
+  static auto prepare_writes(const nlohmann::json& request, std::vector<PendingWrite>& writes) -> std::string;
+
+  static auto apply_writes(const std::vector<PendingWrite>& writes) -> std::string;
+
+  static auto find_plugin_db(const std::string& pipeline,
+                             const std::string& plugin_name,
+                             const std::string& instance_id) -> QObject*;
+
   static auto pipeline_from(const std::string& str) -> PipelineType;
 
   static void set_property(const std::string& pipeline,
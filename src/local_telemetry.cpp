@@ -0,0 +1,383 @@
+/**
+ * Copyright © 2017-2026 Wellington Wallace
+ *
+ * This file is part of Easy Effects.
+ *
+ * Easy Effects is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Easy Effects is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "local_telemetry.hpp"
+#include <qobject.h>
+#include <QByteArray>
+#include <QList>
+#include <QLocalSocket>
+#include <QPointF>
+#include <QString>
+#include <QTimer>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <format>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <utility>
+#include <vector>
+#include "autogain.hpp"
+#include "effects_base.hpp"
+#include "level_meter.hpp"
+#include "plugin_base.hpp"
+#include "util.hpp"
+
+namespace {
+
+auto round_to(const double& value, const double& step) -> double {
+  return std::round(value / step) * step;
+}
+
+auto now_ms() -> long long {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace
+
+LocalTelemetry::LocalTelemetry(QObject* parent) : QObject(parent) {}
+
+LocalTelemetry::~LocalTelemetry() {
+  while (!subscriptions.empty()) {
+    remove_subscription(subscriptions.begin()->first);
+  }
+}
+
+void LocalTelemetry::set_pipelines(EffectsBase* input, EffectsBase* output) {
+  input_effects = input;
+  output_effects = output;
+
+  for (auto* effects : {input_effects, output_effects}) {
+    if (effects == nullptr) {
+      continue;
+    }
+
+    connect(effects, &EffectsBase::newSpectrumData, this,
+            [this, effects](const QList<QPointF>& data) { publish_spectrum(effects, data); });
+  }
+}
+
+auto LocalTelemetry::subscribe(QLocalSocket* socket, const nlohmann::json& request, nlohmann::json& reply)
+    -> std::string {
+  auto sub = std::make_unique<Subscription>();
+
+  sub->socket = socket;
+
+  const auto pipeline = request.at("pipeline").get<std::string>();
+
+  if (pipeline == "input") {
+    sub->effects = input_effects;
+  } else if (pipeline == "output") {
+    sub->effects = output_effects;
+  } else {
+    return std::format("invalid pipeline: {}", pipeline);
+  }
+
+  if (sub->effects == nullptr) {
+    return "the effects pipelines are not available";
+  }
+
+  const auto stream = request.at("stream").get<std::string>();
+
+  if (stream == "levels") {
+    sub->stream = Stream::levels;
+  } else if (stream == "loudness") {
+    sub->stream = Stream::loudness;
+  } else if (stream == "latency") {
+    sub->stream = Stream::latency;
+  } else if (stream == "xruns") {
+    sub->stream = Stream::xruns;
+  } else if (stream == "spectrum") {
+    sub->stream = Stream::spectrum;
+  } else {
+    return std::format("unknown stream: {}", stream);
+  }
+
+  if (request.contains("plugin")) {
+    const auto& instance = request.value("instance", nlohmann::json(0));
+
+    const auto instance_id = instance.is_string() ? instance.get<std::string>() : util::to_string(instance.get<int>());
+
+    sub->plugin_key = QString::fromStdString(request.at("plugin").get<std::string>() + "#" + instance_id);
+
+    if (find_plugin(*sub) == nullptr) {
+      return std::format("plugin not found: {}", sub->plugin_key.toStdString());
+    }
+  }
+
+  if (sub->stream == Stream::loudness) {
+    auto* plugin = find_plugin(*sub);
+
+    if (dynamic_cast<Autogain*>(plugin) == nullptr && dynamic_cast<LevelMeter*>(plugin) == nullptr) {
+      return "the loudness stream needs an autogain or level meter plugin";
+    }
+  }
+
+  const auto rate = std::clamp(request.value("rate", 10.0), 0.1, max_rate);
+
+  sub->id = next_id++;
+
+  sub->timer = new QTimer(this);
+  sub->timer->setInterval(static_cast<int>(std::round(1000.0 / rate)));
+
+  connect(sub->timer, &QTimer::timeout, this, [this, id = sub->id]() {
+    if (auto it = subscriptions.find(id); it != subscriptions.end()) {
+      publish(*it->second);
+    }
+  });
+
+  if (sub->stream == Stream::levels) {
+    acquire_level_meters(*sub);
+  }
+
+  sub->timer->start();
+
+  reply["subscription"] = sub->id;
+  reply["rate"] = 1000.0 / sub->timer->interval();
+
+  util::debug(std::format("LocalTelemetry: subscription {} to {} of {} {}", sub->id, stream, pipeline,
+                          sub->plugin_key.toStdString()));
+
+  subscriptions.insert({sub->id, std::move(sub)});
+
+  return "";
+}
+
+auto LocalTelemetry::unsubscribe(QLocalSocket* socket, const nlohmann::json& request) -> std::string {
+  const auto id = request.at("subscription").get<int>();
+
+  auto it = subscriptions.find(id);
+
+  if (it == subscriptions.end() || it->second->socket != socket) {
+    return std::format("unknown subscription: {}", id);
+  }
+
+  remove_subscription(id);
+
+  return "";
+}
+
+void LocalTelemetry::remove_client(QLocalSocket* socket) {
+  for (auto it = subscriptions.begin(); it != subscriptions.end();) {
+    const auto id = it->first;
+    const auto* owner = it->second->socket;
+
+    ++it;
+
+    if (owner == socket) {
+      remove_subscription(id);
+    }
+  }
+}
+
+void LocalTelemetry::remove_subscription(int id) {
+  auto it = subscriptions.find(id);
+
+  if (it == subscriptions.end()) {
+    return;
+  }
+
+  auto sub = std::move(it->second);
+
+  subscriptions.erase(it);
+
+  sub->timer->stop();
+  sub->timer->deleteLater();
+
+  if (sub->stream == Stream::levels) {
+    release_level_meters(*sub);
+  }
+}
+
+auto LocalTelemetry::find_plugin(const Subscription& sub) -> PluginBase* {
+  if (sub.plugin_key.isEmpty()) {
+    return sub.effects->output_level.get();
+  }
+
+  auto& plugins = sub.effects->get_plugins_map();
+
+  auto it = plugins.find(sub.plugin_key);
+
+  return (it != plugins.end()) ? it->second.get() : nullptr;
+}
+
+/**
+ * The plugins only measure their peaks while somebody is looking at them. The
+ * previous state is restored when the last subscription goes away, so that a
+ * meter the window turned on stays on.
+ */
+void LocalTelemetry::acquire_level_meters(const Subscription& sub) {
+  auto* plugin = find_plugin(sub);
+
+  if (plugin == nullptr) {
+    return;
+  }
+
+  auto& usage = level_meter_usage[{sub.effects, sub.plugin_key}];
+
+  if (usage.count++ == 0) {
+    usage.was_enabled = plugin->updateLevelMeters;
+
+    plugin->updateLevelMeters = true;
+  }
+}
+
+void LocalTelemetry::release_level_meters(const Subscription& sub) {
+  auto it = level_meter_usage.find({sub.effects, sub.plugin_key});
+
+  if (it == level_meter_usage.end() || --it->second.count > 0) {
+    return;
+  }
+
+  if (auto* plugin = find_plugin(sub); plugin != nullptr) {
+    plugin->updateLevelMeters = it->second.was_enabled;
+  }
+
+  level_meter_usage.erase(it);
+}
+
+void LocalTelemetry::publish(Subscription& sub) {
+  if (sub.stream == Stream::spectrum) {
+    sub.waiting_spectrum = true;
+
+    sub.effects->requestSpectrumData();
+
+    return;
+  }
+
+  auto* plugin = find_plugin(sub);
+
+  nlohmann::json frame;
+
+  switch (sub.stream) {
+    case Stream::levels: {
+      if (plugin == nullptr) {
+        return;
+      }
+
+      // a plugin that was removed and added back again starts with its meters off
+
+      plugin->updateLevelMeters = true;
+
+      frame["in"] = {round_to(plugin->getInputLevelLeft(), 0.1), round_to(plugin->getInputLevelRight(), 0.1)};
+      frame["out"] = {round_to(plugin->getOutputLevelLeft(), 0.1), round_to(plugin->getOutputLevelRight(), 0.1)};
+
+      break;
+    }
+    case Stream::loudness: {
+      if (auto* autogain = dynamic_cast<Autogain*>(plugin); autogain != nullptr) {
+        frame["momentary"] = round_to(autogain->getMomentaryLevel(), 0.1);
+        frame["shortterm"] = round_to(autogain->getShorttermLevel(), 0.1);
+        frame["integrated"] = round_to(autogain->getIntegratedLevel(), 0.1);
+        frame["range"] = round_to(autogain->getRangeLevel(), 0.1);
+        frame["gain"] = round_to(autogain->getOutputGainLevel(), 0.1);
+      } else if (auto* meter = dynamic_cast<LevelMeter*>(plugin); meter != nullptr) {
+        frame["momentary"] = round_to(meter->getMomentaryLevel(), 0.1);
+        frame["shortterm"] = round_to(meter->getShorttermLevel(), 0.1);
+        frame["integrated"] = round_to(meter->getIntegratedLevel(), 0.1);
+        frame["range"] = round_to(meter->getRangeLevel(), 0.1);
+        frame["true_peak"] = {round_to(meter->getTruePeakL(), 0.1), round_to(meter->getTruePeakR(), 0.1)};
+      } else {
+        return;
+      }
+
+      break;
+    }
+    case Stream::latency: {
+      if (sub.plugin_key.isEmpty()) {
+        frame["ms"] = sub.effects->getPipeLineLatency();
+      } else if (plugin != nullptr) {
+        frame["ms"] = round_to(1000.0 * plugin->get_latency_seconds(), 0.01);
+      } else {
+        return;
+      }
+
+      break;
+    }
+    case Stream::xruns: {
+      if (plugin == nullptr) {
+        return;
+      }
+
+      frame["count"] = plugin->xruns.load(std::memory_order_relaxed);
+
+      break;
+    }
+    case Stream::spectrum:
+      break;
+  }
+
+  push(sub, frame);
+}
+
+void LocalTelemetry::publish_spectrum(EffectsBase* effects, const QList<QPointF>& data) {
+  for (auto& [id, sub] : subscriptions) {
+    if (sub->stream != Stream::spectrum || sub->effects != effects || !sub->waiting_spectrum) {
+      continue;
+    }
+
+    sub->waiting_spectrum = false;
+
+    nlohmann::json frame;
+
+    auto magnitudes = nlohmann::json::array();
+
+    std::vector<double> frequencies;
+
+    frequencies.reserve(data.size());
+
+    for (const auto& p : data) {
+      frequencies.push_back(round_to(p.x(), 0.1));
+      magnitudes.push_back(round_to(p.y(), 0.01));
+    }
+
+    // The frequency axis only changes with the spectrum settings.
+
+    if (frequencies != sub->frequencies) {
+      frame["frequencies"] = frequencies;
+
+      sub->frequencies = std::move(frequencies);
+    }
+
+    frame["magnitudes"] = magnitudes;
+
+    push(*sub, frame);
+  }
+}
+
+void LocalTelemetry::push(Subscription& sub, nlohmann::json& frame) {
+  if (sub.socket->bytesToWrite() > max_pending_bytes) {
+    sub.dropped++;
+
+    return;
+  }
+
+  frame["subscription"] = sub.id;
+  frame["t"] = now_ms();
+
+  if (sub.dropped > 0U) {
+    frame["dropped"] = sub.dropped;
+
+    sub.dropped = 0U;
+  }
+
+  sub.socket->write(QByteArray::fromStdString(frame.dump() + "\n"));
+}
@@ -0,0 +1,123 @@
+/**
+ * Copyright © 2017-2026 Wellington Wallace
+ *
+ * This file is part of Easy Effects.
+ *
+ * Easy Effects is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Easy Effects is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <qtmetamacros.h>
+#include <QList>
+#include <QLocalSocket>
+#include <QObject>
+#include <QPointF>
+#include <QString>
+#include <QTimer>
+#include <map>
+#include <memory>
+#include <nlohmann/json_fwd.hpp>
+#include <string>
+#include <utility>
+#include <vector>
+
+class EffectsBase;
+class PluginBase;
+
+/**
+ * Pushes periodic measurements to the clients of the local socket server.
+ *
+ * A client subscribes to one stream of one pipeline, optionally for a single
+ * plugin, and asks for a frame rate. Every subscription has its own timer on
+ * the main thread, so the values are read at the requested rate no matter how
+ * many clients are connected. When a client does not read its socket and more
+ * than max_pending_bytes are waiting, new frames are dropped instead of
+ * queued. The next frame that goes out reports how many were lost.
+ */
+class LocalTelemetry : public QObject {
+  Q_OBJECT
+
+ public:
+  explicit LocalTelemetry(QObject* parent = nullptr);
+  LocalTelemetry(const LocalTelemetry&) = delete;
+  auto operator=(const LocalTelemetry&) -> LocalTelemetry& = delete;
+  LocalTelemetry(const LocalTelemetry&&) = delete;
+  auto operator=(const LocalTelemetry&&) -> LocalTelemetry& = delete;
+  ~LocalTelemetry() override;
+
+  static constexpr double max_rate = 60.0;  // Hz
+
+  static constexpr qint64 max_pending_bytes = 64 * 1024;
+
+  void set_pipelines(EffectsBase* input, EffectsBase* output);
+
+  auto subscribe(QLocalSocket* socket, const nlohmann::json& request, nlohmann::json& reply) -> std::string;
+
+  auto unsubscribe(QLocalSocket* socket, const nlohmann::json& request) -> std::string;
+
+  void remove_client(QLocalSocket* socket);
+
+ private:
+  enum class Stream { levels, loudness, latency, xruns, spectrum };
+
+  struct Subscription {
+    int id = 0;
+
+    QLocalSocket* socket = nullptr;
+
+    Stream stream = Stream::levels;
+
+    EffectsBase* effects = nullptr;
+
+    QString plugin_key;  // empty for the output of the pipeline
+
+    QTimer* timer = nullptr;
+
+    uint dropped = 0U;
+
+    bool waiting_spectrum = false;
+
+    std::vector<double> frequencies;  // last frequency axis sent to the client
+  };
+
+  struct LevelMeterUsage {
+    int count = 0;
+
+    bool was_enabled = false;
+  };
+
+  EffectsBase* input_effects = nullptr;
+  EffectsBase* output_effects = nullptr;
+
+  int next_id = 1;
+
+  std::map<int, std::unique_ptr<Subscription>> subscriptions;
+
+  std::map<std::pair<EffectsBase*, QString>, LevelMeterUsage> level_meter_usage;
+
+  auto find_plugin(const Subscription& sub) -> PluginBase*;
+
+  void publish(Subscription& sub);
+
+  void publish_spectrum(EffectsBase* effects, const QList<QPointF>& data);
+
+  void push(Subscription& sub, nlohmann::json& frame);
+
+  void acquire_level_meters(const Subscription& sub);
+
+  void release_level_meters(const Subscription& sub);
+
+  void remove_subscription(int id);
+};
@@ -60,6 +60,8 @@ Loudness::Loudness(const std::string& tag, pw::Manager* pipe_manager, PipelineTy
 
   init_common_controls<DbLoudness>(settings);
 
+  enable_lv2_extra_channels();
+
   BIND_LV2_PORT("mode", mode, setMode, DbLoudness::modeChanged);
   BIND_LV2_PORT("std", std, setStd, DbLoudness::stdChanged);
   BIND_LV2_PORT("fft", fft, setFft, DbLoudness::fftChanged);
@@ -192,10 +192,8 @@ void NativeUi::load() {
           +[](LV2UI_Controller controller, uint32_t port_index, uint32_t, uint32_t port_protocol, const void* buffer) {
             auto wrapper = static_cast<Lv2Wrapper*>(controller);
 
-            for (auto& p : wrapper->ports) {
-              if (p.index == port_index && port_protocol == 0) {
-                p.value = *static_cast<const float*>(buffer);
-              }
+            if (port_protocol == 0) {
+              wrapper->queue_control_port_value(port_index, *static_cast<const float*>(buffer));
             }
           },
           wrapper, &widget, features.data());
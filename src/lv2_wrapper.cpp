@@ -28,10 +28,12 @@
 #include <lv2/lv2plug.in/ns/ext/log/log.h>
 #include <lv2/options/options.h>
 #include <lv2/parameters/parameters.h>
+#include <lv2/port-props/port-props.h>
 #include <lv2/ui/ui.h>
 #include <lv2/urid/urid.h>
 #include <sys/types.h>
 #include <array>
+#include <atomic>
 #include <climits>
 #include <cmath>
 #include <cstdarg>
@@ -44,6 +46,7 @@
 #include <unordered_map>
 #include <utility>
 #include <vector>
+#include "db_manager.hpp"
 #include "util.hpp"
 
 namespace lv2 {
@@ -86,12 +89,7 @@ Lv2Wrapper::Lv2Wrapper(const std::string& plugin_uri)
 }
 
 Lv2Wrapper::~Lv2Wrapper() {
-  if (instance != nullptr) {
-    lilv_instance_deactivate(instance);
-    lilv_instance_free(instance);
-
-    instance = nullptr;
-  }
+  destroy_instance();
 
   if (world != nullptr) {
     lilv_world_free(world);
@@ -137,6 +135,12 @@ void Lv2Wrapper::create_ports() {
 
   ports.resize(n_ports);
 
+  control_targets = std::vector<std::atomic<float>>(n_ports);
+  control_dirty = std::vector<std::atomic<bool>>(n_ports);
+
+  ramp_start.resize(n_ports);
+  ramp_ports.reserve(n_ports);
+
   // Get min, max and default values for all ports
 
   std::vector<float> values(n_ports);
@@ -151,6 +155,10 @@ void Lv2Wrapper::create_ports() {
   LilvNode* lv2_ControlPort = lilv_new_uri(world, LV2_CORE__ControlPort);
   LilvNode* lv2_AtomPort = lilv_new_uri(world, LV2_ATOM__AtomPort);
   LilvNode* lv2_connectionOptional = lilv_new_uri(world, LV2_CORE__connectionOptional);
+  LilvNode* lv2_toggled = lilv_new_uri(world, LV2_CORE__toggled);
+  LilvNode* lv2_integer = lilv_new_uri(world, LV2_CORE__integer);
+  LilvNode* lv2_enumeration = lilv_new_uri(world, LV2_CORE__enumeration);
+  LilvNode* lv2_trigger = lilv_new_uri(world, LV2_PORT_PROPS__trigger);
 
   data_ports.in.left = data_ports.in.right = UINT_MAX;
   data_ports.probe.left = data_ports.probe.right = UINT_MAX;
@@ -191,6 +199,11 @@ void Lv2Wrapper::create_ports() {
 
     if (lilv_port_is_a(plugin, lilv_port, lv2_ControlPort)) {
       port->type = lv2::PortType::TYPE_CONTROL;
+
+      port->smooth = !lilv_port_has_property(plugin, lilv_port, lv2_toggled) &&
+                     !lilv_port_has_property(plugin, lilv_port, lv2_integer) &&
+                     !lilv_port_has_property(plugin, lilv_port, lv2_enumeration) &&
+                     !lilv_port_has_property(plugin, lilv_port, lv2_trigger);
     } else if (lilv_port_is_a(plugin, lilv_port, lv2_AtomPort)) {
       port->type = lv2::PortType::TYPE_ATOM;
 
@@ -223,12 +236,18 @@ void Lv2Wrapper::create_ports() {
       util::warning(std::format("Port {} has un unsupported type!", port->name));
     }
 
+    control_targets[n].store(port->value, std::memory_order_relaxed);
+
     lilv_node_free(port_name);
   }
 
   // util::warning("n audio_in ports: " + util::to_string(n_audio_in));
   // util::warning("n audio_out ports: " + util::to_string(n_audio_out));
 
+  lilv_node_free(lv2_trigger);
+  lilv_node_free(lv2_enumeration);
+  lilv_node_free(lv2_integer);
+  lilv_node_free(lv2_toggled);
   lilv_node_free(lv2_connectionOptional);
   lilv_node_free(lv2_ControlPort);
   lilv_node_free(lv2_AtomPort);
@@ -309,6 +328,14 @@ auto Lv2Wrapper::create_instance(const uint& rate) -> bool {
     return false;
   }
 
+  for (auto& extra : extra_instances) {
+    extra.instance = lilv_plugin_instantiate(plugin, rate, features.data());
+
+    if (extra.instance == nullptr) {
+      util::warning(std::format("Failed to instantiate an extra channel instance of {}", plugin_uri));
+    }
+  }
+
   connect_control_ports();
 
   activate();
@@ -324,6 +351,14 @@ void Lv2Wrapper::destroy_instance() {
 
     instance = nullptr;
   }
+
+  for (auto& extra : extra_instances) {
+    if (extra.instance != nullptr) {
+      lilv_instance_free(extra.instance);
+
+      extra.instance = nullptr;
+    }
+  }
 }
 
 auto Lv2Wrapper::get_instance() -> LilvInstance* {
@@ -331,13 +366,39 @@ auto Lv2Wrapper::get_instance() -> LilvInstance* {
 }
 
 void Lv2Wrapper::connect_control_ports() {
+  // There is no realtime reader while the instance is being created. So pending values can be applied directly.
+
+  has_pending_controls.store(false, std::memory_order_relaxed);
+
   for (auto& p : ports) {
     if (p.type == PortType::TYPE_CONTROL) {
+      if (p.is_input) {
+        control_dirty[p.index].store(false, std::memory_order_relaxed);
+
+        p.value = control_targets[p.index].load(std::memory_order_relaxed);
+      }
+
       lilv_instance_connect_port(instance, p.index, &p.value);
+
+      // The extra instances only run on the realtime thread, right after the main one, so they can share its inputs.
+
+      for (auto& extra : extra_instances) {
+        if (extra.instance != nullptr) {
+          lilv_instance_connect_port(extra.instance, p.index, p.is_input ? &p.value : &extra.control_outputs[p.index]);
+        }
+      }
     }
   }
 }
 
+void Lv2Wrapper::connect_audio_buffer(const uint& port_index, float* data) {
+  lilv_instance_connect_port(instance, port_index, data);
+
+  if (n_audio_buffers < audio_buffers.size()) {
+    audio_buffers[n_audio_buffers++] = std::pair<uint, float*>(port_index, data);
+  }
+}
+
 void Lv2Wrapper::connect_data_ports(std::span<float>& left_in,
                                     std::span<float>& right_in,
                                     std::span<float>& left_out,
@@ -346,17 +407,19 @@ void Lv2Wrapper::connect_data_ports(std::span<float>& left_in,
     return;
   }
 
+  n_audio_buffers = 0U;
+
   if (data_ports.in.left != UINT_MAX) {
-    lilv_instance_connect_port(instance, data_ports.in.left, left_in.data());
+    connect_audio_buffer(data_ports.in.left, left_in.data());
   }
   if (data_ports.in.right != UINT_MAX) {
-    lilv_instance_connect_port(instance, data_ports.in.right, right_in.data());
+    connect_audio_buffer(data_ports.in.right, right_in.data());
   }
   if (data_ports.out.left != UINT_MAX) {
-    lilv_instance_connect_port(instance, data_ports.out.left, left_out.data());
+    connect_audio_buffer(data_ports.out.left, left_out.data());
   }
   if (data_ports.out.right != UINT_MAX) {
-    lilv_instance_connect_port(instance, data_ports.out.right, right_out.data());
+    connect_audio_buffer(data_ports.out.right, right_out.data());
   }
 }
 
@@ -370,24 +433,71 @@ void Lv2Wrapper::connect_data_ports(std::span<float>& left_in,
     return;
   }
 
+  n_audio_buffers = 0U;
+
   if (data_ports.in.left != UINT_MAX) {
-    lilv_instance_connect_port(instance, data_ports.in.left, left_in.data());
+    connect_audio_buffer(data_ports.in.left, left_in.data());
   }
   if (data_ports.in.right != UINT_MAX) {
-    lilv_instance_connect_port(instance, data_ports.in.right, right_in.data());
+    connect_audio_buffer(data_ports.in.right, right_in.data());
   }
   if (data_ports.probe.left != UINT_MAX) {
-    lilv_instance_connect_port(instance, data_ports.probe.left, probe_left.data());
+    connect_audio_buffer(data_ports.probe.left, probe_left.data());
   }
   if (data_ports.probe.right != UINT_MAX) {
-    lilv_instance_connect_port(instance, data_ports.probe.right, probe_right.data());
+    connect_audio_buffer(data_ports.probe.right, probe_right.data());
   }
   if (data_ports.out.left != UINT_MAX) {
-    lilv_instance_connect_port(instance, data_ports.out.left, left_out.data());
+    connect_audio_buffer(data_ports.out.left, left_out.data());
   }
   if (data_ports.out.right != UINT_MAX) {
-    lilv_instance_connect_port(instance, data_ports.out.right, right_out.data());
+    connect_audio_buffer(data_ports.out.right, right_out.data());
+  }
+}
+
+void Lv2Wrapper::set_extra_instances(const uint& count) {
+  destroy_instance();
+
+  extra_instances = std::vector<ExtraInstance>(count);
+
+  for (auto& extra : extra_instances) {
+    extra.control_outputs.resize(n_ports);
+  }
+}
+
+auto Lv2Wrapper::get_extra_instances() const -> uint {
+  return static_cast<uint>(extra_instances.size());
+}
+
+void Lv2Wrapper::set_extra_data_ports(const uint& k,
+                                      std::span<float> left_in,
+                                      std::span<float> right_in,
+                                      std::span<float> left_out,
+                                      std::span<float> right_out) {
+  if (k >= extra_instances.size()) {
+    return;
   }
+
+  auto& extra = extra_instances[k];
+
+  extra.n_audio_buffers = 0U;
+
+  const auto buffers = std::to_array<std::pair<uint, float*>>({{data_ports.in.left, left_in.data()},
+                                                               {data_ports.in.right, right_in.data()},
+                                                               {data_ports.probe.left, left_in.data()},
+                                                               {data_ports.probe.right, right_in.data()},
+                                                               {data_ports.out.left, left_out.data()},
+                                                               {data_ports.out.right, right_out.data()}});
+
+  for (const auto& [port_index, data] : buffers) {
+    if (port_index != UINT_MAX) {
+      extra.audio_buffers[extra.n_audio_buffers++] = std::pair<uint, float*>(port_index, data);
+    }
+  }
+}
+
+auto Lv2Wrapper::take_extra_run() -> bool {
+  return std::exchange(ran_extra_instances, false);
 }
 
 void Lv2Wrapper::set_n_samples(const uint& value) {
@@ -403,17 +513,137 @@ auto Lv2Wrapper::get_rate() const -> uint {
 }
 
 void Lv2Wrapper::activate() {
+  if (instance == nullptr || active) {
+    return;
+  }
+
   lilv_instance_activate(instance);
+
+  for (auto& extra : extra_instances) {
+    if (extra.instance != nullptr) {
+      lilv_instance_activate(extra.instance);
+    }
+  }
+
+  active = true;
 }
 
-void Lv2Wrapper::run() const {
-  if (instance != nullptr) {
+void Lv2Wrapper::run() {
+  if (instance == nullptr) {
+    return;
+  }
+
+  const bool ramp = DbMain::smoothControlPorts() && n_samples >= 2U * min_quantum;
+
+  if (!apply_pending_control_values(ramp)) {
     lilv_instance_run(instance, n_samples);
+
+    run_extra_instances(0U, n_samples);
+
+    for (auto& extra : extra_instances) {
+      extra.n_audio_buffers = 0U;
+    }
+
+    return;
+  }
+
+  /**
+   * Some smoothed controls changed. The block is split in sub-blocks of min_quantum samples and the control values
+   * are linearly interpolated between them. The last sub-block absorbs the remainder so it is never shorter than
+   * the minimum block length we announced to the plugin.
+   */
+
+  const uint n_blocks = n_samples / min_quantum;
+
+  for (uint b = 0U; b < n_blocks; b++) {
+    const uint offset = b * min_quantum;
+    const uint count = (b == n_blocks - 1U) ? n_samples - offset : min_quantum;
+    const float t = static_cast<float>(b + 1U) / static_cast<float>(n_blocks);
+
+    for (const auto& idx : ramp_ports) {
+      const auto target = control_targets[idx].load(std::memory_order_relaxed);
+
+      ports[idx].value = ramp_start[idx] + (t * (target - ramp_start[idx]));
+    }
+
+    for (uint n = 0U; n < n_audio_buffers; n++) {
+      lilv_instance_connect_port(instance, audio_buffers[n].first, audio_buffers[n].second + offset);
+    }
+
+    lilv_instance_run(instance, count);
+
+    run_extra_instances(offset, count);
+  }
+
+  for (auto& extra : extra_instances) {
+    extra.n_audio_buffers = 0U;
+  }
+
+  for (const auto& idx : ramp_ports) {
+    ports[idx].value = control_targets[idx].load(std::memory_order_relaxed);
+  }
+
+  for (uint n = 0U; n < n_audio_buffers; n++) {
+    lilv_instance_connect_port(instance, audio_buffers[n].first, audio_buffers[n].second);
+  }
+}
+
+void Lv2Wrapper::run_extra_instances(const uint& offset, const uint& count) {
+  for (auto& extra : extra_instances) {
+    if (extra.instance == nullptr || extra.n_audio_buffers == 0U) {
+      continue;
+    }
+
+    for (uint n = 0U; n < extra.n_audio_buffers; n++) {
+      lilv_instance_connect_port(extra.instance, extra.audio_buffers[n].first, extra.audio_buffers[n].second + offset);
+    }
+
+    lilv_instance_run(extra.instance, count);
+
+    ran_extra_instances = true;
+  }
+}
+
+auto Lv2Wrapper::apply_pending_control_values(const bool& ramp) -> bool {
+  ramp_ports.clear();
+
+  if (!has_pending_controls.exchange(false, std::memory_order_acquire)) {
+    return false;
+  }
+
+  for (auto& p : ports) {
+    if (!control_dirty[p.index].exchange(false, std::memory_order_acquire)) {
+      continue;
+    }
+
+    const auto target = control_targets[p.index].load(std::memory_order_relaxed);
+
+    if (ramp && p.smooth && target != p.value && std::isfinite(target) && std::isfinite(p.value)) {
+      ramp_start[p.index] = p.value;
+
+      ramp_ports.push_back(p.index);
+    } else {
+      p.value = target;
+    }
   }
+
+  return !ramp_ports.empty();
 }
 
 void Lv2Wrapper::deactivate() {
+  if (instance == nullptr || !active) {
+    return;
+  }
+
   lilv_instance_deactivate(instance);
+
+  for (auto& extra : extra_instances) {
+    if (extra.instance != nullptr) {
+      lilv_instance_deactivate(extra.instance);
+    }
+  }
+
+  active = false;
 }
 
 void Lv2Wrapper::set_control_port_value(const std::string& symbol, const float& value) {
@@ -434,14 +664,14 @@ void Lv2Wrapper::set_control_port_value(const std::string& symbol, const float&
         // util::warning(plugin_uri + ": value " + util::to_string(value) + "
         // is out of minimum limit for port " + p.symbol + " (" + p.name + ")");
 
-        p.value = p.min;
+        queue_control_port_value(p.index, p.min);
       } else if (value > p.max) {
         // util::warning(plugin_uri + ": value " + util::to_string(value) + "
         // is out of maximum limit for port " + p.symbol + " (" + p.name + ")");
 
-        p.value = p.max;
+        queue_control_port_value(p.index, p.max);
       } else {
-        p.value = value;
+        queue_control_port_value(p.index, value);
       }
 
       found = true;
@@ -454,6 +684,18 @@ void Lv2Wrapper::set_control_port_value(const std::string& symbol, const float&
     util::warning(std::format("{} port symbol not found: {}", plugin_uri, symbol));
   }
 }
+
+void Lv2Wrapper::queue_control_port_value(const uint& port_index, const float& value) {
+  if (port_index >= control_targets.size()) {
+    return;
+  }
+
+  control_targets[port_index].store(value, std::memory_order_relaxed);
+  control_dirty[port_index].store(true, std::memory_order_release);
+
+  has_pending_controls.store(true, std::memory_order_release);
+}
+
 auto Lv2Wrapper::get_control_port_value(const std::string& symbol) -> float {
   size_t hash = std::hash<std::string>{}(symbol);
 
@@ -471,7 +713,7 @@ auto Lv2Wrapper::get_control_port_value(const std::string& symbol) -> float {
     // Ignore false positives.
     const Port& p = ports[slot.second];
     if (p.type == PortType::TYPE_CONTROL && p.symbol == symbol) {
-      return p.value;
+      return p.is_input ? control_targets[p.index].load(std::memory_order_relaxed) : p.value;
     }
   }
 
@@ -485,7 +727,7 @@ auto Lv2Wrapper::get_control_port_value(const std::string& symbol) -> float {
         }
       }
 
-      return p.value;
+      return p.is_input ? control_targets[p.index].load(std::memory_order_relaxed) : p.value;
     }
   }
 
@@ -494,6 +736,28 @@ auto Lv2Wrapper::get_control_port_value(const std::string& symbol) -> float {
   return 0.0F;
 }
 
+auto Lv2Wrapper::get_control_port_index(const std::string& symbol) -> uint {
+  for (const auto& p : ports) {
+    if (p.type == PortType::TYPE_CONTROL && p.symbol == symbol) {
+      return p.index;
+    }
+  }
+
+  util::warning(std::format("{} port symbol not found: {}", plugin_uri, symbol));
+
+  return n_ports;
+}
+
+auto Lv2Wrapper::get_control_port_value(const uint& port_index) -> float {
+  if (port_index >= ports.size()) {
+    return 0.0F;
+  }
+
+  const Port& p = ports[port_index];
+
+  return p.is_input ? control_targets[p.index].load(std::memory_order_relaxed) : p.value;
+}
+
 auto Lv2Wrapper::has_instance() -> bool {
   return instance != nullptr;
 }
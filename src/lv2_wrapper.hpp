@@ -27,6 +27,7 @@
 #include <lv2/urid/urid.h>
 #include <sys/types.h>
 #include <array>
+#include <atomic>
 #include <cstddef>
 #include <functional>
 #include <limits>
@@ -66,6 +67,8 @@ struct Port {
   bool is_input;  // True if an input port
 
   bool optional;  // True if the connection is optional
+
+  bool smooth = false;  // True if the value can be linearly ramped (not toggled, integer or enumeration)
 };
 
 class Lv2Wrapper {
@@ -112,16 +115,48 @@ class Lv2Wrapper {
                           std::span<float>& probe_left,
                           std::span<float>& probe_right);
 
+  /**
+   * Extra instances of the plugin for the channels that follow FL and FR. They are created, activated and destroyed
+   * together with the main one and read its control input values, so settings and native UI changes reach all of
+   * them. Their control outputs are not read. Must be called before create_instance().
+   */
+  void set_extra_instances(const uint& count);
+
+  [[nodiscard]] auto get_extra_instances() const -> uint;
+
+  /**
+   * Buffers for the extra instance k. They are used by the next call to run() only, so they have to be given again
+   * every cycle. The sidechain inputs of the extra instances take their own input.
+   */
+  void set_extra_data_ports(const uint& k,
+                            std::span<float> left_in,
+                            std::span<float> right_in,
+                            std::span<float> left_out,
+                            std::span<float> right_out);
+
+  // True if the extra instances ran since the last call. Only called by the realtime thread.
+  auto take_extra_run() -> bool;
+
   void activate();
 
-  void run() const;
+  void run();
 
   void deactivate();
 
   void set_control_port_value(const std::string& symbol, const float& value);
 
+  void queue_control_port_value(const uint& port_index, const float& value);
+
   auto get_control_port_value(const std::string& symbol) -> float;
 
+  /**
+   * Meant to be called once, outside of the realtime thread. The index can then be given to the overload of
+   * get_control_port_value below, which does not do any string work. Returns n_ports if the symbol is not found.
+   */
+  auto get_control_port_index(const std::string& symbol) -> uint;
+
+  auto get_control_port_value(const uint& port_index) -> float;
+
   auto has_instance() -> bool;
 
   void load_ui();
@@ -160,6 +195,8 @@ class Lv2Wrapper {
 
   LilvInstance* instance = nullptr;
 
+  bool active = false;  // The LV2 specification does not allow activate or deactivate to be called twice in a row
+
   NativeUi native_ui;
 
   uint n_ports = 0U;
@@ -185,6 +222,44 @@ class Lv2Wrapper {
     } out;
   } data_ports;
 
+  /**
+   * Audio buffers given in the last call to connect_data_ports. We keep them so run() can reconnect the plugin
+   * to offsets inside them when a block is split to ramp control values.
+   */
+  std::array<std::pair<uint, float*>, 6> audio_buffers{};
+
+  uint n_audio_buffers = 0U;
+
+  struct ExtraInstance {
+    LilvInstance* instance = nullptr;
+
+    std::vector<float> control_outputs;
+
+    std::array<std::pair<uint, float*>, 6> audio_buffers{};
+
+    uint n_audio_buffers = 0U;
+  };
+
+  std::vector<ExtraInstance> extra_instances;
+
+  bool ran_extra_instances = false;
+
+  /**
+   * Control values set by the main and worker threads are not written directly to Port::value because the plugin
+   * instance reads it while run() is executing. They are stored here and the realtime thread copies them at the
+   * beginning of the next block.
+   */
+  std::vector<std::atomic<float>> control_targets;
+
+  std::vector<std::atomic<bool>> control_dirty;
+
+  std::atomic<bool> has_pending_controls = false;
+
+  // Preallocated in create_ports so the realtime thread never allocates while ramping
+  std::vector<float> ramp_start;
+
+  std::vector<uint> ramp_ports;
+
   std::unordered_map<std::string, LV2_URID> map_uri_to_urid;
 
   std::mutex ui_mutex;
@@ -194,6 +269,12 @@ class Lv2Wrapper {
   void create_ports();
 
   void connect_control_ports();
+
+  void connect_audio_buffer(const uint& port_index, float* data);
+
+  auto apply_pending_control_values(const bool& ramp) -> bool;
+
+  void run_extra_instances(const uint& offset, const uint& count);
 };
 
 }  // namespace lv2
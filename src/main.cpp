@@ -41,11 +41,16 @@
 #include <QProcessEnvironment>
 #include <QQuickWindow>
 #include <QSystemTrayIcon>
+#include <algorithm>
 #include <csignal>
+#include <cstddef>
+#include <cstdlib>
 #include <format>
 #include <memory>
+#include <span>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include "autostart.hpp"
 #include "command_line_parser.hpp"
 #include "config.h"
@@ -55,6 +60,7 @@
 #include "kcolor_manager.hpp"
 #include "local_client.hpp"
 #include "local_server.hpp"
+#include "measurement.hpp"
 #include "pipeline_type.hpp"
 #include "presets_manager.hpp"
 #include "pw_manager.hpp"
@@ -92,6 +98,8 @@ struct CoreServices {
   std::unique_ptr<StreamInputEffects> sie;
   std::unique_ptr<StreamOutputEffects> soe;
 
+  std::unique_ptr<Measurement> measurement;
+
   CoreServices(bool is_primary) {
     util::debug(std::format("easyffects version: {}.{}.{}", VERSION_MAJOR, VERSION_MINOR, VERSION_PATCH));
 
@@ -105,8 +113,15 @@ struct CoreServices {
       soe = std::make_unique<StreamOutputEffects>(pwm);
 
       TestSignals::self(pwm);
+      measurement = std::make_unique<Measurement>(pwm, soe.get());
       tags::plugin_name::Model::self();
-      presets::Manager::self();
+      presets::Manager::self().set_pipelines(sie.get(), soe.get());
+    }
+  }
+
+  ~CoreServices() {
+    if (sie != nullptr) {
+      presets::Manager::self().set_pipelines(nullptr, nullptr);
     }
   }
 
@@ -272,7 +287,10 @@ static void initQml(QQmlApplicationEngine& engine,
   }
 }
 
-static int runSecondaryInstance(KAboutData& about, QApplication& app, CommandLineParser& parser, bool& show_window) {
+static int runSecondaryInstance(KAboutData& about,
+                                QCoreApplication& app,
+                                CommandLineParser& parser,
+                                bool& show_window) {
   auto local_client = std::make_unique<LocalClient>();
 
   QObject::connect(&parser, &CommandLineParser::onQuit, [&]() {
@@ -325,28 +343,25 @@ static int runSecondaryInstance(KAboutData& about, QApplication& app, CommandLin
   parser.process_events();
 
   if (show_window) {
-    local_client->show_window();
+    if (const auto error = local_client->show_window(); !error.empty()) {
+      std::cerr << error << '\n';
+
+      return EXIT_FAILURE;
+    }
   }
 
   return 0;
 }
 
-int main(int argc, char* argv[]) {
-  QCoreApplication::setAttribute(Qt::AA_ShareOpenGLContexts);
-  QLoggingCategory::setFilterRules("easyeffects.debug=false");
-
-  KIconTheme::initTheme();
-
-  QApplication app(argc, argv);
-
-  SignalHandler signalHandler;
-
+static void initTranslations() {
   if (DbMain::englishLanguage()) {
     KLocalizedString::setLanguages({QStringLiteral("C")});
   }
 
   KLocalizedString::setApplicationDomain(APPLICATION_DOMAIN);
+}
 
+static auto makeAboutData() -> KAboutData {
   KAboutData about(QStringLiteral(APPLICATION_DOMAIN), QStringLiteral(APPLICATION_NAME),
                    QStringLiteral(PROJECT_VERSION), i18n("Global audio effects"), KAboutLicense::GPL_V3,
                    i18n("© 2017-2026 Easy Effects Team"));
@@ -363,17 +378,70 @@ int main(int argc, char* argv[]) {
 
   KAboutData::setApplicationData(about);
 
-  QGuiApplication::setWindowIcon(QIcon::fromTheme(QStringLiteral(APPLICATION_ID)));
+  return about;
+}
 
-  KColorSchemeManager::instance();
+static auto isDaemonRequested(int argc, char* argv[]) -> bool {
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  const std::span<char*> args(argv, static_cast<size_t>(argc));
 
-  // Parsing command line options
+  return std::ranges::any_of(args.subspan(1), [](const char* arg) { return std::string_view(arg) == "--daemon"; });
+}
 
-  auto cmd_parser = std::make_unique<CommandLineParser>(about);
+static auto runDaemon(QCoreApplication& app, KAboutData& about, CommandLineParser& parser) -> int {
+  parser.process(about, &app);
+  parser.process_debug_option();
 
-  QObject::connect(cmd_parser.get(), &CommandLineParser::onReset, [&]() { db::Manager::self().resetAll(); });
+  util::debug("Starting in daemon mode. No user interface will be loaded.");
+
+  CoreServices core(true);
+
+  auto local_server = std::make_unique<LocalServer>();
+
+  local_server->set_pipelines(core.sie.get(), core.soe.get());
+  local_server->set_measurement(core.measurement.get());
+  local_server->set_windowless(true);
+  local_server->startServer();
+
+  QObject::connect(local_server.get(), &LocalServer::onQuitApp, [&]() { QCoreApplication::quit(); });
 
-  // Checking if there is already an instance running
+  /**
+   * Options like --load-preset or --bypass given together with --daemon are
+   * applied by the daemon itself, as there is no other instance to send them
+   * to. The parser asks the application to exit after them, which does
+   * nothing before the event loop starts.
+   */
+
+  QObject::connect(&parser, &CommandLineParser::onLoadPreset, [](PipelineType type, const QString& preset) {
+    presets::Manager::self().loadLocalPresetFile(type, preset);
+  });
+
+  QObject::connect(&parser, &CommandLineParser::onSetGlobalBypass, [](const bool& state) { DbMain::setBypass(state); });
+
+  QObject::connect(&parser, &CommandLineParser::onGetGlobalBypass,
+                   []() { std::cout << (DbMain::bypass() ? 1 : 2) << '\n'; });
+
+  QObject::connect(&parser, &CommandLineParser::onToggleGlobalBypass, []() { DbMain::setBypass(!DbMain::bypass()); });
+
+  initGlobalBypass(*core.sie, *core.soe);
+
+  QObject::connect(&app, &QCoreApplication::aboutToQuit, [&]() { db::Manager::self().saveAll(); });
+
+  parser.process_events();
+
+  return QCoreApplication::exec();
+}
+
+int main(int argc, char* argv[]) {
+  QLoggingCategory::setFilterRules("easyeffects.debug=false");
+
+  /**
+   * Checking if there is already an instance running. This has to happen
+   * before any GUI initialization. Scripts and hotkey daemons call us many
+   * times a day just to send one line through the local socket, and for them
+   * QApplication, the icon theme and the color scheme manager are pure
+   * startup cost.
+   */
 
   auto lockFile = util::get_lock_file();
 
@@ -382,9 +450,63 @@ int main(int argc, char* argv[]) {
   if (!lockFile->isLocked()) {
     // Used only by an instance started when one is already running
 
+    QCoreApplication app(argc, argv);
+
+    initTranslations();
+
+    auto about = makeAboutData();
+
+    auto cmd_parser = std::make_unique<CommandLineParser>(about);
+
+    QObject::connect(cmd_parser.get(), &CommandLineParser::onReset, [&]() { db::Manager::self().resetAll(); });
+
     return runSecondaryInstance(about, app, *cmd_parser, show_window);
   }
 
+  /**
+   * The daemon only needs the audio engine and the local socket server. It
+   * never creates a QApplication, so neither widgets nor QML/Kirigami are
+   * initialized. Instances started later control it through the socket.
+   */
+
+  if (isDaemonRequested(argc, argv)) {
+    QCoreApplication app(argc, argv);
+
+    SignalHandler signalHandler;
+
+    initTranslations();
+
+    auto about = makeAboutData();
+
+    auto cmd_parser = std::make_unique<CommandLineParser>(about);
+
+    QObject::connect(cmd_parser.get(), &CommandLineParser::onReset, [&]() { db::Manager::self().resetAll(); });
+
+    return runDaemon(app, about, *cmd_parser);
+  }
+
+  QCoreApplication::setAttribute(Qt::AA_ShareOpenGLContexts);
+
+  KIconTheme::initTheme();
+
+  QApplication app(argc, argv);
+
+  SignalHandler signalHandler;
+
+  initTranslations();
+
+  auto about = makeAboutData();
+
+  QGuiApplication::setWindowIcon(QIcon::fromTheme(QStringLiteral(APPLICATION_ID)));
+
+  KColorSchemeManager::instance();
+
+  // Parsing command line options
+
+  auto cmd_parser = std::make_unique<CommandLineParser>(about);
+
+  QObject::connect(cmd_parser.get(), &CommandLineParser::onReset, [&]() { db::Manager::self().resetAll(); });
+
   cmd_parser->process(about, &app);
   cmd_parser->process_debug_option();  // if we take too long to process this one we will miss debug messages
   cmd_parser->process_hide_window(show_window);
@@ -414,6 +536,8 @@ int main(int argc, char* argv[]) {
 
   // Starting the local socket server
 
+  local_server->set_pipelines(core.sie.get(), core.soe.get());
+  local_server->set_measurement(core.measurement.get());
   local_server->startServer();  // it has to be done after "QApplication app(argc, argv)"
 
   QObject::connect(local_server.get(), &LocalServer::onQuitApp, [&]() { QApplication::quit(); });
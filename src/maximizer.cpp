@@ -60,6 +60,8 @@ Maximizer::Maximizer(const std::string& tag, pw::Manager* pipe_manager, Pipeline
 
   init_common_controls<DbMaximizer>(settings);
 
+  enable_oversampling();
+
   // specific plugin controls
 
   BIND_LV2_PORT("rel", release, setRelease, DbMaximizer::releaseChanged);
@@ -108,9 +110,11 @@ void Maximizer::setup() {
     return;
   }
 
-  lv2_wrapper->set_n_samples(n_samples);
+  setup_oversampling();
+
+  lv2_wrapper->set_n_samples(lv2_n_samples());
 
-  if (lv2_wrapper->has_instance() && rate == lv2_wrapper->get_rate()) {
+  if (lv2_wrapper->has_instance() && lv2_rate() == lv2_wrapper->get_rate()) {
     return;
   }
 
@@ -120,7 +124,7 @@ void Maximizer::setup() {
   QMetaObject::invokeMethod(
       baseWorker,
       [this] {
-        lv2_wrapper->create_instance(rate);
+        lv2_wrapper->create_instance(lv2_rate());
 
         std::scoped_lock<std::mutex> lock(data_mutex);
 
@@ -158,21 +162,22 @@ void Maximizer::process(std::span<float>& left_in,
     apply_gain(left_in, right_in, input_gain);
   }
 
-  lv2_wrapper->connect_data_ports(left_in, right_in, left_out, right_out);
-  lv2_wrapper->run();
+  run_lv2(left_in, right_in, left_out, right_out);
 
   if (output_gain != 1.0F) {
     apply_gain(left_out, right_out, output_gain);
   }
 
-  // This plugin gives the latency in number of samples
+  // This plugin gives the latency in number of samples at the rate its instance runs
 
   const auto lv = static_cast<uint>(lv2_wrapper->get_control_port_value("lv2_latency"));
 
-  if (latency_n_frames != lv) {
+  const auto latency = (static_cast<float>(lv) / static_cast<float>(lv2_rate())) + oversampling_latency();
+
+  if (latency_n_frames != lv || latency_value != latency) {
     latency_n_frames = lv;
 
-    latency_value = static_cast<float>(latency_n_frames) / static_cast<float>(rate);
+    latency_value = latency;
 
     util::debug(std::format("{}{} latency: {} s", log_tag, name.toStdString(), latency_value));
 
@@ -0,0 +1,582 @@
+/**
+ * Copyright © 2017-2026 Wellington Wallace
+ *
+ * This file is part of Easy Effects.
+ *
+ * Easy Effects is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Easy Effects is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "measurement.hpp"
+#include <fftw3.h>
+#include <qlist.h>
+#include <qnamespace.h>
+#include <qobject.h>
+#include <qpoint.h>
+#include <qqml.h>
+#include <qtimer.h>
+#include <qtypes.h>
+#include <sys/types.h>
+#include <KLocalizedString>
+#include <QString>
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <iterator>
+#include <mutex>
+#include <numbers>
+#include <span>
+#include <utility>
+#include <vector>
+#include "analysis_bus.hpp"
+#include "config.h"
+#include "easyeffects_db_test_signals.h"
+#include "effects_base.hpp"
+#include "pw_manager.hpp"
+#include "test_signals.hpp"
+#include "util.hpp"
+#include "worker_pool.hpp"
+
+namespace {
+
+constexpr float amplitude = 0.25F;  // -12 dBFS peak
+
+constexpr double band_start = 20.0;  // Hz
+
+constexpr uint pre_frames = 1024U;  // captured before the stimulus, so negative delays are still seen
+
+constexpr int timeout_ms = 10000;
+
+constexpr int n_points = 128;
+
+constexpr size_t response_size = 16384U;
+
+constexpr size_t response_pre = 64U;  // frames kept before the peak of the impulse response
+
+// Feedback masks of Galois LFSRs giving maximum length sequences, indexed by order.
+constexpr std::pair<uint, uint> mls_taps[] = {{18U, 0x20400U}, {17U, 0x12000U}, {16U, 0xD008U}, {15U, 0x6000U},
+                                              {14U, 0x2015U},  {13U, 0x100DU},  {12U, 0x829U}};
+
+auto next_power_of_two(const size_t& value) -> size_t {
+  size_t n = 1U;
+
+  while (n < value) {
+    n <<= 1U;
+  }
+
+  return n;
+}
+
+class Fft {
+ public:
+  explicit Fft(const size_t& n) : size(n), real(n), complex(n / 2U + 1U) {
+    std::scoped_lock<std::mutex> lock(util::fftw_lock());
+
+    auto* c = reinterpret_cast<fftwf_complex*>(complex.data());
+
+    forward = fftwf_plan_dft_r2c_1d(static_cast<int>(n), real.data(), c, FFTW_ESTIMATE);
+    backward = fftwf_plan_dft_c2r_1d(static_cast<int>(n), c, real.data(), FFTW_ESTIMATE);
+  }
+
+  Fft(const Fft&) = delete;
+  auto operator=(const Fft&) -> Fft& = delete;
+  Fft(const Fft&&) = delete;
+  auto operator=(const Fft&&) -> Fft& = delete;
+
+  ~Fft() {
+    std::scoped_lock<std::mutex> lock(util::fftw_lock());
+
+    fftwf_destroy_plan(forward);
+    fftwf_destroy_plan(backward);
+  }
+
+  // The input is zero padded to the size of the transform.
+  auto transform(std::span<const float> input) -> std::vector<std::complex<float>> {
+    std::ranges::fill(real, 0.0F);
+    std::copy_n(input.begin(), std::min(input.size(), size), real.begin());
+
+    fftwf_execute(forward);
+
+    return complex;
+  }
+
+  auto inverse(const std::vector<std::complex<float>>& spectrum) -> std::vector<float> {
+    complex = spectrum;
+
+    fftwf_execute(backward);
+
+    const auto scale = 1.0F / static_cast<float>(size);
+
+    std::ranges::for_each(real, [&](auto& v) { v *= scale; });
+
+    return real;
+  }
+
+ private:
+  size_t size;
+
+  std::vector<float> real;
+
+  std::vector<std::complex<float>> complex;
+
+  fftwf_plan forward = nullptr, backward = nullptr;
+};
+
+struct ChannelAnalysis {
+  bool valid = false;
+
+  double latency = 0.0;  // frames
+
+  QList<QPointF> response;
+};
+
+/**
+ * Regularized deconvolution of the capture by the stimulus. The regularization keeps the bins the stimulus does not
+ * excite from blowing up the noise.
+ */
+auto analyze_channel(Fft& fft,
+                     const std::vector<std::complex<float>>& stimulus_spectrum,
+                     const float& regularization,
+                     const std::vector<float>& captured,
+                     const uint& rate,
+                     const double& band_low,
+                     const double& band_high) -> ChannelAnalysis {
+  ChannelAnalysis output;
+
+  auto spectrum = fft.transform(captured);
+
+  for (size_t k = 0U; k < spectrum.size(); k++) {
+    const auto& x = stimulus_spectrum[k];
+
+    spectrum[k] = spectrum[k] * std::conj(x) / (std::norm(x) + regularization);
+  }
+
+  const auto ir = fft.inverse(spectrum);
+
+  // Only the part of the impulse response inside the captured window is causal.
+
+  const auto search_end = std::min(captured.size(), ir.size());
+
+  size_t peak = 0U;
+
+  for (size_t n = 1U; n < search_end; n++) {
+    if (std::fabs(ir[n]) > std::fabs(ir[peak])) {
+      peak = n;
+    }
+  }
+
+  if (std::fabs(ir[peak]) < 1e-3F) {
+    return output;  // nothing came back
+  }
+
+  double fraction = 0.0;
+
+  if (peak > 0U && peak + 1U < ir.size()) {
+    const double a = std::fabs(ir[peak - 1U]);
+    const double b = std::fabs(ir[peak]);
+    const double c = std::fabs(ir[peak + 1U]);
+
+    if (const double d = a - 2.0 * b + c; d != 0.0) {
+      fraction = 0.5 * (a - c) / d;
+    }
+  }
+
+  output.latency = static_cast<double>(peak) + fraction - static_cast<double>(pre_frames);
+
+  // Frequency response of the windowed impulse response around the peak.
+
+  const auto begin = peak > response_pre ? peak - response_pre : 0U;
+  const auto length = std::min(response_size, ir.size() - begin);
+  const auto fade = length / 4U;
+
+  std::vector<float> segment(response_size, 0.0F);
+
+  std::copy_n(ir.begin() + static_cast<std::ptrdiff_t>(begin), length, segment.begin());
+
+  for (size_t n = 0U; n < fade; n++) {
+    const auto w = 0.5 * (1.0 + std::cos(std::numbers::pi * static_cast<double>(n + 1U) / static_cast<double>(fade)));
+
+    segment[length - fade + n] *= static_cast<float>(w);
+  }
+
+  Fft response_fft(response_size);
+
+  const auto response = response_fft.transform(segment);
+
+  output.response.reserve(n_points);
+
+  for (int n = 0; n < n_points; n++) {
+    const auto f = band_low * std::pow(band_high / band_low, static_cast<double>(n) / (n_points - 1));
+
+    const auto bin =
+        std::min(response.size() - 1U, static_cast<size_t>(std::lround(f * response_size / static_cast<double>(rate))));
+
+    const auto magnitude = std::max(std::abs(response[bin]), 1e-6F);
+
+    output.response.append(QPointF(f, 20.0 * std::log10(magnitude)));
+  }
+
+  output.valid = true;
+
+  return output;
+}
+
+}  // namespace
+
+Measurement::Measurement(pw::Manager* pipe_manager, EffectsBase* pipeline)
+    : pm(pipe_manager), pipeline(pipeline), worker(new MeasurementWorker), timer(new QTimer(this)) {
+  qmlRegisterSingletonInstance<Measurement>("ee.pipeline", VERSION_MAJOR, VERSION_MINOR, "Measurement", this);
+
+  // A measurement keeps its worker busy for seconds.
+
+  WorkerPool::self().attach_dedicated(worker);
+
+  timer->setInterval(20);
+
+  connect(timer, &QTimer::timeout, this, &Measurement::on_timer);
+}
+
+Measurement::~Measurement() {
+  cancel();
+
+  WorkerPool::self().release(worker);
+
+  util::debug("destroyed");
+}
+
+bool Measurement::start(const int& stimulus_type) {
+  if (state != State::idle) {
+    return false;
+  }
+
+  this->stimulus_type = static_cast<Stimulus>(stimulus_type);
+
+  // When the user is not already playing a test signal we link the node just for the measurement.
+
+  linked_test_signals = !DbTestSignals::enable();
+
+  if (linked_test_signals) {
+    TestSignals::self(pm).set_state(true);
+  }
+
+  pipeline->analysis_bus->add_reader();
+
+  bus_start_position = pipeline->analysis_bus->get_write_position();
+
+  state = State::waiting_pipeline;
+
+  status = i18n("Measuring");
+  running = true;
+
+  Q_EMIT resultChanged();
+  Q_EMIT runningChanged();
+
+  clock.start();
+  timer->start();
+
+  util::debug("measurement started");
+
+  return true;
+}
+
+void Measurement::cancel() {
+  if (state == State::waiting_pipeline || state == State::playing) {
+    fail(i18n("The measurement was cancelled"));
+  }
+}
+
+void Measurement::on_timer() {
+  auto& ts = TestSignals::self(pm);
+  const auto& bus = pipeline->analysis_bus;
+
+  if (clock.elapsed() > timeout_ms) {
+    fail(i18n("The measurement timed out. The output pipeline must be linked to a device."));
+
+    return;
+  }
+
+  switch (state) {
+    case State::waiting_pipeline: {
+      // The stimulus is only sent after the pipeline has been running for a while at the rate of the test signals.
+
+      rate = bus->get_rate();
+
+      if (rate == 0U || ts.rate != rate || bus->get_write_position() < bus_start_position + rate / 10U) {
+        return;
+      }
+
+      const auto reported = static_cast<size_t>(pipeline->getPipeLineLatency()) * rate / 1000U;
+      const size_t max_window = AnalysisBus::capacity / 2U;
+
+      tail_frames = std::min(max_window / 3U, rate / 4U + 2U * reported);
+
+      if (!build_stimulus(max_window - tail_frames - pre_frames)) {
+        fail(i18n("The reported latency is too large to be measured"));
+
+        return;
+      }
+
+      clock_offset = bus->get_clock_offset();
+
+      ts.play_stimulus(stimulus);
+
+      state = State::playing;
+
+      break;
+    }
+    case State::playing: {
+      if (!ts.stimulus_started.load(std::memory_order_acquire)) {
+        return;
+      }
+
+      const auto start = static_cast<int64_t>(ts.stimulus_start_position.load(std::memory_order_relaxed)) -
+                         clock_offset - static_cast<int64_t>(pre_frames);
+
+      if (start < 0) {
+        fail(i18n("The output pipeline is not running"));
+
+        return;
+      }
+
+      const auto end = static_cast<uint64_t>(start) + pre_frames + stimulus.size() + tail_frames;
+
+      if (bus->get_write_position() < end) {
+        return;
+      }
+
+      capture();
+
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+auto Measurement::build_stimulus(const size_t& max_frames) -> bool {
+  band_low = band_start;
+  band_high = std::min(20000.0, 0.45 * rate);
+
+  stimulus.clear();
+
+  switch (stimulus_type) {
+    case Stimulus::log_sweep: {
+      // Exponential sine sweep as described by Farina, with short fades so the edges do not splatter.
+
+      const auto n = std::min(static_cast<size_t>(rate), max_frames);
+
+      if (n < rate / 4U) {
+        return false;
+      }
+
+      const auto duration = static_cast<double>(n) / rate;
+      const auto w1 = 2.0 * std::numbers::pi * band_low;
+      const auto w2 = 2.0 * std::numbers::pi * band_high;
+      const auto k = duration * w1 / std::log(w2 / w1);
+      const auto l = duration / std::log(w2 / w1);
+
+      stimulus.resize(n);
+
+      for (size_t i = 0U; i < n; i++) {
+        const auto t = static_cast<double>(i) / rate;
+
+        stimulus[i] = amplitude * static_cast<float>(std::sin(k * (std::exp(t / l) - 1.0)));
+      }
+
+      const auto fade = static_cast<size_t>(rate / 100U);
+
+      for (size_t i = 0U; i < fade; i++) {
+        const auto w = static_cast<float>(0.5 * (1.0 - std::cos(std::numbers::pi * static_cast<double>(i) / fade)));
+
+        stimulus[i] *= w;
+        stimulus[n - 1U - i] *= w;
+      }
+
+      break;
+    }
+    case Stimulus::mls: {
+      const auto* taps = std::ranges::find_if(
+          mls_taps, [&](const auto& t) { return (static_cast<size_t>(1U) << t.first) - 1U <= max_frames; });
+
+      if (taps == std::end(mls_taps)) {
+        return false;
+      }
+
+      const auto period = (1U << taps->first) - 1U;
+
+      stimulus.resize(period);
+
+      uint lfsr = 1U;
+
+      for (uint i = 0U; i < period; i++) {
+        stimulus[i] = (lfsr & 1U) != 0U ? amplitude : -amplitude;
+
+        lfsr = (lfsr & 1U) != 0U ? (lfsr >> 1U) ^ taps->second : lfsr >> 1U;
+      }
+
+      break;
+    }
+  }
+
+  util::debug(std::format("measurement stimulus with {} frames at {} Hz", stimulus.size(), rate));
+
+  return true;
+}
+
+void Measurement::capture() {
+  auto& ts = TestSignals::self(pm);
+  const auto& bus = pipeline->analysis_bus;
+
+  // A different offset means the pipeline skipped cycles after the stimulus was sent.
+
+  if (bus->get_clock_offset() != clock_offset) {
+    fail(i18n("The pipeline skipped cycles during the measurement. Try again with less load."));
+
+    return;
+  }
+
+  const auto window = pre_frames + stimulus.size() + tail_frames;
+  const auto start = static_cast<uint64_t>(static_cast<int64_t>(ts.stimulus_start_position.load()) - clock_offset) -
+                     pre_frames;
+
+  std::vector<float> left(window), right(window);
+
+  if (!bus->read(left, right, start + window)) {
+    fail(i18n("The captured audio was overwritten before it could be read"));
+
+    return;
+  }
+
+  release_pipeline();
+
+  state = State::analyzing;
+
+  Result r;
+
+  r.rate = rate;
+  r.reported_latency = static_cast<double>(pipeline->getPipeLineLatency());
+
+  // NOLINTBEGIN(clang-analyzer-cplusplus.NewDeleteLeaks)
+
+  QMetaObject::invokeMethod(
+      worker,
+      [this, r, source = stimulus, left = std::move(left), right = std::move(right), low = band_low,
+       high = band_high]() mutable {
+        Fft fft(next_power_of_two(left.size() + source.size()));
+
+        const auto x = fft.transform(source);
+
+        float max_power = 0.0F;
+
+        for (const auto& v : x) {
+          max_power = std::max(max_power, std::norm(v));
+        }
+
+        const auto regularization = 1e-4F * max_power;
+
+        const auto result_left = analyze_channel(fft, x, regularization, left, r.rate, low, high);
+        const auto result_right = analyze_channel(fft, x, regularization, right, r.rate, low, high);
+
+        if (!result_left.valid && !result_right.valid) {
+          r.error = i18n("The stimulus did not reach the end of the pipeline");
+        } else {
+          const auto to_ms = 1000.0 / r.rate;
+
+          r.latency_left = result_left.latency * to_ms;
+          r.latency_right = result_right.latency * to_ms;
+
+          if (result_left.valid && result_right.valid) {
+            r.measured_latency = 0.5 * (r.latency_left + r.latency_right);
+          } else {
+            r.measured_latency = result_left.valid ? r.latency_left : r.latency_right;
+          }
+
+          r.response_left = result_left.response;
+          r.response_right = result_right.response;
+
+          r.valid = true;
+        }
+
+        QMetaObject::invokeMethod(this, [this, r = std::move(r)]() { apply_result(r); }, Qt::QueuedConnection);
+      },
+      Qt::QueuedConnection);
+
+  // NOLINTEND(clang-analyzer-cplusplus.NewDeleteLeaks)
+}
+
+void Measurement::release_pipeline() {
+  timer->stop();
+
+  TestSignals::self(pm).stop_stimulus();
+
+  if (linked_test_signals && !DbTestSignals::enable()) {
+    TestSignals::self(pm).set_state(false);
+  }
+
+  linked_test_signals = false;
+
+  pipeline->analysis_bus->remove_reader();
+}
+
+void Measurement::fail(const QString& reason) {
+  if (state == State::waiting_pipeline || state == State::playing) {
+    release_pipeline();
+  }
+
+  util::warning(std::format("measurement failed: {}", reason.toStdString()));
+
+  Result r;
+
+  r.error = reason;
+
+  apply_result(r);
+}
+
+void Measurement::apply_result(Result r) {
+  result = std::move(r);
+
+  state = State::idle;
+
+  if (result.valid) {
+    measured_latency = result.measured_latency;
+    reported_latency = result.reported_latency;
+
+    status = i18n("Done");
+
+    util::debug(std::format("measured latency: {:.2f} ms, reported latency: {:.2f} ms", measured_latency,
+                            reported_latency));
+  } else {
+    status = result.error;
+  }
+
+  running = false;
+
+  Q_EMIT resultChanged();
+  Q_EMIT runningChanged();
+  Q_EMIT finished();
+}
+
+QList<QPointF> Measurement::getResponse(const int& channel) const {
+  return channel == 0 ? result.response_left : result.response_right;
+}
+
+auto Measurement::is_running() const -> bool {
+  return state != State::idle;
+}
+
+auto Measurement::get_result() const -> const Measurement::Result& {
+  return result;
+}
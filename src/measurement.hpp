@@ -0,0 +1,158 @@
+/**
+ * Copyright © 2017-2026 Wellington Wallace
+ *
+ * This file is part of Easy Effects.
+ *
+ * Easy Effects is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Easy Effects is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <qelapsedtimer.h>
+#include <qlist.h>
+#include <qobject.h>
+#include <qpoint.h>
+#include <qtimer.h>
+#include <qtmetamacros.h>
+#include <sys/types.h>
+#include <QString>
+#include <cstdint>
+#include <vector>
+#include "effects_base.hpp"
+#include "pw_manager.hpp"
+#include "worker_pool.hpp"
+
+class MeasurementWorker : public PoolWorker {
+  Q_OBJECT
+};
+
+/**
+ * End to end measurement of the output pipeline. The test signals node plays a logarithmic sweep or a maximum
+ * length sequence into our sink and what the pipeline outputs is read back from its analysis bus. Both ends are
+ * placed on the graph clock, so deconvolving the capture by the stimulus gives the impulse response of the whole
+ * path, with the real latency of the plugins and of the buffering between them, and its frequency response.
+ *
+ * Anything else playing to our sink at the same time ends up in the capture, so the measurement is only meaningful
+ * with the pipeline otherwise silent.
+ */
+class Measurement : public QObject {
+  Q_OBJECT
+
+  Q_PROPERTY(bool running MEMBER running NOTIFY runningChanged)
+
+  Q_PROPERTY(double measuredLatency MEMBER measured_latency NOTIFY resultChanged)
+
+  Q_PROPERTY(double reportedLatency MEMBER reported_latency NOTIFY resultChanged)
+
+  Q_PROPERTY(QString status MEMBER status NOTIFY resultChanged)
+
+ public:
+  Measurement(pw::Manager* pipe_manager, EffectsBase* pipeline);
+  Measurement(const Measurement&) = delete;
+  auto operator=(const Measurement&) -> Measurement& = delete;
+  Measurement(const Measurement&&) = delete;
+  auto operator=(const Measurement&&) -> Measurement& = delete;
+  ~Measurement() override;
+
+  enum class Stimulus { log_sweep, mls };
+
+  struct Result {
+    bool valid = false;
+
+    QString error;
+
+    uint rate = 0U;
+
+    double measured_latency = 0.0;  // ms
+
+    double reported_latency = 0.0;  // ms
+
+    double latency_left = 0.0, latency_right = 0.0;  // ms
+
+    QList<QPointF> response_left, response_right;  // Hz x dB
+  };
+
+  // Returns false if a measurement is already running.
+  Q_INVOKABLE bool start(const int& stimulus_type);
+
+  Q_INVOKABLE void cancel();
+
+  Q_INVOKABLE [[nodiscard]] QList<QPointF> getResponse(const int& channel) const;
+
+  [[nodiscard]] auto is_running() const -> bool;
+
+  [[nodiscard]] auto get_result() const -> const Result&;
+
+ Q_SIGNALS:
+  void runningChanged();
+
+  void resultChanged();
+
+  // Emitted when a measurement ends, successfully or not.
+  void finished();
+
+ private:
+  enum class State { idle, waiting_pipeline, playing, analyzing };
+
+  pw::Manager* pm = nullptr;
+
+  EffectsBase* pipeline = nullptr;
+
+  MeasurementWorker* worker;
+
+  QTimer* timer;
+
+  QElapsedTimer clock;
+
+  State state = State::idle;
+
+  Stimulus stimulus_type = Stimulus::log_sweep;
+
+  bool running = false;
+
+  bool linked_test_signals = false;
+
+  double measured_latency = 0.0;
+
+  double reported_latency = 0.0;
+
+  QString status;
+
+  Result result;
+
+  uint rate = 0U;
+
+  uint64_t bus_start_position = 0U;
+
+  int64_t clock_offset = 0;
+
+  size_t tail_frames = 0U;
+
+  double band_low = 0.0, band_high = 0.0;
+
+  // Read by the test signals realtime thread while the measurement is playing.
+  std::vector<float> stimulus;
+
+  void on_timer();
+
+  auto build_stimulus(const size_t& max_frames) -> bool;
+
+  void capture();
+
+  void release_pipeline();
+
+  void fail(const QString& reason);
+
+  void apply_result(Result r);
+};
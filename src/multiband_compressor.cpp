@@ -56,14 +56,7 @@ MultibandCompressor::MultibandCompressor(const std::string& tag,
                  true),
       settings(db::Manager::self().get_plugin_db<DbMultibandCompressor>(
           pipe_type,
-          tags::plugin_name::BaseName::multibandCompressor + "#" + instance_id)),
-      frequency_range_end(n_bands),
-      envelope_left(n_bands),
-      envelope_right(n_bands),
-      curve_left(n_bands),
-      curve_right(n_bands),
-      reduction_left(n_bands),
-      reduction_right(n_bands) {
+          tags::plugin_name::BaseName::multibandCompressor + "#" + instance_id)) {
   const auto lv2_plugin_uri = "http://lsp-plug.in/plugins/lv2/sc_mb_compressor_stereo";
 
   lv2_wrapper = std::make_unique<lv2::Lv2Wrapper>(lv2_plugin_uri);
@@ -72,10 +65,26 @@ MultibandCompressor::MultibandCompressor(const std::string& tag,
 
   if (!packageInstalled) {
     util::debug(std::format("{}{} is not installed", log_tag, lv2_plugin_uri));
+  } else {
+    meter_ports.latency = lv2_wrapper->get_control_port_index("out_latency");
+
+    for (uint n = 0U; n < n_bands; n++) {
+      const auto nstr = util::to_string(n);
+
+      meter_ports.frequency_range_end[n] = lv2_wrapper->get_control_port_index("fre_" + nstr);
+      meter_ports.envelope_left[n] = lv2_wrapper->get_control_port_index("elm_" + nstr + "l");
+      meter_ports.envelope_right[n] = lv2_wrapper->get_control_port_index("elm_" + nstr + "r");
+      meter_ports.curve_left[n] = lv2_wrapper->get_control_port_index("clm_" + nstr + "l");
+      meter_ports.curve_right[n] = lv2_wrapper->get_control_port_index("clm_" + nstr + "r");
+      meter_ports.reduction_left[n] = lv2_wrapper->get_control_port_index("rlm_" + nstr + "l");
+      meter_ports.reduction_right[n] = lv2_wrapper->get_control_port_index("rlm_" + nstr + "r");
+    }
   }
 
   init_common_controls<DbMultibandCompressor>(settings);
 
+  enable_lv2_extra_channels();
+
   // specific plugin controls
 
   connect(settings, &DbMultibandCompressor::sidechainInputDeviceChanged, [&]() { update_sidechain_links(); });
@@ -272,7 +281,7 @@ void MultibandCompressor::process(std::span<float>& left_in,
 
   // This plugin gives the latency in number of samples
 
-  const auto lv = static_cast<uint>(lv2_wrapper->get_control_port_value("out_latency"));
+  const auto lv = static_cast<uint>(lv2_wrapper->get_control_port_value(meter_ports.latency));
 
   if (latency_n_frames != lv) {
     latency_n_frames = lv;
@@ -287,20 +296,22 @@ void MultibandCompressor::process(std::span<float>& left_in,
   if (updateLevelMeters) {
     get_peaks(left_in, right_in, left_out, right_out);
 
-    for (uint n = 0U; n < n_bands; n++) {
-      const auto nstr = util::to_string(n);
+    Meters m;
 
-      frequency_range_end[n] = lv2_wrapper->get_control_port_value("fre_" + nstr);
+    for (uint n = 0U; n < n_bands; n++) {
+      m.frequency_range_end[n] = lv2_wrapper->get_control_port_value(meter_ports.frequency_range_end[n]);
 
-      envelope_left[n] = util::linear_to_db(lv2_wrapper->get_control_port_value("elm_" + nstr + "l"));
-      envelope_right[n] = util::linear_to_db(lv2_wrapper->get_control_port_value("elm_" + nstr + "r"));
+      m.envelope_left[n] = util::linear_to_db(lv2_wrapper->get_control_port_value(meter_ports.envelope_left[n]));
+      m.envelope_right[n] = util::linear_to_db(lv2_wrapper->get_control_port_value(meter_ports.envelope_right[n]));
 
-      curve_left[n] = util::linear_to_db(lv2_wrapper->get_control_port_value("clm_" + nstr + "l"));
-      curve_right[n] = util::linear_to_db(lv2_wrapper->get_control_port_value("clm_" + nstr + "r"));
+      m.curve_left[n] = util::linear_to_db(lv2_wrapper->get_control_port_value(meter_ports.curve_left[n]));
+      m.curve_right[n] = util::linear_to_db(lv2_wrapper->get_control_port_value(meter_ports.curve_right[n]));
 
-      reduction_left[n] = util::linear_to_db(lv2_wrapper->get_control_port_value("rlm_" + nstr + "l"));
-      reduction_right[n] = util::linear_to_db(lv2_wrapper->get_control_port_value("rlm_" + nstr + "r"));
+      m.reduction_left[n] = util::linear_to_db(lv2_wrapper->get_control_port_value(meter_ports.reduction_left[n]));
+      m.reduction_right[n] = util::linear_to_db(lv2_wrapper->get_control_port_value(meter_ports.reduction_right[n]));
     }
+
+    meters.write(m);
   }
 }
 
@@ -347,30 +358,48 @@ auto MultibandCompressor::get_latency_seconds() -> float {
   return this->latency_value;
 }
 
+void MultibandCompressor::refreshMeters() {
+  meters.read();
+}
+
 QList<float> MultibandCompressor::getFrequencyRangeEnd() const {
-  return frequency_range_end;
+  const auto& values = meters.latest().frequency_range_end;
+
+  return QList<float>(values.begin(), values.end());
 }
 
 QList<float> MultibandCompressor::getEnvelopeLevelLeft() const {
-  return envelope_left;
+  const auto& values = meters.latest().envelope_left;
+
+  return QList<float>(values.begin(), values.end());
 }
 
 QList<float> MultibandCompressor::getEnvelopeLevelRight() const {
-  return envelope_right;
+  const auto& values = meters.latest().envelope_right;
+
+  return QList<float>(values.begin(), values.end());
 }
 
 QList<float> MultibandCompressor::getCurveLevelLeft() const {
-  return curve_left;
+  const auto& values = meters.latest().curve_left;
+
+  return QList<float>(values.begin(), values.end());
 }
 
 QList<float> MultibandCompressor::getCurveLevelRight() const {
-  return curve_right;
+  const auto& values = meters.latest().curve_right;
+
+  return QList<float>(values.begin(), values.end());
 }
 
 QList<float> MultibandCompressor::getReductionLevelLeft() const {
-  return reduction_left;
+  const auto& values = meters.latest().reduction_left;
+
+  return QList<float>(values.begin(), values.end());
 }
 
 QList<float> MultibandCompressor::getReductionLevelRight() const {
-  return reduction_right;
+  const auto& values = meters.latest().reduction_right;
+
+  return QList<float>(values.begin(), values.end());
 }
@@ -25,6 +25,7 @@
 #include <qtmetamacros.h>
 #include <sys/types.h>
 #include <QString>
+#include <array>
 #include <span>
 #include <string>
 #include <vector>
@@ -33,6 +34,7 @@
 #include "plugin_base.hpp"
 #include "pw_manager.hpp"
 #include "tags_multiband_compressor.hpp"
+#include "triple_buffer.hpp"
 
 class MultibandCompressor : public PluginBase {
   Q_OBJECT
@@ -69,6 +71,9 @@ class MultibandCompressor : public PluginBase {
 
   void update_probe_links() override;
 
+  // Takes the newest meter snapshot. Every getter below returns values from it until the next call.
+  Q_INVOKABLE void refreshMeters();
+
   Q_INVOKABLE [[nodiscard]] QList<float> getFrequencyRangeEnd() const;
 
   Q_INVOKABLE [[nodiscard]] QList<float> getEnvelopeLevelLeft() const;
@@ -89,8 +94,23 @@ class MultibandCompressor : public PluginBase {
 
   DbMultibandCompressor* settings = nullptr;
 
-  QList<float> frequency_range_end, envelope_left, envelope_right, curve_left, curve_right, reduction_left,
-      reduction_right;
+  struct Meters {
+    std::array<float, n_bands> frequency_range_end{};
+    std::array<float, n_bands> envelope_left{}, envelope_right{};
+    std::array<float, n_bands> curve_left{}, curve_right{};
+    std::array<float, n_bands> reduction_left{}, reduction_right{};
+  };
+
+  // Indices of the ports read on every cycle. They are resolved once so the realtime thread does no string work.
+  struct MeterPorts {
+    uint latency = 0U;
+    std::array<uint, n_bands> frequency_range_end{};
+    std::array<uint, n_bands> envelope_left{}, envelope_right{};
+    std::array<uint, n_bands> curve_left{}, curve_right{};
+    std::array<uint, n_bands> reduction_left{}, reduction_right{};
+  } meter_ports;
+
+  TripleBuffer<Meters> meters;
 
   std::vector<pw_proxy*> list_proxies;
 
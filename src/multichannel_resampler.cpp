@@ -0,0 +1,306 @@
+/**
+ * Copyright © 2017-2026 Wellington Wallace
+ *
+ * This file is part of Easy Effects.
+ *
+ * Easy Effects is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Easy Effects is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "multichannel_resampler.hpp"
+#include <speex/speex_resampler.h>
+#include <sys/types.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <format>
+#include <numbers>
+#include <numeric>
+#include <span>
+#include "util.hpp"
+
+namespace {
+
+// Above this many phases the coefficient table gets too large and speex is used instead.
+
+constexpr uint max_polyphase_phases = 320U;
+
+/**
+ * Filter length at the input rate, cutoff relative to the lower Nyquist
+ * frequency and Kaiser beta for every quality. These are the values of the
+ * speex quality table, so a given quality gives the same filter on both paths.
+ */
+
+struct QualityMapping {
+  size_t base_length;
+
+  double downsample_bandwidth;
+
+  double upsample_bandwidth;
+
+  double beta;
+};
+
+constexpr std::array<QualityMapping, 11> quality_map = {{{8U, 0.830, 0.860, 6.0},
+                                                         {16U, 0.850, 0.880, 6.0},
+                                                         {32U, 0.882, 0.910, 6.0},
+                                                         {48U, 0.895, 0.917, 8.0},
+                                                         {64U, 0.921, 0.940, 8.0},
+                                                         {80U, 0.922, 0.940, 10.0},
+                                                         {96U, 0.940, 0.945, 10.0},
+                                                         {128U, 0.950, 0.950, 10.0},
+                                                         {160U, 0.960, 0.960, 10.0},
+                                                         {192U, 0.968, 0.968, 12.0},
+                                                         {256U, 0.975, 0.975, 12.0}}};
+
+// Zeroth order modified Bessel function of the first kind, used by the Kaiser window.
+
+auto bessel_i0(const double& x) -> double {
+  double sum = 1.0;
+  double term = 1.0;
+
+  for (int k = 1; k < 64; k++) {
+    term *= (x / (2.0 * k)) * (x / (2.0 * k));
+
+    sum += term;
+
+    if (term < sum * 1e-12) {
+      break;
+    }
+  }
+
+  return sum;
+}
+
+}  // namespace
+
+MultichannelResampler::MultichannelResampler(const uint& n_channels,
+                                             const uint& input_rate,
+                                             const uint& output_rate,
+                                             const size_t& max_input_frames,
+                                             const int& quality)
+    : n_channels(n_channels),
+      input_rate(input_rate),
+      output_rate(output_rate),
+      max_input_frames(std::max<size_t>(max_input_frames, 1U)) {
+  const auto divisor = std::gcd(input_rate, output_rate);
+
+  if (divisor == 0U || n_channels == 0U) {
+    util::warning(std::format("invalid resampler configuration: {} channels, {} Hz -> {} Hz", n_channels, input_rate,
+                              output_rate));
+
+    return;
+  }
+
+  up_factor = output_rate / divisor;
+  down_factor = input_rate / divisor;
+
+  if (up_factor <= max_polyphase_phases) {
+    build_polyphase_filter(quality);
+
+    return;
+  }
+
+  int err = 0;
+
+  state = speex_resampler_init(n_channels, input_rate, output_rate, quality, &err);
+
+  if (!state || err != RESAMPLER_ERR_SUCCESS) {
+    util::warning(std::format("error while initializing speex resampler: {}", speex_resampler_strerror(err)));
+  }
+}
+
+MultichannelResampler::~MultichannelResampler() {
+  if (state) {
+    speex_resampler_destroy(state);
+  }
+}
+
+void MultichannelResampler::set_quality(const int& value) {
+  if (state) {
+    speex_resampler_set_quality(state, value);
+  } else if (!coefficients.empty()) {
+    build_polyphase_filter(value);
+  }
+}
+
+auto MultichannelResampler::output_frames(const size_t& input_frames) const -> size_t {
+  return ((input_frames * up_factor + down_factor - 1U) / down_factor) + 1U;
+}
+
+auto MultichannelResampler::max_output_frames() const -> size_t {
+  return output_frames(max_input_frames);
+}
+
+auto MultichannelResampler::uses_polyphase() const -> bool {
+  return !coefficients.empty();
+}
+
+void MultichannelResampler::build_polyphase_filter(const int& quality) {
+  /**
+   * Kaiser windowed sinc prototype designed at the upsampled rate and split in
+   * up_factor phases. Like speex, downsampling stretches the filter by the
+   * rate ratio so that the transition band stays the same fraction of the
+   * output Nyquist frequency.
+   */
+
+  const auto& mapping = quality_map[std::clamp(quality, 0, 10)];
+
+  auto bandwidth = mapping.upsample_bandwidth;
+
+  taps = mapping.base_length;
+
+  if (down_factor > up_factor) {
+    bandwidth = mapping.downsample_bandwidth * static_cast<double>(up_factor) / static_cast<double>(down_factor);
+
+    // Rounded up to a multiple of 8 like in speex. The inner product relies on it.
+
+    taps = (((mapping.base_length * down_factor / up_factor) - 1U) & ~static_cast<size_t>(7U)) + 8U;
+  }
+
+  const auto length = taps * up_factor;
+  const auto cutoff = 0.5 * bandwidth / static_cast<double>(up_factor);
+  const auto center = static_cast<double>(length - 1U) / 2.0;
+  const auto window_norm = bessel_i0(mapping.beta);
+
+  coefficients.resize(length);
+
+  for (size_t p = 0U; p < up_factor; p++) {
+    for (size_t k = 0U; k < taps; k++) {
+      const auto x = static_cast<double>((k * up_factor) + p) - center;
+
+      const auto arg = 2.0 * std::numbers::pi * cutoff * x;
+
+      const auto sinc = (x == 0.0) ? 1.0 : std::sin(arg) / arg;
+
+      const auto r = (length > 1U) ? 2.0 * x / static_cast<double>(length - 1U) : 0.0;
+
+      const auto window = bessel_i0(mapping.beta * std::sqrt(std::max(0.0, 1.0 - (r * r)))) / window_norm;
+
+      // Stored reversed so that the inner product walks the history forward.
+
+      coefficients[(p * taps) + (taps - 1U - k)] = static_cast<float>(2.0 * cutoff * sinc * window * up_factor);
+    }
+  }
+
+  history.resize(n_channels);
+
+  for (auto& h : history) {
+    h.assign(taps - 1U + max_input_frames, 0.0F);
+  }
+
+  input_index = 0U;
+  phase = 0U;
+}
+
+auto MultichannelResampler::process(std::span<const float* const> input,
+                                    const size_t& n_frames,
+                                    std::span<float* const> output,
+                                    const size_t& out_capacity) -> size_t {
+  if (input.size() < n_channels || output.size() < n_channels) {
+    return 0U;
+  }
+
+  if (!coefficients.empty()) {
+    return process_polyphase(input, n_frames, output, out_capacity);
+  }
+
+  if (!state) {
+    return 0U;
+  }
+
+  spx_uint32_t produced = 0U;
+
+  for (uint ch = 0U; ch < n_channels; ch++) {
+    spx_uint32_t in_len = n_frames;
+    spx_uint32_t out_len = out_capacity;
+
+    speex_resampler_process_float(state, ch, input[ch], &in_len, output[ch], &out_len);
+
+    produced = out_len;
+  }
+
+  return produced;
+}
+
+auto MultichannelResampler::process(std::span<const float> left_in,
+                                    std::span<const float> right_in,
+                                    std::span<float> left_out,
+                                    std::span<float> right_out) -> size_t {
+  const std::array<const float*, 2U> input = {left_in.data(), right_in.data()};
+  const std::array<float*, 2U> output = {left_out.data(), right_out.data()};
+
+  return process(input, std::min(left_in.size(), right_in.size()), output,
+                 std::min(left_out.size(), right_out.size()));
+}
+
+auto MultichannelResampler::process_polyphase(std::span<const float* const> input,
+                                              const size_t& n_frames,
+                                              std::span<float* const> output,
+                                              const size_t& out_capacity) -> size_t {
+  const auto history_length = taps - 1U;
+
+  size_t produced = 0U;
+
+  for (size_t offset = 0U; offset < n_frames;) {
+    const auto count = std::min(n_frames - offset, max_input_frames);
+
+    for (uint ch = 0U; ch < n_channels; ch++) {
+      std::copy_n(input[ch] + offset, count, history[ch].begin() + static_cast<long>(history_length));
+    }
+
+    while (input_index < count) {
+      /**
+       * Outputs that do not fit are dropped but the filter still advances, so
+       * that the timing stays consistent for the next call.
+       */
+
+      if (produced < out_capacity) {
+        const auto* h = coefficients.data() + (static_cast<size_t>(phase) * taps);
+
+        for (uint ch = 0U; ch < n_channels; ch++) {
+          const auto* x = history[ch].data() + input_index;
+
+          // taps is a multiple of 8, so independent partial sums let the compiler vectorize the loop.
+
+          std::array<float, 8U> acc{};
+
+          for (size_t k = 0U; k < taps; k += 8U) {
+            for (size_t j = 0U; j < 8U; j++) {
+              acc[j] += x[k + j] * h[k + j];
+            }
+          }
+
+          output[ch][produced] = std::accumulate(acc.begin(), acc.end(), 0.0F);
+        }
+
+        produced++;
+      }
+
+      phase += down_factor;
+      input_index += phase / up_factor;
+      phase %= up_factor;
+    }
+
+    input_index -= count;
+
+    for (auto& h : history) {
+      std::copy_n(h.begin() + static_cast<long>(count), history_length, h.begin());
+    }
+
+    offset += count;
+  }
+
+  return produced;
+}
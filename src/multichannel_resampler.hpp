@@ -0,0 +1,110 @@
+/**
+ * Copyright © 2017-2026 Wellington Wallace
+ *
+ * This file is part of Easy Effects.
+ *
+ * Easy Effects is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Easy Effects is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <speex/speex_resampler.h>
+#include <sys/types.h>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+/**
+ * Resampler for a fixed number of planar channels that writes into buffers
+ * owned by the caller. Rate pairs with a small reduced ratio, like 44.1 <-> 48
+ * kHz (160/147) or 48 <-> 96 kHz (2/1), use a precomputed polyphase filter.
+ * Other pairs go through a single speex state shared by all channels.
+ *
+ * Everything is allocated in the constructor and in set_quality, so process
+ * can be called from the realtime thread.
+ */
+class MultichannelResampler {
+ public:
+  MultichannelResampler(const uint& n_channels,
+                        const uint& input_rate,
+                        const uint& output_rate,
+                        const size_t& max_input_frames,
+                        const int& quality = SPEEX_RESAMPLER_QUALITY_DESKTOP);
+  MultichannelResampler(const MultichannelResampler&) = delete;
+  auto operator=(const MultichannelResampler&) -> MultichannelResampler& = delete;
+  MultichannelResampler(const MultichannelResampler&&) = delete;
+  auto operator=(const MultichannelResampler&&) -> MultichannelResampler& = delete;
+  ~MultichannelResampler();
+
+  void set_quality(const int& value);
+
+  /**
+   * Upper bound of the frames produced for input_frames of input. Output
+   * buffers with at least this size never drop samples.
+   */
+  [[nodiscard]] auto output_frames(const size_t& input_frames) const -> size_t;
+
+  [[nodiscard]] auto max_output_frames() const -> size_t;
+
+  [[nodiscard]] auto uses_polyphase() const -> bool;
+
+  /**
+   * Resamples n_frames of every channel in input and writes the result to the
+   * matching channel in output, each one holding out_capacity frames. Returns
+   * the number of frames written per channel.
+   */
+  auto process(std::span<const float* const> input,
+               const size_t& n_frames,
+               std::span<float* const> output,
+               const size_t& out_capacity) -> size_t;
+
+  auto process(std::span<const float> left_in,
+               std::span<const float> right_in,
+               std::span<float> left_out,
+               std::span<float> right_out) -> size_t;
+
+ private:
+  uint n_channels = 0U;
+  uint input_rate = 0U;
+  uint output_rate = 0U;
+
+  size_t max_input_frames = 0U;
+
+  // Reduced ratio. The signal is upsampled by up_factor and decimated by down_factor.
+
+  uint up_factor = 1U;
+  uint down_factor = 1U;
+
+  // Polyphase state
+
+  size_t taps = 0U;  // Coefficients per phase
+
+  size_t input_index = 0U;  // Position of the next output in the current block
+  uint phase = 0U;
+
+  std::vector<float> coefficients;  // up_factor phases of taps coefficients in reversed order
+
+  std::vector<std::vector<float>> history;  // taps - 1 past frames followed by the current block
+
+  // speex fallback
+
+  SpeexResamplerState* state = nullptr;
+
+  void build_polyphase_filter(const int& quality);
+
+  auto process_polyphase(std::span<const float* const> input,
+                         const size_t& n_frames,
+                         std::span<float* const> output,
+                         const size_t& out_capacity) -> size_t;
+};
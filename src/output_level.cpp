@@ -20,16 +20,24 @@
 #include "output_level.hpp"
 #include <algorithm>
 #include <format>
+#include <memory>
 #include <span>
 #include <string>
+#include <utility>
+#include "analysis_bus.hpp"
 #include "pipeline_type.hpp"
 #include "plugin_base.hpp"
 #include "pw_manager.hpp"
 #include "tags_plugin_name.hpp"
 #include "util.hpp"
 
-OutputLevel::OutputLevel(const std::string& tag, pw::Manager* pipe_manager, PipelineType pipe_type, QString instance_id)
-    : PluginBase(tag, "output_level", tags::plugin_package::Package::ee, instance_id, pipe_manager, pipe_type) {}
+OutputLevel::OutputLevel(const std::string& tag,
+                         pw::Manager* pipe_manager,
+                         PipelineType pipe_type,
+                         QString instance_id,
+                         std::shared_ptr<AnalysisBus> analysis_bus)
+    : PluginBase(tag, "output_level", tags::plugin_package::Package::ee, instance_id, pipe_manager, pipe_type),
+      analysis_bus(std::move(analysis_bus)) {}
 
 OutputLevel::~OutputLevel() {
   if (connected_to_pw) {
@@ -75,6 +83,12 @@ void OutputLevel::process(std::span<float>& left_in,
   if (updateLevelMeters) {
     get_peaks(left_in, right_in, left_out, right_out);
   }
+
+  // This is the last node of the pipeline. Its output is what the analyzers attached to the bus see.
+
+  if (analysis_bus != nullptr) {
+    analysis_bus->publish(left_out, right_out, rate, clock_position);
+  }
 }
 
 void OutputLevel::process([[maybe_unused]] std::span<float>& left_in,
@@ -20,15 +20,21 @@
 #pragma once
 
 #include <QString>
+#include <memory>
 #include <span>
 #include <string>
+#include "analysis_bus.hpp"
 #include "pipeline_type.hpp"
 #include "plugin_base.hpp"
 #include "pw_manager.hpp"
 
 class OutputLevel : public PluginBase {
  public:
-  OutputLevel(const std::string& tag, pw::Manager* pipe_manager, PipelineType pipe_type, QString instance_id);
+  OutputLevel(const std::string& tag,
+              pw::Manager* pipe_manager,
+              PipelineType pipe_type,
+              QString instance_id,
+              std::shared_ptr<AnalysisBus> analysis_bus);
   OutputLevel(const OutputLevel&) = delete;
   auto operator=(const OutputLevel&) -> OutputLevel& = delete;
   OutputLevel(const OutputLevel&&) = delete;
@@ -54,4 +60,7 @@ class OutputLevel : public PluginBase {
                std::span<float>& probe_right) override;
 
   auto get_latency_seconds() -> float override;
+
+ private:
+  std::shared_ptr<AnalysisBus> analysis_bus;
 };
@@ -23,6 +23,7 @@
 #include <soundtouch/STTypes.h>
 #include <soundtouch/SoundTouch.h>
 #include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <format>
 #include <mutex>
@@ -133,9 +134,6 @@ void Pitch::setup() {
           data.resize(2U * static_cast<size_t>(n_samples));
         }
 
-        deque_out_L.resize(0U);
-        deque_out_R.resize(0U);
-
         init_soundtouch();
 
         std::scoped_lock<std::mutex> lock(data_mutex);
@@ -162,64 +160,66 @@ void Pitch::process(std::span<float>& left_in,
     apply_gain(left_in, right_in, input_gain);
   }
 
-  for (size_t n = 0U; n < left_in.size(); n++) {
-    data[n * 2U] = left_in[n];
-    data[(n * 2U) + 1U] = right_in[n];
-  }
+  interleave(left_in, right_in);
 
   snd_touch->putSamples(data.data(), n_samples);
 
-  uint n_received = 0U;
+  /**
+   * The processed frames are not copied out of SoundTouch. Its output FIFO is read in place through ptrBegin and
+   * only the frames written to our output buffers are removed from it. Whatever is left stays there for the next
+   * quantum.
+   */
 
-  do {
-    n_received = snd_touch->receiveSamples(data.data(), n_samples);
+  const auto n_available = snd_touch->numSamples();
 
-    for (size_t n = 0U; n < n_received; n++) {
-      deque_out_L.push_back(data[n * 2U]);
-      deque_out_R.push_back(data[(n * 2U) + 1U]);
-    }
+  if (n_available >= n_samples) {
+    deinterleave(snd_touch->ptrBegin(), left_out, right_out, 0U, n_samples);
+
+    snd_touch->receiveSamples(n_samples);
+  } else {
+    /**
+     * Not enough frames. This happens while SoundTouch fills its processing window or after an underrun. The
+     * missing frames are padded with silence at the beginning of the buffer and, as the output is now delayed by
+     * this amount, it is added to the latency. When the tempo or the rate is changed the output is not aligned
+     * to the input anymore and only the last padding is reported.
+     */
 
-  } while (n_received != 0);
+    const uint offset = n_samples - n_available;
 
-  if (deque_out_L.size() >= left_out.size()) {
-    for (float& v : left_out) {
-      v = deque_out_L.front();
+    const auto previous_latency = latency_n_frames;
 
-      deque_out_L.pop_front();
+    if (time_stretching.load(std::memory_order_relaxed)) {
+      latency_n_frames = 0U;
     }
 
-    for (float& v : right_out) {
-      v = deque_out_R.front();
+    std::fill_n(left_out.begin(), offset, 0.0F);
+    std::fill_n(right_out.begin(), offset, 0.0F);
 
-      deque_out_R.pop_front();
+    if (n_available != 0U) {
+      deinterleave(snd_touch->ptrBegin(), left_out, right_out, offset, n_available);
+
+      snd_touch->receiveSamples(n_available);
     }
-  } else {
-    const uint offset = left_out.size() - deque_out_L.size();
 
-    if (offset != latency_n_frames) {
-      latency_n_frames = offset;
+    latency_n_frames += offset;
 
-      notify_latency = true;
-    }
+    // While time stretching the same padding repeats on every underrun. Only a different value is worth reporting.
 
-    for (uint n = 0U; !deque_out_L.empty() && n < left_out.size(); n++) {
-      if (n < offset) {
-        left_out[n] = 0.0F;
-        right_out[n] = 0.0F;
-      } else {
-        left_out[n] = deque_out_L.front();
-        right_out[n] = deque_out_R.front();
-
-        deque_out_R.pop_front();
-        deque_out_L.pop_front();
-      }
+    if (latency_n_frames != previous_latency) {
+      notify_latency = true;
     }
   }
 
-  for (size_t n = 0; n < left_out.size(); n++) {
-    left_out[n] = (wet * left_out[n]) + (dry * left_in[n]);
+  {
+    float* __restrict l_out = left_out.data();
+    float* __restrict r_out = right_out.data();
+    const float* __restrict l_in = left_in.data();
+    const float* __restrict r_in = right_in.data();
 
-    right_out[n] = (wet * right_out[n]) + (dry * right_in[n]);
+    for (uint n = 0U; n < n_samples; n++) {
+      l_out[n] = (wet * l_out[n]) + (dry * l_in[n]);
+      r_out[n] = (wet * r_out[n]) + (dry * r_in[n]);
+    }
   }
 
   if (output_gain != 1.0F) {
@@ -241,6 +241,32 @@ void Pitch::process(std::span<float>& left_in,
   }
 }
 
+void Pitch::interleave(const std::span<float>& left_in, const std::span<float>& right_in) {
+  const float* __restrict l = left_in.data();
+  const float* __restrict r = right_in.data();
+  float* __restrict out = data.data();
+
+  for (uint n = 0U; n < n_samples; n++) {
+    out[2U * n] = l[n];
+    out[(2U * n) + 1U] = r[n];
+  }
+}
+
+void Pitch::deinterleave(const float* interleaved,
+                         std::span<float>& left_out,
+                         std::span<float>& right_out,
+                         const uint& offset,
+                         const uint& count) {
+  const float* __restrict in = interleaved;
+  float* __restrict l = left_out.data() + offset;
+  float* __restrict r = right_out.data() + offset;
+
+  for (uint n = 0U; n < count; n++) {
+    l[n] = in[2U * n];
+    r[n] = in[(2U * n) + 1U];
+  }
+}
+
 void Pitch::process([[maybe_unused]] std::span<float>& left_in,
                     [[maybe_unused]] std::span<float>& right_in,
                     [[maybe_unused]] std::span<float>& left_out,
@@ -316,6 +342,8 @@ void Pitch::set_tempo_difference() {
   std::scoped_lock<std::mutex> lock(data_mutex);
 
   snd_touch->setTempoChange(settings->tempoDifference());
+
+  time_stretching = settings->tempoDifference() != 0.0 || settings->rateDifference() != 0.0;
 }
 
 void Pitch::set_rate_difference() {
@@ -326,6 +354,8 @@ void Pitch::set_rate_difference() {
   std::scoped_lock<std::mutex> lock(data_mutex);
 
   snd_touch->setRateChange(settings->rateDifference());
+
+  time_stretching = settings->tempoDifference() != 0.0 || settings->rateDifference() != 0.0;
 }
 
 void Pitch::init_soundtouch() {
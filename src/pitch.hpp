@@ -25,7 +25,7 @@
 #include <qtypes.h>
 #include <soundtouch/STTypes.h>
 #include <soundtouch/SoundTouch.h>
-#include <deque>
+#include <atomic>
 #include <span>
 #include <string>
 #include <vector>
@@ -81,13 +81,13 @@ class Pitch : public PluginBase {
   bool soundtouch_ready = false;
   bool notify_latency = false;
 
+  std::atomic<bool> time_stretching = false;
+
   uint latency_n_frames = 0U;
 
   float dry = 0.0F, wet = 1.0F;
 
-  std::vector<float> data_L, data_R, data;
-
-  std::deque<float> deque_out_L, deque_out_R;
+  std::vector<float> data;
 
   soundtouch::SoundTouch* snd_touch = nullptr;
 
@@ -100,4 +100,12 @@ class Pitch : public PluginBase {
   void set_tempo_difference();
   void set_rate_difference();
   void init_soundtouch();
+
+  void interleave(const std::span<float>& left_in, const std::span<float>& right_in);
+
+  static void deinterleave(const float* interleaved,
+                           std::span<float>& left_out,
+                           std::span<float>& right_out,
+                           const uint& offset,
+                           const uint& count);
 };
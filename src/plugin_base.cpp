@@ -26,7 +26,6 @@
 #include <pipewire/thread-loop.h>
 #include <qnamespace.h>
 #include <qobjectdefs.h>
-#include <qthread.h>
 #include <qtimer.h>
 #include <spa/node/io.h>
 #include <spa/param/latency-utils.h>
@@ -48,16 +47,21 @@
 #include <cstddef>
 #include <cstdint>
 #include <format>
+#include <mutex>
+#include <numbers>
 #include <span>
 #include <string>
 #include <thread>
 #include <utility>
+#include <vector>
+#include "channel_layout.hpp"
 #include "db_manager.hpp"
 #include "pipeline_type.hpp"
 #include "pw_manager.hpp"
 #include "tags_app.hpp"
 #include "tags_plugin_name.hpp"
 #include "util.hpp"
+#include "worker_pool.hpp"
 
 namespace {
 
@@ -99,9 +103,29 @@ void on_process(void* userdata, spa_io_position* position) {
     d->pb->got_null_right_out = false;
     d->pb->got_null_probe = false;
 
+    d->pb->expected_clock_position = 0U;
+
+    d->pb->setup_extra_channels();
+
     d->pb->setup();
   }
 
+  /**
+   * The graph clock advances by one quantum per cycle. A short jump means that
+   * cycles were skipped. Long jumps are the driver being suspended and resumed.
+   */
+
+  const auto clock_position = position->clock.position;
+
+  d->pb->clock_position = clock_position;
+
+  if (d->pb->expected_clock_position != 0U && clock_position > d->pb->expected_clock_position &&
+      clock_position - d->pb->expected_clock_position < rate) {
+    d->pb->xruns.fetch_add(1U, std::memory_order_relaxed);
+  }
+
+  d->pb->expected_clock_position = clock_position + n_samples;
+
   // util::warning("Processing: " + util::to_string(n_samples));
 
   auto* in_left = static_cast<float*>(pw_filter_get_dsp_buffer(d->in_left, n_samples));
@@ -181,6 +205,30 @@ void on_process(void* userdata, spa_io_position* position) {
     right_out = d->pb->dummy_right;
   }
 
+  if (!d->in_extra.empty()) {
+    // setup_extra_channels() sized the dummy arrays for this quantum.
+
+    auto dummy_in = std::span(d->pb->dummy_extra_in).first(n_samples);
+    auto dummy_out = std::span(d->pb->dummy_extra_out).first(n_samples);
+
+    for (size_t n = 0U; n < d->in_extra.size(); n++) {
+      auto* in = static_cast<float*>(pw_filter_get_dsp_buffer(d->in_extra[n], n_samples));
+      auto* out = static_cast<float*>(pw_filter_get_dsp_buffer(d->out_extra[n], n_samples));
+
+      if (in != nullptr) {
+        d->pb->extra_in[n] = std::span(in, n_samples);
+      } else {
+        std::ranges::fill(dummy_in, 0.0F);
+
+        d->pb->extra_in[n] = dummy_in;
+      }
+
+      d->pb->extra_out[n] = (out != nullptr) ? std::span(out, n_samples) : dummy_out;
+    }
+
+    d->pb->connect_extra_channels();
+  }
+
   if (!d->pb->enable_probe) {
     if (DbMain::copyFilterInputBuffers()) {
       auto copy_left_in = std::span(d->pb->copy_left_in);
@@ -231,6 +279,14 @@ void on_process(void* userdata, spa_io_position* position) {
       }
     }
   }
+
+  if (!d->in_extra.empty()) {
+    d->pb->process_extra_channels(d->pb->extra_in, d->pb->extra_out);
+  }
+
+  d->pb->apply_fade(left_out, right_out);
+
+  d->pb->apply_downmix(left_out, right_out);
 }
 
 auto update_filter([[maybe_unused]] struct spa_loop* loop,
@@ -354,6 +410,10 @@ PluginBase::PluginBase(std::string tag,
   pw_properties_set(props_filter, PW_KEY_NODE_GROUP, log_tag == "soe: " ? "ee_sink_group" : "ee_source_group");
   pw_properties_set(props_filter, PW_KEY_NODE_PASSIVE, log_tag == "soe: " ? "true" : "false");
 
+  if (const auto& loop_name = log_tag == "soe: " ? pm->output_loop_name : pm->input_loop_name; !loop_name.empty()) {
+    pw_properties_set(props_filter, "node.loop.name", loop_name.c_str());
+  }
+
   filter = pw_filter_new(pm->core, filter_name.c_str(), props_filter);
 
   // left channel input
@@ -400,6 +460,39 @@ PluginBase::PluginBase(std::string tag,
   pf_data.out_right = static_cast<port*>(pw_filter_add_port(
       filter, PW_DIRECTION_OUTPUT, PW_FILTER_PORT_FLAG_MAP_BUFFERS, sizeof(port), props_out_right, nullptr, 0));
 
+  // Surround channels after FL and FR
+
+  const auto& positions = channel_layout::positions();
+
+  for (size_t n = 2U; n < positions.size(); n++) {
+    auto* props_in = pw_properties_new(nullptr, nullptr);
+
+    pw_properties_set(props_in, PW_KEY_FORMAT_DSP, "32 bit float mono audio");
+    pw_properties_set(props_in, PW_KEY_PORT_NAME, ("input_" + positions[n]).c_str());
+    pw_properties_set(props_in, "audio.channel", positions[n].c_str());
+
+    pf_data.in_extra.push_back(static_cast<port*>(pw_filter_add_port(
+        filter, PW_DIRECTION_INPUT, PW_FILTER_PORT_FLAG_MAP_BUFFERS, sizeof(port), props_in, nullptr, 0)));
+
+    auto* props_out = pw_properties_new(nullptr, nullptr);
+
+    pw_properties_set(props_out, PW_KEY_FORMAT_DSP, "32 bit float mono audio");
+    pw_properties_set(props_out, PW_KEY_PORT_NAME, ("output_" + positions[n]).c_str());
+    pw_properties_set(props_out, "audio.channel", positions[n].c_str());
+
+    pf_data.out_extra.push_back(static_cast<port*>(pw_filter_add_port(
+        filter, PW_DIRECTION_OUTPUT, PW_FILTER_PORT_FLAG_MAP_BUFFERS, sizeof(port), props_out, nullptr, 0)));
+
+    extra_downmix_gains.push_back(channel_layout::downmix_gains(positions[n]));
+
+    n_ports += 2;
+  }
+
+  extra_in.resize(pf_data.in_extra.size());
+  extra_out.resize(pf_data.out_extra.size());
+
+  extra_delay_lines.resize(pf_data.in_extra.size());
+
   if (enable_probe) {
     n_ports += 2;
 
@@ -439,13 +532,9 @@ PluginBase::PluginBase(std::string tag,
     lv2_wrapper->update_ui();
   });
 
-  // worker thread for the native ui and maybe also other things
-
-  baseWorker->moveToThread(&workerThread);
+  // worker for the native ui and maybe also other things
 
-  workerThread.start();
-
-  connect(&workerThread, &QThread::finished, baseWorker, &QObject::deleteLater);
+  WorkerPool::self().attach(baseWorker);
 }
 
 PluginBase::~PluginBase() {
@@ -463,8 +552,17 @@ PluginBase::~PluginBase() {
 }
 
 void PluginBase::stop_worker() {
-  workerThread.quit();
-  workerThread.wait();
+  WorkerPool::self().release(baseWorker);
+
+  baseWorker = nullptr;
+}
+
+void PluginBase::use_dedicated_worker() {
+  WorkerPool::self().release(baseWorker);
+
+  baseWorker = new PluginBaseWorker;
+
+  WorkerPool::self().attach_dedicated(baseWorker);
 }
 
 void PluginBase::reset() {}
@@ -514,6 +612,16 @@ auto PluginBase::connect_to_pw() -> bool {
     std::this_thread::sleep_for(std::chrono::milliseconds(1));
   }
 
+  // New filters start active, so a parked plugin has to be deactivated again.
+
+  if (parked) {
+    pm->lock();
+
+    set_active(false);
+
+    pm->sync_wait_unlock();
+  }
+
   connected_to_pw = true;
 
   util::debug(std::format("{}{} successfully connected to PipeWire graph", log_tag, name.toStdString()));
@@ -526,7 +634,108 @@ auto PluginBase::get_node_id() const -> uint {
 }
 
 void PluginBase::set_active(const bool& state) const {
-  pw_filter_set_active(filter, state);
+  // Parked filters stay inactive until they are unparked.
+
+  pw_filter_set_active(filter, state && !parked);
+}
+
+void PluginBase::park(const bool& state) {
+  if (state == parked) {
+    return;
+  }
+
+  util::debug(std::format("{}{} {}", log_tag, name.toStdString(), state ? "parked" : "unparked"));
+
+  parked = state;
+
+  // The engine is released after the filter stops and set up again before it restarts.
+
+  if (!state) {
+    park_engine(false);
+  }
+
+  if (connected_to_pw) {
+    pm->lock();
+
+    set_active(!state);
+
+    pm->sync_wait_unlock();
+  }
+
+  if (state) {
+    park_engine(true);
+  }
+}
+
+void PluginBase::park_engine(const bool& state) {
+  if (lv2_wrapper == nullptr) {
+    return;
+  }
+
+  std::scoped_lock<std::mutex> lock(data_mutex);
+
+  if (state) {
+    lv2_wrapper->deactivate();
+  } else {
+    lv2_wrapper->activate();
+  }
+}
+
+void PluginBase::start_fade(const bool& fade_in, const uint& duration_ms) {
+  fade_duration = static_cast<float>(duration_ms) * 0.001F;
+
+  fade_target = fade_in ? 1.0F : 0.0F;
+
+  if (duration_ms == 0U) {
+    fade_position = fade_target.load();
+  }
+}
+
+void PluginBase::mute_output() {
+  fade_target = 0.0F;
+  fade_position = 0.0F;
+}
+
+void PluginBase::apply_fade(std::span<float>& left_out, std::span<float>& right_out) {
+  auto position = fade_position.load(std::memory_order_relaxed);
+
+  const auto target = fade_target.load(std::memory_order_relaxed);
+
+  if (position == target) {
+    if (position != 0.0F) {
+      return;
+    }
+
+    std::ranges::fill(left_out, 0.0F);
+    std::ranges::fill(right_out, 0.0F);
+
+    for (auto& channel : extra_out) {
+      std::ranges::fill(channel, 0.0F);
+    }
+
+    return;
+  }
+
+  const auto duration = fade_duration.load(std::memory_order_relaxed);
+
+  const auto step = (duration > 0.0F && rate != 0U) ? 1.0F / (duration * static_cast<float>(rate)) : 1.0F;
+
+  for (size_t n = 0U; n < left_out.size(); n++) {
+    position = (target > position) ? std::min(position + step, target) : std::max(position - step, target);
+
+    const auto gain = std::sin(position * std::numbers::pi_v<float> * 0.5F);
+
+    left_out[n] *= gain;
+    right_out[n] *= gain;
+
+    for (auto& channel : extra_out) {
+      if (n < channel.size()) {
+        channel[n] *= gain;
+      }
+    }
+  }
+
+  fade_position.store(position, std::memory_order_relaxed);
 }
 
 void PluginBase::set_node_passive(const std::string& value) const {
@@ -602,6 +811,18 @@ auto PluginBase::get_latency_seconds() -> float {
   return 0.0F;
 }
 
+auto PluginBase::is_primed() -> bool {
+  if (rate == 0U) {
+    return false;
+  }
+
+  if (lv2_wrapper == nullptr || !lv2_wrapper->found_plugin) {
+    return true;
+  }
+
+  return lv2_wrapper->has_instance() && lv2_wrapper->get_rate() == lv2_rate();
+}
+
 void PluginBase::showNativeUi() {
   native_ui_timer->start();
 
@@ -666,6 +887,8 @@ void PluginBase::get_peaks(const std::span<float>& left_in,
   input_peak_right = util::linear_to_db(in_right_max);
   output_peak_left = util::linear_to_db(out_left_max);
   output_peak_right = util::linear_to_db(out_right_max);
+
+  peaks_written = true;
 }
 
 void PluginBase::apply_gain(std::span<float>& left, std::span<float>& right, const float& gain) const {
@@ -682,8 +905,313 @@ void PluginBase::apply_gain(std::span<float>& left, std::span<float>& right, con
   }
 }
 
+void PluginBase::enable_lv2_extra_channels() {
+  if (lv2_wrapper == nullptr || !lv2_wrapper->found_plugin) {
+    return;
+  }
+
+  const auto& positions = channel_layout::positions();
+
+  extra_groups.clear();
+
+  for (size_t n = 2U; n < positions.size(); n++) {
+    const auto& p = positions[n];
+
+    if (p.ends_with('L') && n + 1U < positions.size() && positions[n + 1U] == p.substr(0U, p.size() - 1U) + "R") {
+      extra_groups.push_back({n - 2U, n - 1U});
+
+      n++;
+    } else {
+      extra_groups.push_back({n - 2U, n - 2U});
+    }
+  }
+
+  lv2_wrapper->set_extra_instances(static_cast<uint>(extra_groups.size()));
+
+  extra_scratch_in.resize(extra_in.size());
+}
+
+void PluginBase::setup_extra_channels() {
+  if (extra_in.empty()) {
+    return;
+  }
+
+  /**
+   * Like setup_oversampling() this runs on the realtime thread, but only on a
+   * rate or quantum change, and the buffers only grow.
+   */
+
+  if (dummy_extra_in.size() < n_samples) {
+    dummy_extra_in.assign(n_samples, 0.0F);
+    dummy_extra_out.assign(n_samples, 0.0F);
+
+    for (auto& v : extra_scratch_in) {
+      v.assign(n_samples, 0.0F);
+    }
+  }
+
+  const auto delay_capacity = static_cast<size_t>(max_extra_delay_seconds * static_cast<float>(rate));
+
+  for (auto& line : extra_delay_lines) {
+    if (line.size() < delay_capacity) {
+      line.assign(delay_capacity, 0.0F);
+    }
+  }
+
+  extra_delay_frames = 0U;
+  extra_delay_index = 0U;
+}
+
+void PluginBase::connect_extra_channels() {
+  if (extra_groups.empty() || bypass) {
+    return;
+  }
+
+  for (size_t n = 0U; n < extra_in.size(); n++) {
+    auto scratch = std::span(extra_scratch_in[n]).first(n_samples);
+
+    std::ranges::transform(extra_in[n], scratch.begin(), [this](const float& v) { return v * input_gain; });
+  }
+
+  // The right output of the instances that take a single channel is not used.
+
+  auto discard = std::span(dummy_extra_out).first(n_samples);
+
+  for (size_t k = 0U; k < extra_groups.size(); k++) {
+    const auto& [a, b] = extra_groups[k];
+
+    lv2_wrapper->set_extra_data_ports(static_cast<uint>(k), std::span(extra_scratch_in[a]).first(n_samples),
+                                      std::span(extra_scratch_in[b]).first(n_samples), extra_out[a],
+                                      a == b ? discard : extra_out[b]);
+  }
+}
+
+void PluginBase::process_extra_channels(std::span<std::span<float>> in, std::span<std::span<float>> out) {
+  if (!extra_groups.empty() && lv2_wrapper->take_extra_run()) {
+    if (output_gain != 1.0F) {
+      for (auto& channel : out) {
+        std::ranges::transform(channel, channel.begin(), [this](const float& v) { return v * output_gain; });
+      }
+    }
+
+    fold_extra_peaks(in, out, input_gain);
+
+    return;
+  }
+
+  const auto gain = bypass ? 1.0F : input_gain * output_gain;
+
+  // When the plugin is bypassed FL and FR are copied straight to the outputs, so its latency does not apply.
+
+  const auto latency = bypass ? 0U : static_cast<size_t>(std::lround(latency_value * static_cast<float>(rate)));
+
+  const auto delay = static_cast<uint>(std::min(latency, extra_delay_lines.front().size()));
+
+  if (delay != extra_delay_frames) {
+    extra_delay_frames = delay;
+    extra_delay_index = 0U;
+
+    for (auto& line : extra_delay_lines) {
+      std::fill_n(line.begin(), delay, 0.0F);
+    }
+  }
+
+  if (delay == 0U) {
+    for (size_t n = 0U; n < in.size(); n++) {
+      if (gain == 1.0F) {
+        std::ranges::copy(in[n], out[n].begin());
+      } else {
+        std::ranges::transform(in[n], out[n].begin(), [gain](const float& v) { return v * gain; });
+      }
+    }
+  } else {
+    auto index = extra_delay_index;
+
+    for (size_t n = 0U; n < in.size(); n++) {
+      auto& line = extra_delay_lines[n];
+
+      index = extra_delay_index;
+
+      for (size_t k = 0U; k < in[n].size(); k++) {
+        const auto value = in[n][k] * gain;
+
+        out[n][k] = line[index];
+
+        line[index] = value;
+
+        index = (index + 1U == delay) ? 0U : index + 1U;
+      }
+    }
+
+    extra_delay_index = index;
+  }
+
+  fold_extra_peaks(in, out, bypass ? 1.0F : input_gain);
+}
+
+void PluginBase::fold_extra_peaks(std::span<std::span<float>> in,
+                                  std::span<std::span<float>> out,
+                                  const float& in_gain) {
+  /**
+   * The level meters have a left and a right side. Each extra channel is added
+   * to the side it is downmixed to, and the LFE to none. Only done when the
+   * plugin updated the levels in this cycle.
+   */
+
+  if (!std::exchange(peaks_written, false) || !updateLevelMeters) {
+    return;
+  }
+
+  std::array<float, 2> in_max = {0.0F, 0.0F};
+  std::array<float, 2> out_max = {0.0F, 0.0F};
+
+  for (size_t n = 0U; n < in.size(); n++) {
+    float channel_in = 0.0F;
+    float channel_out = 0.0F;
+
+    for (size_t k = 0U; k < in[n].size(); k++) {
+      channel_in = std::max(channel_in, std::fabs(in[n][k]));
+      channel_out = std::max(channel_out, std::fabs(out[n][k]));
+    }
+
+    for (size_t side = 0U; side < 2U; side++) {
+      if (extra_downmix_gains[n][side] > 0.0F) {
+        in_max[side] = std::max(in_max[side], channel_in * in_gain);
+        out_max[side] = std::max(out_max[side], channel_out);
+      }
+    }
+  }
+
+  input_peak_left = std::max(input_peak_left, util::linear_to_db(in_max[0]));
+  input_peak_right = std::max(input_peak_right, util::linear_to_db(in_max[1]));
+  output_peak_left = std::max(output_peak_left, util::linear_to_db(out_max[0]));
+  output_peak_right = std::max(output_peak_right, util::linear_to_db(out_max[1]));
+}
+
+void PluginBase::set_linked_channels(const std::vector<std::string>& channels) {
+  const auto& positions = channel_layout::positions();
+
+  uint mask = 0U;
+
+  for (size_t n = 2U; n < positions.size(); n++) {
+    if (std::ranges::find(channels, positions[n]) == channels.end()) {
+      mask |= 1U << (n - 2U);
+    }
+  }
+
+  downmix_mask.store(mask, std::memory_order_relaxed);
+}
+
+void PluginBase::apply_downmix(std::span<float>& left_out, std::span<float>& right_out) {
+  const auto mask = downmix_mask.load(std::memory_order_relaxed);
+
+  if (mask == 0U) {
+    return;
+  }
+
+  for (size_t n = 0U; n < extra_out.size(); n++) {
+    if ((mask & (1U << n)) == 0U) {
+      continue;
+    }
+
+    const auto& [gain_left, gain_right] = extra_downmix_gains[n];
+
+    const auto size = std::min({extra_out[n].size(), left_out.size(), right_out.size()});
+
+    for (size_t k = 0U; k < size; k++) {
+      left_out[k] += gain_left * extra_out[n][k];
+      right_out[k] += gain_right * extra_out[n][k];
+    }
+
+    std::ranges::fill(extra_out[n], 0.0F);
+  }
+}
+
 void PluginBase::update_probe_links() {}
 
+void PluginBase::enable_oversampling() {
+  supports_oversampling = true;
+
+  // The instance has to be recreated at the new rate.
+
+  connect(DbMain::self(), &DbMain::oversampleNonlinearPluginsChanged, this, [this]() { clear_data(); });
+}
+
+void PluginBase::setup_oversampling() {
+  oversampling = supports_oversampling && DbMain::oversampleNonlinearPlugins();
+
+  if (!oversampling) {
+    oversampler.reset();
+
+    return;
+  }
+
+  /**
+   * setup() runs again on every quantum or rate change, so nothing is
+   * allocated unless oversampling was just turned on or the quantum outgrew
+   * the buffers. The oversampler works on blocks of any size. A new rate only
+   * clears its history.
+   */
+
+  if (oversampler == nullptr) {
+    oversampler = std::make_unique<HalfbandOversampler>(n_samples);
+  } else if (rate != oversampled_rate) {
+    oversampler->reset();
+  }
+
+  oversampled_rate = rate;
+
+  if (oversampled_in_left.size() < 2U * n_samples) {
+    for (auto* v : {&oversampled_in_left, &oversampled_in_right, &oversampled_out_left, &oversampled_out_right}) {
+      v->assign(2U * n_samples, 0.0F);
+    }
+  }
+}
+
+auto PluginBase::oversampling_factor() const -> uint {
+  return oversampling ? 2U : 1U;
+}
+
+auto PluginBase::lv2_rate() const -> uint {
+  return oversampling ? 2U * rate : rate;
+}
+
+auto PluginBase::lv2_n_samples() const -> uint {
+  return oversampling ? 2U * n_samples : n_samples;
+}
+
+auto PluginBase::oversampling_latency() const -> float {
+  return (oversampling && rate != 0U)
+             ? static_cast<float>(HalfbandOversampler::latency_frames) / static_cast<float>(rate)
+             : 0.0F;
+}
+
+void PluginBase::run_lv2(std::span<float>& left_in,
+                         std::span<float>& right_in,
+                         std::span<float>& left_out,
+                         std::span<float>& right_out) {
+  if (!oversampling || oversampled_in_left.size() < 2U * left_in.size()) {
+    lv2_wrapper->connect_data_ports(left_in, right_in, left_out, right_out);
+    lv2_wrapper->run();
+
+    return;
+  }
+
+  const auto n = 2U * left_in.size();
+
+  auto l_in = std::span(oversampled_in_left.data(), n);
+  auto r_in = std::span(oversampled_in_right.data(), n);
+  auto l_out = std::span(oversampled_out_left.data(), n);
+  auto r_out = std::span(oversampled_out_right.data(), n);
+
+  oversampler->upsample(left_in, right_in, l_in, r_in);
+
+  lv2_wrapper->connect_data_ports(l_in, r_in, l_out, r_out);
+  lv2_wrapper->run();
+
+  oversampler->downsample(l_out, r_out, left_out, right_out);
+}
+
 void PluginBase::update_filter_params() {
   pw_loop_invoke(pw_thread_loop_get_loop(pm->thread_loop), update_filter, 1, nullptr, 0, false, this);  // NOLINT
 }
@@ -21,23 +21,27 @@
 
 #include <pipewire/filter.h>
 #include <qobject.h>
-#include <qthread.h>
 #include <qtmetamacros.h>
 #include <spa/utils/hook.h>
 #include <sys/types.h>
 #include <QTimer>
+#include <array>
 #include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <span>
 #include <string>
 #include <vector>
+#include "halfband_oversampler.hpp"
 #include "lv2_wrapper.hpp"
 #include "pipeline_type.hpp"
 #include "pw_manager.hpp"
 #include "util.hpp"
+#include "worker_pool.hpp"
 
-class PluginBaseWorker : public QObject {
+class PluginBaseWorker : public PoolWorker {
   Q_OBJECT
 };
 
@@ -77,6 +81,10 @@ class PluginBase : public QObject {
     struct port* probe_left = nullptr;
     struct port* probe_right = nullptr;
 
+    // Ports of the channels after FL and FR when the channel layout is surround.
+
+    std::vector<struct port*> in_extra, out_extra;
+
     PluginBase* pb = nullptr;
   };
 
@@ -98,10 +106,21 @@ class PluginBase : public QObject {
 
   uint rate = 0U;
 
+  uint64_t clock_position = 0U;           // only touched by the realtime thread
+  uint64_t expected_clock_position = 0U;  // only touched by the realtime thread
+
+  std::atomic<uint> xruns = {0U};
+
   bool packageInstalled = true;
 
   std::atomic<bool> bypass = {false};
 
+  /**
+   * Gain position of the equal-power fade applied to the outputs. The gain is sin(position * pi / 2). The realtime
+   * thread moves it toward the target set by start_fade().
+   */
+  std::atomic<float> fade_position = {1.0F};
+
   bool connected_to_pw = false;
 
   float latency_value = 0.0F;  // seconds
@@ -123,12 +142,61 @@ class PluginBase : public QObject {
 
   bool updateLevelMeters = false;
 
-  std::vector<float> dummy_left, dummy_right, copy_left_in, copy_right_in;
+  std::vector<float> dummy_left, dummy_right, copy_left_in, copy_right_in, dummy_extra_in, dummy_extra_out;
+
+  // Views of the extra channel buffers, allocated once so that the realtime thread does not allocate.
+
+  std::vector<std::span<float>> extra_in, extra_out;
 
   [[nodiscard]] auto get_node_id() const -> uint;
 
   void set_active(const bool& state) const;
 
+  /**
+   * Used when the pipeline links around a bypassed plugin. The filter is deactivated so PipeWire stops calling
+   * process and park_engine() releases what the plugin runs on. Unparking reverses both.
+   */
+  void park(const bool& state);
+
+  /**
+   * Fades the outputs in or out. Used when a pipeline crossfades from one chain to another.
+   */
+  void start_fade(const bool& fade_in, const uint& duration_ms);
+
+  /**
+   * Silences the outputs right away. The fade position is reset to unity by start_fade(true, 0).
+   */
+  void mute_output();
+
+  /**
+   * Called by the realtime thread after the plugin has processed the buffers.
+   */
+  void apply_fade(std::span<float>& left_out, std::span<float>& right_out);
+
+  /**
+   * Called by the realtime thread after apply_fade(). Folds into FL and FR the extra channels that are not linked to
+   * the output device.
+   */
+  void apply_downmix(std::span<float>& left_out, std::span<float>& right_out);
+
+  /**
+   * Called on the last node of an output pipeline with the channels that link_nodes() connected to the device. The
+   * extra channels the device does not have are then folded by apply_downmix() and their own outputs are silenced.
+   */
+  void set_linked_channels(const std::vector<std::string>& channels);
+
+  /**
+   * Called by the realtime thread on a rate or quantum change, before setup(). Sizes the buffers of the extra
+   * channels so that nothing is allocated while they are processed.
+   */
+  void setup_extra_channels();
+
+  /**
+   * Called by the realtime thread before process(). Gives the extra channels to the extra LV2 instances, which then
+   * run together with the main one.
+   */
+  void connect_extra_channels();
+
   void set_node_passive(const std::string& value) const;
 
   void set_node_group(const std::string& value) const;
@@ -155,10 +223,27 @@ class PluginBase : public QObject {
                        std::span<float>& probe_left,
                        std::span<float>& probe_right);
 
+  /**
+   * Called by the realtime thread after process() for the channels that follow
+   * FL and FR, in the order given by channel_layout::positions(). When the
+   * extra LV2 instances ran it only applies the output gain. Otherwise the
+   * plugin DSP did not touch them, so the input and output gains are applied
+   * and the audio is delayed by the latency the plugin reports to keep it
+   * aligned with FL and FR. Plugins that process all the channels themselves
+   * override it.
+   */
+  virtual void process_extra_channels(std::span<std::span<float>> in, std::span<std::span<float>> out);
+
   virtual void update_probe_links();
 
   virtual auto get_latency_seconds() -> float;
 
+  /**
+   * True once the plugin has processed at least one cycle at the graph rate and its instance is ready, so its output
+   * is the processed audio and not the passthrough used while it is being set up.
+   */
+  virtual auto is_primed() -> bool;
+
   Q_INVOKABLE virtual void reset() = 0;
 
   Q_INVOKABLE [[nodiscard]] float getInputLevelLeft() const;
@@ -179,6 +264,7 @@ class PluginBase : public QObject {
 
   void updateLevelMetersChanged();
   void packageInstalledChanged();
+  void bypassChanged();
 
  protected:
   std::mutex data_mutex;
@@ -198,8 +284,6 @@ class PluginBase : public QObject {
 
   PluginBaseWorker* baseWorker;
 
-  QThread workerThread;
-
   void get_peaks(const std::span<float>& left_in,
                  const std::span<float>& right_in,
                  std::span<float>& left_out,
@@ -211,13 +295,62 @@ class PluginBase : public QObject {
 
   void stop_worker();
 
+  // For plugins whose worker tasks block for long. Gives the base worker a thread of its own.
+  void use_dedicated_worker();
+
+  /**
+   * Called by park() while the filter is inactive. The default deactivates the LV2 instance. Plugins built on other
+   * engines override it to stop or free them when parked and to set them up again when unparked.
+   */
+  virtual void park_engine(const bool& state);
+
+  /**
+   * Nonlinear plugins call enable_oversampling() in their constructor. When the
+   * oversampling preference is on their LV2 instance runs at twice the graph
+   * rate: setup() calls setup_oversampling() and creates the instance with
+   * lv2_rate() and lv2_n_samples(), and process() calls run_lv2().
+   */
+  void enable_oversampling();
+
+  void setup_oversampling();
+
+  /**
+   * Plugins whose processing does not depend on the channel, like the dynamics
+   * and the equalizers, call enable_lv2_extra_channels() in their constructor
+   * after creating the wrapper. The extra channels then go through extra LV2
+   * instances: SL/SR and RL/RR as stereo pairs and FC and LFE each on its own
+   * through the left side. Not meant for plugins that oversample.
+   */
+  void enable_lv2_extra_channels();
+
+  // Adds the extra channels to the levels get_peaks() wrote in this cycle. in_gain is the input gain they got.
+  void fold_extra_peaks(std::span<std::span<float>> in, std::span<std::span<float>> out, const float& in_gain);
+
+  [[nodiscard]] auto lv2_rate() const -> uint;
+
+  [[nodiscard]] auto lv2_n_samples() const -> uint;
+
+  [[nodiscard]] auto oversampling_latency() const -> float;
+
+  // Ratio between the rate of the LV2 instance and the graph rate.
+  [[nodiscard]] auto oversampling_factor() const -> uint;
+
+  void run_lv2(std::span<float>& left_in,
+               std::span<float>& right_in,
+               std::span<float>& left_out,
+               std::span<float>& right_out);
+
   template <typename dbClass>
   void init_common_controls(dbClass* settings) {
     bypass = settings->bypass();
     input_gain = util::db_to_linear(settings->inputGain());
     output_gain = util::db_to_linear(settings->outputGain());
 
-    connect(settings, &dbClass::bypassChanged, [&, settings]() { bypass = settings->bypass(); });
+    connect(settings, &dbClass::bypassChanged, [&, settings]() {
+      bypass = settings->bypass();
+
+      Q_EMIT bypassChanged();
+    });
     connect(settings, &dbClass::inputGainChanged,
             [&, settings]() { input_gain = util::db_to_linear(settings->inputGain()); });
     connect(settings, &dbClass::outputGainChanged,
@@ -227,5 +360,49 @@ class PluginBase : public QObject {
  private:
   uint node_id = 0U;
 
+  bool parked = false;
+
+  std::atomic<float> fade_target = {1.0F};
+  std::atomic<float> fade_duration = {0.0F};  // seconds
+
+  bool supports_oversampling = false;
+  bool oversampling = false;
+
+  // Delay lines of the extra channels. Only touched by the realtime thread.
+
+  std::vector<std::vector<float>> extra_delay_lines;
+
+  uint extra_delay_frames = 0U, extra_delay_index = 0U;
+
+  // Longest latency the extra channels can be delayed by. Longer ones are clamped.
+
+  static constexpr float max_extra_delay_seconds = 1.0F;
+
+  // FL and FR gains of each extra channel when downmixing.
+
+  std::vector<std::array<float, 2>> extra_downmix_gains;
+
+  // Bit n set when the extra channel n is folded into FL and FR.
+
+  std::atomic<uint> downmix_mask = {0U};
+
+  // Extra channels given to each extra LV2 instance. Both are the same for FC and LFE.
+
+  std::vector<std::array<size_t, 2>> extra_groups;
+
+  // The extra channels after the input gain, as given to the extra LV2 instances.
+
+  std::vector<std::vector<float>> extra_scratch_in;
+
+  // Set by get_peaks(), so that the extra channels are folded only into the levels of the current cycle.
+
+  bool peaks_written = false;
+
+  uint oversampled_rate = 0U;
+
+  std::unique_ptr<HalfbandOversampler> oversampler;
+
+  std::vector<float> oversampled_in_left, oversampled_in_right, oversampled_out_left, oversampled_out_right;
+
   QTimer* native_ui_timer = nullptr;
 };
@@ -39,8 +39,9 @@
 
 namespace presets {
 
-AutoloadManager::AutoloadManager(DirectoryManager& directory_manager)
+AutoloadManager::AutoloadManager(DirectoryManager& directory_manager, JsonCache& json_cache)
     : dir_manager(directory_manager),
+      json_cache(json_cache),
       input_model(new ListModel(this, ListModel::ModelType::Autoload)),
       output_model(new ListModel(this, ListModel::ModelType::Autoload)) {
   refreshListModels();
@@ -59,11 +60,17 @@ void AutoloadManager::prepareFilesystemWatchers() {
   input_watcher.addPath(QString::fromStdString(dir_manager.autoloadInputDir().string()));
   output_watcher.addPath(QString::fromStdString(dir_manager.autoloadOutputDir().string()));
 
-  connect(&input_watcher, &QFileSystemWatcher::directoryChanged,
-          [&]() { input_model->update(dir_manager.getAutoloadProfilesPaths(PipelineType::input)); });
+  connect(&input_watcher, &QFileSystemWatcher::directoryChanged, [&]() {
+    input_model->update(dir_manager.getAutoloadProfilesPaths(PipelineType::input));
 
-  connect(&output_watcher, &QFileSystemWatcher::directoryChanged,
-          [&]() { output_model->update(dir_manager.getAutoloadProfilesPaths(PipelineType::output)); });
+    Q_EMIT profilesChanged();
+  });
+
+  connect(&output_watcher, &QFileSystemWatcher::directoryChanged, [&]() {
+    output_model->update(dir_manager.getAutoloadProfilesPaths(PipelineType::output));
+
+    Q_EMIT profilesChanged();
+  });
 }
 
 void AutoloadManager::refreshListModels() {
@@ -149,17 +156,13 @@ auto AutoloadManager::find(const PipelineType& pipeline_type, const QString& dev
     -> std::string {
   auto path = getFilePath(pipeline_type, device_name, device_route);
 
-  if (!std::filesystem::is_regular_file(path)) {
+  const auto json = json_cache.read(path);
+
+  if (json == nullptr) {
     return "";
   }
 
-  nlohmann::json json;
-
-  std::ifstream is(path);
-
-  is >> json;
-
-  return json.value("preset-name", "");
+  return json->value("preset-name", "");
 }
 
 void AutoloadManager::load(const PipelineType& pipeline_type, const QString& device_name, const QString& device_route) {
@@ -225,13 +228,9 @@ auto AutoloadManager::getProfiles(const PipelineType& pipeline_type) -> std::vec
     while (it != std::filesystem::directory_iterator{}) {
       if (std::filesystem::is_regular_file(it->status())) {
         if (it->path().extension().string() == DirectoryManager::json_ext) {
-          nlohmann::json json;
-
-          std::ifstream is(autoload_dir / it->path());
-
-          is >> json;
-
-          list.push_back(json);
+          if (const auto json = json_cache.read(it->path()); json != nullptr) {
+            list.push_back(*json);
+          }
         }
       }
 
@@ -31,6 +31,7 @@
 #include <vector>
 #include "pipeline_type.hpp"
 #include "presets_directory_manager.hpp"
+#include "presets_json_cache.hpp"
 #include "presets_list_model.hpp"
 
 namespace presets {
@@ -39,7 +40,7 @@ class AutoloadManager : public QObject {
   Q_OBJECT
 
  public:
-  explicit AutoloadManager(DirectoryManager& directory_manager);
+  AutoloadManager(DirectoryManager& directory_manager, JsonCache& json_cache);
   AutoloadManager(const AutoloadManager&) = delete;
   auto operator=(const AutoloadManager&) -> AutoloadManager& = delete;
   AutoloadManager(const AutoloadManager&&) = delete;
@@ -79,9 +80,13 @@ class AutoloadManager : public QObject {
  Q_SIGNALS:
   void loadPresetRequested(const PipelineType& pipeline_type, const QString& preset_name);
 
+  void profilesChanged();
+
  private:
   DirectoryManager& dir_manager;
 
+  JsonCache& json_cache;
+
   ListModel* input_model{nullptr};
   ListModel* output_model{nullptr};
 
@@ -0,0 +1,277 @@
+/**
+ * Copyright © 2017-2026 Wellington Wallace
+ *
+ * This file is part of Easy Effects.
+ *
+ * Easy Effects is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Easy Effects is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "presets_catalog.hpp"
+#include <qfilesystemwatcher.h>
+#include <qlist.h>
+#include <qobject.h>
+#include <qtmetamacros.h>
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <map>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <vector>
+#include "pipeline_type.hpp"
+#include "presets_directory_manager.hpp"
+#include "tags_plugin_name.hpp"
+#include "util.hpp"
+
+namespace presets {
+
+Catalog::Catalog(DirectoryManager& directory_manager)
+    : dir_manager(directory_manager),
+      directories{{Directory{.path = dir_manager.userInputDir(), .extensions = {DirectoryManager::json_ext}},
+                   Directory{.path = dir_manager.userOutputDir(), .extensions = {DirectoryManager::json_ext}},
+                   Directory{.path = dir_manager.userIrsDir(),
+                             .extensions = {DirectoryManager::irs_ext, DirectoryManager::sofa_ext}},
+                   Directory{.path = dir_manager.userRnnoiseDir(), .extensions = {DirectoryManager::rnnoise_ext}}}} {
+  for (auto& directory : directories) {
+    directory.entries = list_directory(directory);
+
+    watcher.addPath(QString::fromStdString(directory.path.string()));
+  }
+
+  connect(&watcher, &QFileSystemWatcher::directoryChanged, [&](const QString& changed_path) {
+    const auto changed = std::filesystem::path{changed_path.toStdString()};
+
+    for (size_t n = 0U; n < directories.size(); n++) {
+      if (directories[n].path == changed) {
+        scan(static_cast<Kind>(n));
+      }
+    }
+  });
+}
+
+auto Catalog::kind_of(const PipelineType& pipeline_type) -> Kind {
+  return (pipeline_type == PipelineType::output) ? Kind::output : Kind::input;
+}
+
+auto Catalog::paths(const Kind& kind) const -> QList<std::filesystem::path> {
+  const auto& entries = directories[static_cast<size_t>(kind)].entries;
+
+  QList<std::filesystem::path> list;
+
+  list.reserve(static_cast<qsizetype>(entries.size()));
+
+  for (const auto& [path, mtime] : entries) {
+    list.append(path);
+  }
+
+  return list;
+}
+
+auto Catalog::contains(const Kind& kind, const std::string& stem) const -> bool {
+  const auto& directory = directories[static_cast<size_t>(kind)];
+
+  return std::ranges::any_of(directory.extensions, [&](const std::string& ext) {
+    return directory.entries.contains(directory.path / std::filesystem::path{stem + ext});
+  });
+}
+
+auto Catalog::list_directory(const Directory& directory)
+    -> std::map<std::filesystem::path, std::filesystem::file_time_type> {
+  std::map<std::filesystem::path, std::filesystem::file_time_type> entries;
+
+  try {
+    for (const auto& entry : std::filesystem::directory_iterator{directory.path}) {
+      if (!entry.is_regular_file()) {
+        continue;
+      }
+
+      const auto ext = entry.path().extension().string();
+
+      if (std::ranges::find(directory.extensions, ext) != directory.extensions.end()) {
+        entries.emplace(entry.path(), entry.last_write_time());
+      }
+    }
+  } catch (const std::exception& e) {
+    util::warning(e.what());
+  }
+
+  return entries;
+}
+
+void Catalog::scan(const Kind& kind) {
+  auto& directory = directories[static_cast<size_t>(kind)];
+
+  auto entries = list_directory(directory);
+
+  auto old_entries = std::move(directory.entries);
+
+  directory.entries = entries;
+
+  for (const auto& [path, mtime] : old_entries) {
+    if (!entries.contains(path)) {
+      metadata_cache.erase(path);
+
+      Q_EMIT fileRemoved(kind, path);
+    }
+  }
+
+  for (const auto& [path, mtime] : entries) {
+    auto it = old_entries.find(path);
+
+    if (it == old_entries.end()) {
+      Q_EMIT fileAdded(kind, path);
+    } else if (it->second != mtime) {
+      Q_EMIT fileModified(kind, path);
+    }
+  }
+}
+
+auto Catalog::metadata(const PipelineType& pipeline_type, const std::filesystem::path& path)
+    -> std::optional<PresetMetadata> {
+  std::error_code ec;
+
+  const auto mtime = std::filesystem::last_write_time(path, ec);
+
+  if (ec) {
+    metadata_cache.erase(path);
+
+    return std::nullopt;
+  }
+
+  if (auto it = metadata_cache.find(path); it != metadata_cache.end() && it->second.mtime == mtime) {
+    return it->second;
+  }
+
+  std::ifstream is(path);
+
+  const auto json = nlohmann::json::parse(is, nullptr, false);
+
+  auto data = json.is_discarded() ? std::nullopt : metadata_from_json(pipeline_type, json);
+
+  if (!data) {
+    util::warning(std::format("Could not read the preset metadata of {}", path.string()));
+
+    return std::nullopt;
+  }
+
+  data->mtime = mtime;
+
+  metadata_cache.insert_or_assign(path, *data);
+
+  return data;
+}
+
+auto Catalog::metadata_from_json(const PipelineType& pipeline_type, const nlohmann::json& json)
+    -> std::optional<PresetMetadata> {
+  const auto* pt_key = (pipeline_type == PipelineType::output) ? "output" : "input";
+
+  if (!json.contains(pt_key)) {
+    return std::nullopt;
+  }
+
+  PresetMetadata data;
+
+  try {
+    const auto& section = json.at(pt_key);
+
+    data.plugins = section.value("plugins_order", std::vector<std::string>{});
+    data.blocklist = section.value("blocklist", std::vector<std::string>{});
+
+    for (const auto& plugin : data.plugins) {
+      if (!section.contains(plugin)) {
+        continue;
+      }
+
+      if (plugin.starts_with(tags::plugin_name::BaseName::convolver.toStdString())) {
+        data.irs.push_back(section.at(plugin).value("kernel-name", ""));
+      }
+
+      if (plugin.starts_with(tags::plugin_name::BaseName::rnnoise.toStdString())) {
+        data.rnnoise_models.push_back(section.at(plugin).value("model-name", ""));
+      }
+    }
+  } catch (const nlohmann::json::exception& e) {
+    util::warning(e.what());
+
+    return std::nullopt;
+  }
+
+  std::erase(data.irs, "");
+  std::erase(data.rnnoise_models, "");
+
+  return data;
+}
+
+auto Catalog::community_paths(const PipelineType& pipeline_type) -> QList<std::filesystem::path> {
+  auto& cached = (pipeline_type == PipelineType::output) ? community_output : community_input;
+
+  if (!cached) {
+    cached = scan_community(pipeline_type);
+  }
+
+  return *cached;
+}
+
+void Catalog::rescan_community(const PipelineType& pipeline_type) {
+  auto& cached = (pipeline_type == PipelineType::output) ? community_output : community_input;
+
+  cached = scan_community(pipeline_type);
+}
+
+auto Catalog::scan_community(const PipelineType& pipeline_type) -> QList<std::filesystem::path> {
+  QList<std::filesystem::path> cp_paths;
+
+  const auto scan_level = 2U;
+  const auto& cp_dir_vect = (pipeline_type == PipelineType::output) ? dir_manager.systemDataDirOutput()
+                                                                    : dir_manager.systemDataDirInput();
+
+  for (const auto& cp_dir : cp_dir_vect) {
+    auto cp_fs_path = std::filesystem::path{cp_dir};
+
+    if (!std::filesystem::exists(cp_fs_path)) {
+      continue;
+    }
+
+    // Scan community package directories for 2 levels
+    // (the folder itself and only its subfolders).
+    auto it = std::filesystem::directory_iterator{cp_fs_path};
+
+    try {
+      while (it != std::filesystem::directory_iterator{}) {
+        if (auto package_path = it->path(); std::filesystem::is_directory(it->status())) {
+          const auto package_path_name = package_path.string();
+          util::debug(std::format("Scan directory for community presets: {}", package_path_name));
+
+          auto package_it = std::filesystem::directory_iterator{package_path};
+          const auto sub_cp_vect =
+              dir_manager.scanDirectoryRecursive(package_it, scan_level, QString::fromStdString(package_path_name));
+
+          cp_paths.append(sub_cp_vect);
+        }
+        ++it;
+      }
+    } catch (const std::exception& e) {
+      util::warning(e.what());
+    }
+  }
+
+  return cp_paths;
+}
+
+}  // namespace presets
@@ -0,0 +1,128 @@
+/**
+ * Copyright © 2017-2026 Wellington Wallace
+ *
+ * This file is part of Easy Effects.
+ *
+ * Easy Effects is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Easy Effects is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <qfilesystemwatcher.h>
+#include <qlist.h>
+#include <qobject.h>
+#include <qtmetamacros.h>
+#include <array>
+#include <filesystem>
+#include <map>
+#include <nlohmann/json_fwd.hpp>
+#include <optional>
+#include <string>
+#include <vector>
+#include "pipeline_type.hpp"
+#include "presets_directory_manager.hpp"
+
+namespace presets {
+
+/**
+ * Index of the preset, impulse response and RNNoise model files.
+ *
+ * Each user directory is listed once at startup. After that a watcher
+ * notification only lists the directory that changed, and the catalog
+ * reports the files that were added, removed or rewritten through its
+ * signals, so that the list models can update single rows. The community
+ * packages live in read only system directories and are scanned only on the
+ * first request and when the user asks for a refresh.
+ */
+class Catalog : public QObject {
+  Q_OBJECT
+
+ public:
+  enum class Kind { input, output, irs, rnnoise };
+
+  /**
+   * The parts of a preset that are needed without loading it. They are parsed
+   * on the first request and parsed again when the file modification time
+   * changes.
+   */
+  struct PresetMetadata {
+    std::filesystem::file_time_type mtime;
+
+    std::vector<std::string> plugins;
+
+    std::vector<std::string> blocklist;
+
+    std::vector<std::string> irs;  // impulse response names used by the convolvers
+
+    std::vector<std::string> rnnoise_models;
+  };
+
+  explicit Catalog(DirectoryManager& directory_manager);
+  Catalog(const Catalog&) = delete;
+  auto operator=(const Catalog&) -> Catalog& = delete;
+  Catalog(const Catalog&&) = delete;
+  auto operator=(const Catalog&&) -> Catalog& = delete;
+  ~Catalog() override = default;
+
+  static auto kind_of(const PipelineType& pipeline_type) -> Kind;
+
+  [[nodiscard]] auto paths(const Kind& kind) const -> QList<std::filesystem::path>;
+
+  [[nodiscard]] auto contains(const Kind& kind, const std::string& stem) const -> bool;
+
+  auto metadata(const PipelineType& pipeline_type, const std::filesystem::path& path) -> std::optional<PresetMetadata>;
+
+  // Thread safe. The mtime of the result is left empty.
+  static auto metadata_from_json(const PipelineType& pipeline_type, const nlohmann::json& json)
+      -> std::optional<PresetMetadata>;
+
+  auto community_paths(const PipelineType& pipeline_type) -> QList<std::filesystem::path>;
+
+  void rescan_community(const PipelineType& pipeline_type);
+
+ Q_SIGNALS:
+  void fileAdded(presets::Catalog::Kind kind, const std::filesystem::path& path);
+
+  void fileRemoved(presets::Catalog::Kind kind, const std::filesystem::path& path);
+
+  void fileModified(presets::Catalog::Kind kind, const std::filesystem::path& path);
+
+ private:
+  struct Directory {
+    std::filesystem::path path;
+
+    std::vector<std::string> extensions;
+
+    std::map<std::filesystem::path, std::filesystem::file_time_type> entries;
+  };
+
+  DirectoryManager& dir_manager;
+
+  QFileSystemWatcher watcher;
+
+  std::array<Directory, 4> directories;
+
+  std::map<std::filesystem::path, PresetMetadata> metadata_cache;
+
+  std::optional<QList<std::filesystem::path>> community_input, community_output;
+
+  void scan(const Kind& kind);
+
+  static auto list_directory(const Directory& directory)
+      -> std::map<std::filesystem::path, std::filesystem::file_time_type>;
+
+  auto scan_community(const PipelineType& pipeline_type) -> QList<std::filesystem::path>;
+};
+
+}  // namespace presets
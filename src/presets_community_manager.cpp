@@ -24,21 +24,19 @@
 #include <exception>
 #include <filesystem>
 #include <format>
-#include <fstream>
-#include <nlohmann/json.hpp>
-#include <nlohmann/json_fwd.hpp>
 #include <string>
 #include <vector>
 #include "pipeline_type.hpp"
+#include "presets_catalog.hpp"
 #include "presets_directory_manager.hpp"
 #include "presets_list_model.hpp"
-#include "tags_plugin_name.hpp"
 #include "util.hpp"
 
 namespace presets {
 
-CommunityManager::CommunityManager(DirectoryManager& directory_manager)
+CommunityManager::CommunityManager(DirectoryManager& directory_manager, Catalog& catalog)
     : dir_manager(directory_manager),
+      catalog(catalog),
       input_model(new ListModel(this, ListModel::ModelType::Community)),
       output_model(new ListModel(this, ListModel::ModelType::Community)) {
   refreshListModels();
@@ -53,6 +51,8 @@ auto CommunityManager::get_output_model() -> ListModel* {
 }
 
 void CommunityManager::refresh_list_model(const PipelineType& pipeline_type) {
+  catalog.rescan_community(pipeline_type);
+
   switch (pipeline_type) {
     case PipelineType::input: {
       input_model->update(getAllCommunityPresetsPaths(PipelineType::input));
@@ -106,7 +106,7 @@ auto CommunityManager::import_addons_from_community_package(const PipelineType&
                                                             const std::filesystem::path& path,
                                                             const std::string& package) -> bool {
   /**
-   * Here we parse the json community preset in order to import the list of
+   * Here we use the metadata of the community preset in order to import the list of
    * addons:
    * 1. Convolver Impulse Response Files
    * 2. RNNoise Models
@@ -114,31 +114,27 @@ auto CommunityManager::import_addons_from_community_package(const PipelineType&
 
   // This method assumes that the path is valid and package string is not empty,
   // their check has already been made in import_from_community_package();
-  std::ifstream is(path);
+  const auto metadata = catalog.metadata(pipeline_type, path);
 
-  nlohmann::json json;
+  if (!metadata) {
+    return false;
+  }
 
   const auto irs_ext = ".irs";
   const auto rnnn_ext = ".rnnn";
 
   try {
-    is >> json;
-
     std::vector<std::string> conv_irs;
     std::vector<std::string> rn_models;
 
-    const auto* pt_key = (pipeline_type == PipelineType::output) ? "output" : "input";
-
-    // Fill conv_irs and rn_models vectors extracting the addon names from
-    // the json preset and append the respective file extension.
-    for (const auto& plugin : json.at(pt_key).at("plugins_order").get<std::vector<std::string>>()) {
-      if (plugin.starts_with(tags::plugin_name::BaseName::convolver.toStdString())) {
-        conv_irs.push_back(json.at(pt_key).at(plugin).at("kernel-name").get<std::string>() + irs_ext);
-      }
+    // Fill conv_irs and rn_models vectors with the addon names cached by the
+    // catalog and append the respective file extension.
+    for (const auto& name : metadata->irs) {
+      conv_irs.push_back(name + irs_ext);
+    }
 
-      if (plugin.starts_with(tags::plugin_name::BaseName::rnnoise.toStdString())) {
-        rn_models.push_back(json.at(pt_key).at(plugin).at("model-name").get<std::string>() + rnnn_ext);
-      }
+    for (const auto& name : metadata->rnnoise_models) {
+      rn_models.push_back(name + rnnn_ext);
     }
 
     // For every filename of both vectors, search the full path and copy the file locally.
@@ -295,43 +291,7 @@ bool CommunityManager::import_from_community_package(const PipelineType& pipelin
 }
 
 auto CommunityManager::getAllCommunityPresetsPaths(PipelineType type) -> QList<std::filesystem::path> {
-  QList<std::filesystem::path> cp_paths;
-
-  const auto scan_level = 2U;
-  const auto& cp_dir_vect =
-      (type == PipelineType::output) ? dir_manager.systemDataDirOutput() : dir_manager.systemDataDirInput();
-
-  for (const auto& cp_dir : cp_dir_vect) {
-    auto cp_fs_path = std::filesystem::path{cp_dir};
-
-    if (!std::filesystem::exists(cp_fs_path)) {
-      continue;
-    }
-
-    // Scan community package directories for 2 levels
-    // (the folder itself and only its subfolders).
-    auto it = std::filesystem::directory_iterator{cp_fs_path};
-
-    try {
-      while (it != std::filesystem::directory_iterator{}) {
-        if (auto package_path = it->path(); std::filesystem::is_directory(it->status())) {
-          const auto package_path_name = package_path.string();
-          util::debug(std::format("Scan directory for community presets: {}", package_path_name));
-
-          auto package_it = std::filesystem::directory_iterator{package_path};
-          const auto sub_cp_vect =
-              dir_manager.scanDirectoryRecursive(package_it, scan_level, QString::fromStdString(package_path_name));
-
-          cp_paths.append(sub_cp_vect);
-        }
-        ++it;
-      }
-    } catch (const std::exception& e) {
-      util::warning(e.what());
-    }
-  }
-
-  return cp_paths;
+  return catalog.community_paths(type);
 }
 
 }  // namespace presets
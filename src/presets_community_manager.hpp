@@ -29,6 +29,7 @@
 #include <nlohmann/json_fwd.hpp>
 #include <string>
 #include "pipeline_type.hpp"
+#include "presets_catalog.hpp"
 #include "presets_directory_manager.hpp"
 #include "presets_list_model.hpp"
 
@@ -38,7 +39,7 @@ class CommunityManager : public QObject {
   Q_OBJECT
 
  public:
-  explicit CommunityManager(DirectoryManager& directory_manager);
+  CommunityManager(DirectoryManager& directory_manager, Catalog& catalog);
   CommunityManager(const CommunityManager&) = delete;
   auto operator=(const CommunityManager&) -> CommunityManager& = delete;
   CommunityManager(const CommunityManager&&) = delete;
@@ -64,6 +65,8 @@ class CommunityManager : public QObject {
  private:
   DirectoryManager& dir_manager;
 
+  Catalog& catalog;
+
   ListModel* input_model{nullptr};
   ListModel* output_model{nullptr};
 
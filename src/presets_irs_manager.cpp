@@ -20,7 +20,6 @@
 #include "presets_irs_manager.hpp"
 #include <mysofa.h>
 #include <qcontainerfwd.h>
-#include <qfilesystemwatcher.h>
 #include <qtmetamacros.h>
 #include <qtypes.h>
 #include <qurl.h>
@@ -28,19 +27,28 @@
 #include <format>
 #include <sndfile.hh>
 #include <string>
+#include "presets_catalog.hpp"
 #include "presets_directory_manager.hpp"
 #include "presets_list_model.hpp"
 #include "util.hpp"
 
 namespace presets {
 
-IrsManager::IrsManager(DirectoryManager& directory_manager)
+IrsManager::IrsManager(DirectoryManager& directory_manager, Catalog& catalog)
     : dir_manager(directory_manager), model(new ListModel(this, ListModel::ModelType::IRS)) {
-  model->update(dir_manager.getLocalIrsPaths());
+  model->update(catalog.paths(Catalog::Kind::irs));
 
-  watcher.addPath(QString::fromStdString(dir_manager.userIrsDir().string()));
+  connect(&catalog, &Catalog::fileAdded, this, [&](Catalog::Kind kind, const std::filesystem::path& path) {
+    if (kind == Catalog::Kind::irs) {
+      model->append(path);
+    }
+  });
 
-  connect(&watcher, &QFileSystemWatcher::directoryChanged, [&]() { model->update(dir_manager.getLocalIrsPaths()); });
+  connect(&catalog, &Catalog::fileRemoved, this, [&](Catalog::Kind kind, const std::filesystem::path& path) {
+    if (kind == Catalog::Kind::irs) {
+      model->remove(path);
+    }
+  });
 }
 
 auto IrsManager::get_model() -> ListModel* {
@@ -19,7 +19,6 @@
 
 #pragma once
 
-#include <qfilesystemwatcher.h>
 #include <qhashfunctions.h>
 #include <qlist.h>
 #include <qobject.h>
@@ -27,6 +26,7 @@
 #include <qtypes.h>
 #include <sndfile.hh>
 #include <string>
+#include "presets_catalog.hpp"
 #include "presets_directory_manager.hpp"
 #include "presets_list_model.hpp"
 
@@ -38,7 +38,7 @@ class IrsManager : public QObject {
  public:
   enum class ImportState { success, no_regular_file, no_frame, unsupported };
 
-  explicit IrsManager(DirectoryManager& directory_manager);
+  IrsManager(DirectoryManager& directory_manager, Catalog& catalog);
   IrsManager(const IrsManager&) = delete;
   auto operator=(const IrsManager&) -> IrsManager& = delete;
   IrsManager(const IrsManager&&) = delete;
@@ -56,8 +56,6 @@ class IrsManager : public QObject {
 
   ListModel* model{nullptr};
 
-  QFileSystemWatcher watcher;
-
   auto import_irs_file(const std::string& file_path) -> ImportState;
 };
 
@@ -0,0 +1,92 @@
+/**
+ * Copyright © 2017-2026 Wellington Wallace
+ *
+ * This file is part of Easy Effects.
+ *
+ * Easy Effects is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Easy Effects is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "presets_json_cache.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <system_error>
+#include "util.hpp"
+
+namespace presets {
+
+auto JsonCache::read(const std::filesystem::path& path) -> std::shared_ptr<const nlohmann::json> {
+  std::error_code ec;
+
+  const auto mtime = std::filesystem::last_write_time(path, ec);
+
+  const auto size = ec ? 0U : std::filesystem::file_size(path, ec);
+
+  if (ec) {
+    erase(path);
+
+    return nullptr;
+  }
+
+  {
+    std::scoped_lock lock(mutex);
+
+    if (auto it = entries.find(path); it != entries.end()) {
+      if (it->second.mtime == mtime && it->second.size == size) {
+        it->second.last_use = ++use_counter;
+
+        return it->second.json;
+      }
+
+      entries.erase(it);
+    }
+  }
+
+  // Parsing happens without the lock so that a prewarm does not block the main thread.
+
+  std::ifstream is(path);
+
+  auto json = std::make_shared<nlohmann::json>(nlohmann::json::parse(is, nullptr, false));
+
+  if (json->is_discarded()) {
+    util::warning(std::format("{} is not a valid json file", path.string()));
+
+    return nullptr;
+  }
+
+  std::scoped_lock lock(mutex);
+
+  entries.insert_or_assign(path, Entry{.mtime = mtime, .size = size, .last_use = ++use_counter, .json = json});
+
+  if (entries.size() > max_entries) {
+    auto oldest = std::ranges::min_element(entries, {}, [](const auto& e) { return e.second.last_use; });
+
+    entries.erase(oldest);
+  }
+
+  return json;
+}
+
+void JsonCache::erase(const std::filesystem::path& path) {
+  std::scoped_lock lock(mutex);
+
+  entries.erase(path);
+}
+
+}  // namespace presets
@@ -0,0 +1,73 @@
+/**
+ * Copyright © 2017-2026 Wellington Wallace
+ *
+ * This file is part of Easy Effects.
+ *
+ * Easy Effects is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Easy Effects is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <sys/types.h>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <nlohmann/json_fwd.hpp>
+
+namespace presets {
+
+/**
+ * Parsed preset and autoload profile files kept in memory. Every read checks
+ * the modification time and the size of the file, so an edited file is parsed
+ * again instead of being served stale. It can be used from the worker threads
+ * that prewarm the cache. The least recently used entry is dropped when there
+ * are more than max_entries.
+ */
+class JsonCache {
+ public:
+  JsonCache() = default;
+  JsonCache(const JsonCache&) = delete;
+  auto operator=(const JsonCache&) -> JsonCache& = delete;
+  JsonCache(const JsonCache&&) = delete;
+  auto operator=(const JsonCache&&) -> JsonCache& = delete;
+  ~JsonCache() = default;
+
+  static constexpr size_t max_entries = 64U;
+
+  // Returns nullptr when the file does not exist or is not valid json.
+  auto read(const std::filesystem::path& path) -> std::shared_ptr<const nlohmann::json>;
+
+  void erase(const std::filesystem::path& path);
+
+ private:
+  struct Entry {
+    std::filesystem::file_time_type mtime;
+
+    std::uintmax_t size = 0U;
+
+    uint64_t last_use = 0U;
+
+    std::shared_ptr<const nlohmann::json> json;
+  };
+
+  std::mutex mutex;
+
+  std::map<std::filesystem::path, Entry> entries;
+
+  uint64_t use_counter = 0U;
+};
+
+}  // namespace presets
@@ -32,6 +32,7 @@
 #include <filesystem>
 #include <fstream>
 #include <iterator>
+#include <set>
 #include <nlohmann/json.hpp>
 #include <nlohmann/json_fwd.hpp>
 #include "config.h"
@@ -128,15 +129,13 @@ QVariant ListModel::data(const QModelIndex& index, int role) const {
 }
 
 void ListModel::append(const std::filesystem::path& path) {
-  int pos = listPaths.empty() ? 0 : listPaths.size() - 1;
+  const auto pos = listPaths.size();
 
   beginInsertRows(QModelIndex(), pos, pos);
 
   listPaths.append(path);
 
   endInsertRows();
-
-  Q_EMIT dataChanged(index(0), index(listPaths.size() - 1));
 }
 
 void ListModel::remove(const QString& name) {
@@ -152,35 +151,23 @@ void ListModel::remove(const QString& name) {
     return;
   }
 
-  beginRemoveRows(QModelIndex(), rowIndex, rowIndex);
-
-  listPaths.remove(rowIndex);
-
-  endRemoveRows();
-
-  Q_EMIT dataChanged(index(0), index(listPaths.size() - 1));
+  remove(static_cast<int>(rowIndex));
 }
 
 void ListModel::remove(const int& rowIndex) {
+  if (rowIndex < 0 || rowIndex >= listPaths.size()) {
+    return;
+  }
+
   beginRemoveRows(QModelIndex(), rowIndex, rowIndex);
 
   listPaths.remove(rowIndex);
 
   endRemoveRows();
-
-  Q_EMIT dataChanged(index(0), index(listPaths.size() - 1));
 }
 
 void ListModel::remove(const std::filesystem::path& path) {
-  qsizetype rowIndex = listPaths.indexOf(path);
-
-  beginRemoveRows(QModelIndex(), rowIndex, rowIndex);
-
-  listPaths.remove(rowIndex);
-
-  endRemoveRows();
-
-  Q_EMIT dataChanged(index(0), index(listPaths.size() - 1));
+  remove(static_cast<int>(listPaths.indexOf(path)));
 }
 
 void ListModel::reset() {
@@ -213,22 +200,36 @@ void ListModel::emit_data_changed(const std::filesystem::path& path) {
   Q_EMIT dataChanged(index(rowIndex), index(rowIndex));
 }
 
+/**
+ * Only the rows that differ between the two lists are removed or inserted.
+ * Resetting the model would make the views rebuild every delegate.
+ */
 void ListModel::update(const QList<std::filesystem::path>& paths) {
-  auto current_list = listPaths;
+  const std::set<std::filesystem::path> new_paths(paths.begin(), paths.end());
 
-  beginResetModel();
+  for (auto n = listPaths.size() - 1; n >= 0; n--) {
+    if (!new_paths.contains(listPaths[n])) {
+      remove(static_cast<int>(n));
+    }
+  }
+
+  std::set<std::filesystem::path> current_paths(listPaths.begin(), listPaths.end());
+
+  QList<std::filesystem::path> added;
 
   for (const auto& v : paths) {
-    if (!current_list.contains(v)) {
-      append(v);
+    if (current_paths.insert(v).second) {
+      added.append(v);
     }
   }
 
-  for (const auto& v : current_list) {
-    if (!paths.contains(v)) {
-      remove(v);
-    }
+  if (added.empty()) {
+    return;
   }
 
-  endResetModel();
+  beginInsertRows(QModelIndex(), listPaths.size(), listPaths.size() + added.size() - 1);
+
+  listPaths.append(added);
+
+  endInsertRows();
 }
@@ -19,7 +19,8 @@
 
 #include "presets_manager.hpp"
 #include <qcontainerfwd.h>
-#include <qfilesystemwatcher.h>
+#include <qnamespace.h>
+#include <qobject.h>
 #include <qqml.h>
 #include <qsortfilterproxymodel.h>
 #include <qstandardpaths.h>
@@ -29,6 +30,7 @@
 #include <KLocalizedString>
 #include <QString>
 #include <algorithm>
+#include <array>
 #include <exception>
 #include <filesystem>
 #include <format>
@@ -40,9 +42,11 @@
 #include <nlohmann/json_fwd.hpp>
 #include <optional>
 #include <ranges>
+#include <set>
 #include <sndfile.hh>
 #include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 #include "autogain_preset.hpp"
 #include "bass_enhancer_preset.hpp"
@@ -50,17 +54,21 @@
 #include "compressor_preset.hpp"
 #include "config.h"
 #include "convolver_kernel_manager.hpp"
+#include "convolver_kernel_store.hpp"
 #include "convolver_preset.hpp"
 #include "crossfeed_preset.hpp"
 #include "crusher_preset.hpp"
 #include "crystalizer_preset.hpp"
+#include "db_manager.hpp"
 #include "deepfilternet_preset.hpp"
 #include "deesser_preset.hpp"
 #include "delay_preset.hpp"
 #include "easyeffects_db.h"
+#include "easyeffects_db_convolver.h"
 #include "easyeffects_db_streaminputs.h"
 #include "easyeffects_db_streamoutputs.h"
 #include "echo_canceller_preset.hpp"
+#include "effects_base.hpp"
 #include "equalizer_preset.hpp"
 #include "exciter_preset.hpp"
 #include "expander_preset.hpp"
@@ -78,8 +86,10 @@
 #include "presets_autoload_manager.hpp"
 #include "presets_directory_manager.hpp"
 #include "presets_irs_manager.hpp"
+#include "presets_json_cache.hpp"
 #include "presets_list_model.hpp"
 #include "presets_rnnoise_manager.hpp"
+#include "pw_manager.hpp"
 #include "reverb_preset.hpp"
 #include "rnnoise_preset.hpp"
 #include "speex_preset.hpp"
@@ -87,6 +97,28 @@
 #include "tags_plugin_name.hpp"
 #include "util.hpp"
 #include "voice_suppressor_preset.hpp"
+#include "worker_pool.hpp"
+
+namespace {
+
+/**
+ * Reads the file once so that it is in the page cache when the plugin that
+ * uses it is loaded.
+ */
+void prefetch_file(const std::filesystem::path& path) {
+  std::ifstream is(path, std::ios::binary);
+
+  if (!is) {
+    return;
+  }
+
+  std::array<char, 65536> buffer{};
+
+  while (is.read(buffer.data(), buffer.size())) {
+  }
+}
+
+}  // namespace
 
 namespace presets {
 
@@ -101,6 +133,33 @@ Manager::Manager() : outputListModel(new ListModel(this)), inputListModel(new Li
   prepare_last_used_preset_key(PipelineType::output);
 
   connect(&autoload_manager, &AutoloadManager::loadPresetRequested, this, &Manager::loadLocalPresetFile);
+
+  // Keeping the presets used by the autoload profiles parsed in memory.
+
+  prewarm_autoload_presets();
+
+  connect(&autoload_manager, &AutoloadManager::profilesChanged, this, &Manager::prewarm_autoload_presets);
+
+  connect(&catalog, &Catalog::fileAdded, this, [this](Catalog::Kind kind) {
+    if (kind == Catalog::Kind::input || kind == Catalog::Kind::output) {
+      prewarm_autoload_presets();
+    }
+  });
+
+  connect(&catalog, &Catalog::fileModified, this, [this](Catalog::Kind kind) {
+    if (kind == Catalog::Kind::input || kind == Catalog::Kind::output) {
+      prewarm_autoload_presets();
+    }
+  });
+
+  connect(DbMain::self(), &DbMain::inputAutoloadingFallbackPresetChanged, this, &Manager::prewarm_autoload_presets);
+  connect(DbMain::self(), &DbMain::outputAutoloadingFallbackPresetChanged, this, &Manager::prewarm_autoload_presets);
+}
+
+Manager::~Manager() {
+  if (prewarm_worker != nullptr) {
+    WorkerPool::self().release(prewarm_worker);
+  }
 }
 
 void Manager::initialize_qml_types() {
@@ -138,19 +197,33 @@ void Manager::initialize_qml_types() {
 }
 
 void Manager::refresh_list_models() {
-  inputListModel->update(dir_manager.getLocalPresetsPaths(PipelineType::input));
-  outputListModel->update(dir_manager.getLocalPresetsPaths(PipelineType::output));
+  inputListModel->update(catalog.paths(Catalog::Kind::input));
+  outputListModel->update(catalog.paths(Catalog::Kind::output));
 }
 
 void Manager::prepare_filesystem_watchers() {
-  user_input_watcher.addPath(QString::fromStdString(dir_manager.userInputDir().string()));
-  user_output_watcher.addPath(QString::fromStdString(dir_manager.userOutputDir().string()));
+  auto model_of = [this](Catalog::Kind kind) -> ListModel* {
+    switch (kind) {
+      case Catalog::Kind::input:
+        return inputListModel;
+      case Catalog::Kind::output:
+        return outputListModel;
+      default:
+        return nullptr;
+    }
+  };
 
-  connect(&user_input_watcher, &QFileSystemWatcher::directoryChanged,
-          [&]() { inputListModel->update(dir_manager.getLocalPresetsPaths(PipelineType::input)); });
+  connect(&catalog, &Catalog::fileAdded, this, [=](Catalog::Kind kind, const std::filesystem::path& path) {
+    if (auto* model = model_of(kind)) {
+      model->append(path);
+    }
+  });
 
-  connect(&user_output_watcher, &QFileSystemWatcher::directoryChanged,
-          [&]() { outputListModel->update(dir_manager.getLocalPresetsPaths(PipelineType::output)); });
+  connect(&catalog, &Catalog::fileRemoved, this, [=](Catalog::Kind kind, const std::filesystem::path& path) {
+    if (auto* model = model_of(kind)) {
+      model->remove(path);
+    }
+  });
 }
 
 void Manager::prepare_last_used_preset_key(const PipelineType& pipeline_type) {
@@ -160,13 +233,7 @@ void Manager::prepare_last_used_preset_key(const PipelineType& pipeline_type) {
   bool reset_key = true;
 
   if (!preset_name.isEmpty()) {
-    for (const auto& p : dir_manager.getLocalPresetsPaths(pipeline_type)) {
-      if (p.stem().string() == preset_name.toStdString()) {
-        reset_key = false;
-
-        break;
-      }
-    }
+    reset_key = !catalog.contains(Catalog::kind_of(pipeline_type), preset_name.toStdString());
   } else {
     reset_key = false;
   }
@@ -184,7 +251,7 @@ void Manager::prepare_last_used_preset_key(const PipelineType& pipeline_type) {
 }
 
 auto Manager::get_local_presets_paths(const PipelineType& pipeline_type) -> QList<std::filesystem::path> {
-  return dir_manager.getLocalPresetsPaths(pipeline_type);
+  return catalog.paths(Catalog::kind_of(pipeline_type));
 }
 
 void Manager::refreshCommunityPresets(const PipelineType& pipeline_type) {
@@ -431,17 +498,12 @@ bool Manager::renameLocalPresetFile(const PipelineType& pipeline_type, const QSt
   return true;
 }
 
-auto Manager::read_effects_pipeline_from_preset(const PipelineType& pipeline_type,
-                                                const std::filesystem::path& input_file,
-                                                nlohmann::json& json,
-                                                std::vector<std::string>& plugins) -> bool {
+auto Manager::read_plugins_order(const PipelineType& pipeline_type,
+                                 const nlohmann::json& json,
+                                 std::vector<std::string>& plugins) -> bool {
   const auto* pipeline_type_str = (pipeline_type == PipelineType::input) ? "input" : "output";
 
   try {
-    std::ifstream is(input_file);
-
-    is >> json;
-
     for (const auto& p : json.at(pipeline_type_str).at("plugins_order").get<std::vector<std::string>>()) {
       for (const auto& v : tags::plugin_name::Model::self().getBaseNames()) {
         if (p.starts_with(v.toStdString())) {
@@ -470,6 +532,16 @@ auto Manager::read_effects_pipeline_from_preset(const PipelineType& pipeline_typ
     return false;
   }
 
+  return true;
+}
+
+auto Manager::read_effects_pipeline_from_preset(const PipelineType& pipeline_type,
+                                                const nlohmann::json& json,
+                                                std::vector<std::string>& plugins) -> bool {
+  if (!read_plugins_order(pipeline_type, json, plugins)) {
+    return false;
+  }
+
   auto new_list = QStringList();
 
   for (const auto& app : plugins) {
@@ -488,6 +560,105 @@ auto Manager::read_effects_pipeline_from_preset(const PipelineType& pipeline_typ
   return true;
 }
 
+auto Manager::remap_instance_ids(const PipelineType& pipeline_type,
+                                 const nlohmann::json& json,
+                                 std::vector<std::string>& plugins) -> nlohmann::json {
+  const auto* section = (pipeline_type == PipelineType::input) ? "input" : "output";
+
+  const auto live = (pipeline_type == PipelineType::output) ? DbStreamOutputs::plugins() : DbStreamInputs::plugins();
+
+  auto& model = tags::plugin_name::Model::self();
+
+  // The highest instance id used by each plugin, in the running pipeline or in the preset.
+
+  std::map<QString, int> last_id;
+
+  auto track = [&](const QString& name) {
+    const auto base = model.getBaseName(name);
+
+    last_id[base] = std::max(last_id[base], tags::plugin_name::get_id(name).toInt());
+  };
+
+  std::ranges::for_each(live, track);
+
+  for (const auto& name : plugins) {
+    track(QString::fromStdString(name));
+  }
+
+  auto remapped = json;
+
+  auto& node = remapped[section];
+
+  for (auto& name : plugins) {
+    const auto qname = QString::fromStdString(name);
+
+    if (!live.contains(qname)) {
+      continue;
+    }
+
+    const auto base = model.getBaseName(qname);
+
+    auto new_name = std::format("{}#{}", base.toStdString(), ++last_id[base]);
+
+    // Old presets use the base name as key.
+
+    const auto key = node.contains(name) ? name : base.toStdString();
+
+    if (node.contains(key)) {
+      node[new_name] = node[key];
+    }
+
+    name = std::move(new_name);
+  }
+
+  return remapped;
+}
+
+auto Manager::switch_preset_chain(const PipelineType& pipeline_type, const nlohmann::json& json) -> bool {
+  /**
+   * The plugins of the preset get instance ids that are not used by the running chain. This way their settings can be
+   * loaded without touching the plugins that are playing, and the pipeline can build the new chain next to the
+   * running one.
+   */
+
+  auto* pipeline = (pipeline_type == PipelineType::output) ? soe : sie;
+
+  pipeline->cancel_chain_switch();
+
+  std::vector<std::string> plugins;
+
+  if (!read_plugins_order(pipeline_type, json, plugins)) {
+    return false;
+  }
+
+  const auto remapped = remap_instance_ids(pipeline_type, json, plugins);
+
+  auto new_list = QStringList();
+
+  for (const auto& name : plugins) {
+    new_list.append(QString::fromStdString(name));
+  }
+
+  db::Manager::self().create_plugin_dbs(pipeline_type, new_list);
+
+  if (!load_blocklist(pipeline_type, remapped) || !read_plugins_preset(pipeline_type, plugins, remapped)) {
+    return false;
+  }
+
+  if (!pipeline->switch_chain(new_list)) {
+    switch (pipeline_type) {
+      case PipelineType::input:
+        DbStreamInputs::setPlugins(new_list);
+        break;
+      case PipelineType::output:
+        DbStreamOutputs::setPlugins(new_list);
+        break;
+    }
+  }
+
+  return true;
+}
+
 auto Manager::read_plugins_preset(const PipelineType& pipeline_type,
                                   const std::vector<std::string>& plugins,
                                   const nlohmann::json& json) -> bool {
@@ -527,18 +698,35 @@ void Manager::write_plugins_preset(const PipelineType& pipeline_type,
 }
 
 auto Manager::load_preset_file(const PipelineType& pipeline_type, const std::filesystem::path& input_file) -> bool {
-  nlohmann::json json;
+  // Autoload presets are usually already parsed by the prewarm.
+  const auto json = json_cache.read(input_file);
+
+  if (json == nullptr) {
+    notify_error(PresetError::pipeline_format);
+
+    return false;
+  }
+
+  if (DbMain::seamlessPresetSwitching() && (pipeline_type == PipelineType::output ? soe : sie) != nullptr) {
+    if (switch_preset_chain(pipeline_type, *json)) {
+      util::debug(std::format("Switching to the preset: {}", input_file.string()));
+
+      return true;
+    }
+
+    return false;
+  }
 
   std::vector<std::string> plugins;
 
   // Read effects_pipeline
-  if (!read_effects_pipeline_from_preset(pipeline_type, input_file, json, plugins)) {
+  if (!read_effects_pipeline_from_preset(pipeline_type, *json, plugins)) {
     return false;
   }
 
   // After the plugin order list, load the blocklist and then
   // apply the parameters of the loaded plugins.
-  if (load_blocklist(pipeline_type, json) && read_plugins_preset(pipeline_type, plugins, json)) {
+  if (load_blocklist(pipeline_type, *json) && read_plugins_preset(pipeline_type, plugins, *json)) {
     util::debug(std::format("Successfully loaded the preset: {}", input_file.string()));
 
     return true;
@@ -746,6 +934,216 @@ void Manager::autoload(const PipelineType& pipeline_type, const QString& device_
   autoload_manager.load(pipeline_type, device_name, device_route);
 }
 
+void Manager::prewarm_autoload_presets() {
+  for (const auto& pipeline_type : {PipelineType::input, PipelineType::output}) {
+    std::set<std::string> names;
+
+    for (const auto& profile : autoload_manager.getProfiles(pipeline_type)) {
+      names.insert(profile.value("preset-name", ""));
+    }
+
+    const auto uses_fallback = (pipeline_type == PipelineType::input) ? DbMain::inputAutoloadingUsesFallback()
+                                                                      : DbMain::outputAutoloadingUsesFallback();
+
+    if (uses_fallback) {
+      names.insert(((pipeline_type == PipelineType::input) ? DbMain::inputAutoloadingFallbackPreset()
+                                                           : DbMain::outputAutoloadingFallbackPreset())
+                       .toStdString());
+    }
+
+    names.erase("");
+
+    for (const auto& name : names) {
+      prewarm_preset(pipeline_type, name);
+    }
+
+    if (prewarm_worker == nullptr) {
+      continue;
+    }
+
+    // Kernels of presets that are no longer autoload targets are released.
+
+    // NOLINTBEGIN(clang-analyzer-cplusplus.NewDeleteLeaks)
+
+    QMetaObject::invokeMethod(
+        prewarm_worker,
+        [this, pipeline_type, names]() {
+          std::erase_if(prewarmed_kernels, [&](const auto& entry) {
+            return entry.first.first == pipeline_type && !names.contains(entry.first.second);
+          });
+        },
+        Qt::QueuedConnection);
+
+    // NOLINTEND(clang-analyzer-cplusplus.NewDeleteLeaks)
+  }
+}
+
+void Manager::prewarm_preset(const PipelineType& pipeline_type, const std::string& name) {
+  if (prewarm_worker == nullptr) {
+    prewarm_worker = new PoolWorker();
+
+    // Prefetching reads whole impulse responses. It gets a low priority thread of its own instead of a pool thread
+    // shared with the plugins.
+
+    WorkerPool::self().attach_dedicated(prewarm_worker);
+  }
+
+  const auto conf_dir =
+      (pipeline_type == PipelineType::output) ? dir_manager.userOutputDir() : dir_manager.userInputDir();
+
+  const auto file = conf_dir / std::filesystem::path{name + DirectoryManager::json_ext};
+
+  const auto irs_dir = dir_manager.userIrsDir();
+  const auto rnnoise_dir = dir_manager.userRnnoiseDir();
+
+  // NOLINTBEGIN(clang-analyzer-cplusplus.NewDeleteLeaks)
+
+  QMetaObject::invokeMethod(
+      prewarm_worker,
+      [this, pipeline_type, name, file, irs_dir, rnnoise_dir]() {
+        const auto json = json_cache.read(file);
+
+        if (json == nullptr) {
+          return;
+        }
+
+        const auto metadata = Catalog::metadata_from_json(pipeline_type, *json);
+
+        if (!metadata) {
+          return;
+        }
+
+        for (const auto& irs : metadata->irs) {
+          prefetch_file(irs_dir / std::filesystem::path{irs + DirectoryManager::irs_ext});
+          prefetch_file(irs_dir / std::filesystem::path{irs + DirectoryManager::sofa_ext});
+        }
+
+        for (const auto& model : metadata->rnnoise_models) {
+          prefetch_file(rnnoise_dir / std::filesystem::path{model + DirectoryManager::rnnoise_ext});
+        }
+
+        if (!metadata->irs.empty()) {
+          QMetaObject::invokeMethod(
+              this, [this, pipeline_type, name, json]() { prewarm_kernels(pipeline_type, name, json); },
+              Qt::QueuedConnection);
+        }
+
+        util::debug(std::format("Prewarmed the preset {}", file.string()));
+      },
+      Qt::QueuedConnection);
+
+  // NOLINTEND(clang-analyzer-cplusplus.NewDeleteLeaks)
+}
+
+void Manager::prewarm_kernels(const PipelineType& pipeline_type,
+                              const std::string& name,
+                              const std::shared_ptr<const nlohmann::json>& json) {
+  /**
+   * The convolver kernels are decoded here so that loading the preset finds
+   * them in the kernel store. They are decoded for the rate the pipeline runs
+   * at now and with the settings the convolver instance will have once the
+   * preset is loaded. The trim settings are not saved in presets, so they are
+   * taken from the existing instance. Convolvers without one are left to be
+   * decoded when the preset is loaded.
+   */
+
+  auto* effects = (pipeline_type == PipelineType::input) ? sie : soe;
+
+  if (effects == nullptr) {
+    return;
+  }
+
+  // Until the pipeline has processed audio its rate is the default rate of the graph.
+
+  uint rate = effects->output_level->rate;
+
+  if (rate == 0U) {
+    util::str_to_num(effects->pm->defaultClockRate.toStdString(), rate);
+  }
+
+  if (rate == 0U) {
+    return;
+  }
+
+  const auto* pt_key = (pipeline_type == PipelineType::output) ? "output" : "input";
+
+  std::vector<PrewarmKernel> kernels;
+
+  try {
+    const auto& section = json->at(pt_key);
+
+    for (const auto& plugin : section.value("plugins_order", std::vector<std::string>{})) {
+      if (!plugin.starts_with(tags::plugin_name::BaseName::convolver.toStdString()) || !section.contains(plugin)) {
+        continue;
+      }
+
+      auto* settings = db::Manager::self().get_plugin_db<DbConvolver>(pipeline_type, QString::fromStdString(plugin));
+
+      if (settings == nullptr) {
+        continue;
+      }
+
+      const auto& instance = section.at(plugin);
+
+      PrewarmKernel kernel{.kernel_name = instance.value("kernel-name", ""),
+                           .options = ConvolverKernelManager::options_from(settings),
+                           .ir_width = instance.value("ir-width", settings->defaultIrWidthValue()),
+                           .autogain = instance.value("autogain", settings->defaultAutogainValue())};
+
+      const auto sofa = instance.value("sofa", nlohmann::json::object());
+
+      kernel.options.sofa_azimuth = sofa.value("azimuth", settings->defaultTargetSofaAzimuthValue());
+      kernel.options.sofa_elevation = sofa.value("elevation", settings->defaultTargetSofaElevationValue());
+      kernel.options.sofa_radius = sofa.value("radius", settings->defaultTargetSofaRadiusValue());
+
+      if (!kernel.kernel_name.empty()) {
+        kernels.push_back(kernel);
+      }
+    }
+  } catch (const nlohmann::json::exception& e) {
+    util::warning(e.what());
+
+    return;
+  }
+
+  // NOLINTBEGIN(clang-analyzer-cplusplus.NewDeleteLeaks)
+
+  QMetaObject::invokeMethod(
+      prewarm_worker,
+      [this, pipeline_type, name, rate, kernels]() {
+        auto& store = ConvolverKernelStore::self();
+
+        std::vector<ConvolverKernelStore::Kernel> list;
+
+        for (const auto& kernel : kernels) {
+          ConvolverKernelManager kernel_manager(kernel.options, pipeline_type);
+
+          const auto file_path = kernel_manager.searchKernelPath(kernel.kernel_name);
+
+          if (file_path.empty()) {
+            continue;
+          }
+
+          const auto decoded = store.get_decoded(ConvolverKernelStore::make_key(file_path, kernel.options, rate),
+                                                 [&]() { return kernel_manager.loadKernel(kernel.kernel_name, rate); });
+
+          if (!decoded->isValid()) {
+            continue;
+          }
+
+          list.push_back(decoded);
+          list.push_back(store.get_shaped(decoded, kernel.ir_width, kernel.autogain));
+        }
+
+        prewarmed_kernels.insert_or_assign(std::make_pair(pipeline_type, name), std::move(list));
+
+        util::debug(std::format("Prewarmed the convolver kernels of the preset {} at {} Hz", name, rate));
+      },
+      Qt::QueuedConnection);
+
+  // NOLINTEND(clang-analyzer-cplusplus.NewDeleteLeaks)
+}
+
 void Manager::set_last_preset_keys(const PipelineType& pipeline_type,
                                    const QString& preset_name,
                                    const QString& package_name) {
@@ -792,6 +1190,17 @@ void Manager::set_last_preset_keys(const PipelineType& pipeline_type,
   }
 }
 
+void Manager::set_pipelines(EffectsBase* input, EffectsBase* output) {
+  sie = input;
+  soe = output;
+
+  // The convolver kernels can only be prewarmed once the rate of the pipelines is known.
+
+  if (sie != nullptr && soe != nullptr) {
+    prewarm_autoload_presets();
+  }
+}
+
 auto Manager::preset_file_exists(const PipelineType& pipeline_type, const std::string& name) -> bool {
   const auto conf_dir =
       (pipeline_type == PipelineType::output) ? dir_manager.userOutputDir() : dir_manager.userInputDir();
@@ -976,11 +1385,7 @@ void Manager::update_used_presets_list(const PipelineType& pipeline_type, const
   // removing from the list presets that are not installed anymore
 
   names.removeIf([&](const QString& name_and_count) {
-    return std::ranges::none_of(dir_manager.getLocalPresetsPaths(pipeline_type), [&](const auto p) {
-      auto name = name_and_count.split(":")[0];
-
-      return name == p.stem().string();
-    });
+    return !catalog.contains(Catalog::kind_of(pipeline_type), name_and_count.split(":")[0].toStdString());
   });
 
   bool contains_name = false;
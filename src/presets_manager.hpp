@@ -20,25 +20,33 @@
 #pragma once
 
 #include <qcontainerfwd.h>
-#include <qfilesystemwatcher.h>
 #include <qobject.h>
 #include <qtmetamacros.h>
 #include <qtypes.h>
 #include <filesystem>
+#include <map>
 #include <memory>
 #include <nlohmann/json.hpp>
 #include <nlohmann/json_fwd.hpp>
 #include <optional>
 #include <string>
+#include <utility>
 #include <vector>
+#include "convolver_kernel_manager.hpp"
+#include "convolver_kernel_store.hpp"
 #include "pipeline_type.hpp"
 #include "plugin_preset_base.hpp"
 #include "presets_autoload_manager.hpp"
+#include "presets_catalog.hpp"
 #include "presets_community_manager.hpp"
 #include "presets_directory_manager.hpp"
 #include "presets_irs_manager.hpp"
+#include "presets_json_cache.hpp"
 #include "presets_list_model.hpp"
 #include "presets_rnnoise_manager.hpp"
+#include "worker_pool.hpp"
+
+class EffectsBase;
 
 namespace presets {
 
@@ -51,7 +59,7 @@ class Manager : public QObject {
   auto operator=(const Manager&) -> Manager& = delete;
   Manager(const Manager&&) = delete;
   auto operator=(const Manager&&) -> Manager& = delete;
-  ~Manager() override = default;
+  ~Manager() override;
 
   static Manager& self() {
     static Manager pm;
@@ -71,6 +79,11 @@ class Manager : public QObject {
 
   void autoload(const PipelineType& pipeline_type, const QString& device_name, const QString& device_route);
 
+  /**
+   * The pipelines are needed by the seamless preset switching.
+   */
+  void set_pipelines(EffectsBase* input, EffectsBase* output);
+
   auto get_local_presets_paths(const PipelineType& pipeline_type) -> QList<std::filesystem::path>;
 
   Q_INVOKABLE bool add(const PipelineType& pipeline_type, const QString& name);
@@ -127,18 +140,42 @@ class Manager : public QObject {
  private:
   DirectoryManager dir_manager;
 
-  AutoloadManager autoload_manager{dir_manager};
+  Catalog catalog{dir_manager};
+
+  JsonCache json_cache;
 
-  CommunityManager community_manager{dir_manager};
+  AutoloadManager autoload_manager{dir_manager, json_cache};
 
-  IrsManager irs_manager{dir_manager};
+  CommunityManager community_manager{dir_manager, catalog};
 
-  RnnoiseManager rnnoise_manager{dir_manager};
+  IrsManager irs_manager{dir_manager, catalog};
 
-  QFileSystemWatcher user_output_watcher, user_input_watcher;
+  RnnoiseManager rnnoise_manager{dir_manager, catalog};
 
   ListModel *outputListModel, *inputListModel;
 
+  PoolWorker* prewarm_worker = nullptr;
+
+  // A convolver of a prewarmed preset and the settings its kernel is decoded with.
+  struct PrewarmKernel {
+    std::string kernel_name;
+
+    ConvolverKernelManager::Options options;
+
+    int ir_width = 0;
+
+    bool autogain = false;
+  };
+
+  /**
+   * Kernels decoded by the prewarm for the autoload presets. The kernel store
+   * only keeps weak references, so they are held here until the preset is no
+   * longer an autoload target. Only touched by the prewarm worker.
+   */
+  std::map<std::pair<PipelineType, std::string>, std::vector<ConvolverKernelStore::Kernel>> prewarmed_kernels;
+
+  EffectsBase *sie = nullptr, *soe = nullptr;
+
   void initialize_qml_types();
 
   void refresh_list_models();
@@ -147,9 +184,18 @@ class Manager : public QObject {
 
   static void write_plugins_preset(const PipelineType& pipeline_type, const QStringList& plugins, nlohmann::json& json);
 
+  auto read_plugins_order(const PipelineType& pipeline_type,
+                          const nlohmann::json& json,
+                          std::vector<std::string>& plugins) -> bool;
+
+  static auto remap_instance_ids(const PipelineType& pipeline_type,
+                                 const nlohmann::json& json,
+                                 std::vector<std::string>& plugins) -> nlohmann::json;
+
+  auto switch_preset_chain(const PipelineType& pipeline_type, const nlohmann::json& json) -> bool;
+
   auto read_effects_pipeline_from_preset(const PipelineType& pipeline_type,
-                                         const std::filesystem::path& input_file,
-                                         nlohmann::json& json,
+                                         const nlohmann::json& json,
                                          std::vector<std::string>& plugins) -> bool;
 
   auto read_plugins_preset(const PipelineType& pipeline_type,
@@ -174,6 +220,14 @@ class Manager : public QObject {
       -> std::optional<std::unique_ptr<PluginPresetBase>>;
 
   void update_used_presets_list(const PipelineType& pipeline_type, const QString& name);
+
+  void prewarm_autoload_presets();
+
+  void prewarm_preset(const PipelineType& pipeline_type, const std::string& name);
+
+  void prewarm_kernels(const PipelineType& pipeline_type,
+                       const std::string& name,
+                       const std::shared_ptr<const nlohmann::json>& json);
 };
 
 }  // namespace presets
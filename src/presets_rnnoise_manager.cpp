@@ -19,27 +19,34 @@
 
 #include "presets_rnnoise_manager.hpp"
 #include <qcontainerfwd.h>
-#include <qfilesystemwatcher.h>
 #include <qtmetamacros.h>
 #include <qtypes.h>
 #include <qurl.h>
 #include <filesystem>
 #include <format>
 #include <string>
+#include "presets_catalog.hpp"
 #include "presets_directory_manager.hpp"
 #include "presets_list_model.hpp"
 #include "util.hpp"
 
 namespace presets {
 
-RnnoiseManager::RnnoiseManager(DirectoryManager& directory_manager)
+RnnoiseManager::RnnoiseManager(DirectoryManager& directory_manager, Catalog& catalog)
     : dir_manager(directory_manager), model(new ListModel(this, ListModel::ModelType::RNNOISE)) {
-  model->update(dir_manager.getLocalRnnoisePaths());
+  model->update(catalog.paths(Catalog::Kind::rnnoise));
 
-  watcher.addPath(QString::fromStdString(dir_manager.userRnnoiseDir().string()));
+  connect(&catalog, &Catalog::fileAdded, this, [&](Catalog::Kind kind, const std::filesystem::path& path) {
+    if (kind == Catalog::Kind::rnnoise) {
+      model->append(path);
+    }
+  });
 
-  connect(&watcher, &QFileSystemWatcher::directoryChanged,
-          [&]() { model->update(dir_manager.getLocalRnnoisePaths()); });
+  connect(&catalog, &Catalog::fileRemoved, this, [&](Catalog::Kind kind, const std::filesystem::path& path) {
+    if (kind == Catalog::Kind::rnnoise) {
+      model->remove(path);
+    }
+  });
 }
 
 auto RnnoiseManager::get_model() -> ListModel* {
@@ -19,13 +19,13 @@
 
 #pragma once
 
-#include <qfilesystemwatcher.h>
 #include <qhashfunctions.h>
 #include <qlist.h>
 #include <qobject.h>
 #include <qtmetamacros.h>
 #include <qtypes.h>
 #include <string>
+#include "presets_catalog.hpp"
 #include "presets_directory_manager.hpp"
 #include "presets_list_model.hpp"
 
@@ -37,7 +37,7 @@ class RnnoiseManager : public QObject {
  public:
   enum class ImportState { success, no_regular_file };
 
-  explicit RnnoiseManager(DirectoryManager& directory_manager);
+  RnnoiseManager(DirectoryManager& directory_manager, Catalog& catalog);
   RnnoiseManager(const RnnoiseManager&) = delete;
   auto operator=(const RnnoiseManager&) -> RnnoiseManager& = delete;
   RnnoiseManager(const RnnoiseManager&&) = delete;
@@ -55,8 +55,6 @@ class RnnoiseManager : public QObject {
 
   ListModel* model{nullptr};
 
-  QFileSystemWatcher watcher;
-
   auto import_rnnoise_file(const std::string& file_path) -> ImportState;
 };
 
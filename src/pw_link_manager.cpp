@@ -40,6 +40,7 @@
 #include <stdexcept>
 #include <utility>
 #include <vector>
+#include "channel_layout.hpp"
 #include "pw_model_nodes.hpp"
 #include "pw_objects.hpp"
 #include "util.hpp"
@@ -320,25 +321,44 @@ auto LinkManager::get_node_ports(const uint& node_id, const QString& direction)
   return result;
 }
 
+auto LinkManager::linked_output_channels(const uint& output_node_id, const uint& input_node_id) const
+    -> std::vector<std::string> {
+  std::vector<std::string> result;
+
+  for (const auto& [outp, inp] :
+       find_matching_ports(get_node_ports(output_node_id, "out"), get_node_ports(input_node_id, "in"), false)) {
+    result.push_back(outp.audio_channel);
+  }
+
+  return result;
+}
+
 auto LinkManager::find_matching_ports(const std::vector<PortInfo>& output_ports,
                                       const std::vector<PortInfo>& input_ports,
                                       const bool& probe_link) -> std::vector<std::pair<PortInfo, PortInfo>> {
   std::vector<std::pair<PortInfo, PortInfo>> matches;
   bool use_audio_channel = true;
 
-  // Determine if we should use audio channel matching
+  /**
+   * Determine if we should use audio channel matching. Stereo nodes are linked
+   * by position when every port is FL or FR and by port order otherwise. With a
+   * surround layout any speaker position is matched, so the channels one side
+   * does not have are left unlinked. Mono, aux and unnamed channels fall back to
+   * the port order.
+   */
+  const auto is_stereo = [](const PortInfo& port) { return port.audio_channel == "FL" || port.audio_channel == "FR"; };
+
+  const auto is_positional = [](const PortInfo& port) {
+    return !port.audio_channel.empty() && port.audio_channel != "MONO" && port.audio_channel != "UNK" &&
+           !port.audio_channel.starts_with("AUX");
+  };
+
   if (!probe_link) {
-    for (const auto& port : output_ports) {
-      if (port.audio_channel != "FL" && port.audio_channel != "FR") {
-        use_audio_channel = false;
-        break;
-      }
-    }
-    for (const auto& port : input_ports) {
-      if (port.audio_channel != "FL" && port.audio_channel != "FR") {
-        use_audio_channel = false;
-        break;
-      }
+    if (channel_layout::n_channels() > 2U) {
+      use_audio_channel =
+          std::ranges::all_of(output_ports, is_positional) && std::ranges::all_of(input_ports, is_positional);
+    } else {
+      use_audio_channel = std::ranges::all_of(output_ports, is_stereo) && std::ranges::all_of(input_ports, is_stereo);
     }
   }
 
@@ -68,6 +68,10 @@ class LinkManager : public QObject {
 
   [[nodiscard]] auto get_node_ports(const uint& node_id, const QString& direction = "") const -> std::vector<PortInfo>;
 
+  // Audio channels of the output ports that link_nodes() connects from output_node_id to input_node_id.
+  [[nodiscard]] auto linked_output_channels(const uint& output_node_id, const uint& input_node_id) const
+      -> std::vector<std::string>;
+
  Q_SIGNALS:
   void linkChanged(LinkInfo link);
   void linkRemoved();
@@ -325,6 +325,8 @@ Manager::Manager()
   pw_properties_set(props_context, PW_KEY_MEDIA_CATEGORY, "Manager");
   pw_properties_set(props_context, PW_KEY_MEDIA_ROLE, "Music");
 
+  setup_pipeline_data_loops(props_context);
+
   context = pw_context_new(pw_thread_loop_get_loop(thread_loop), props_context, 0);
 
   if (context == nullptr) {
@@ -424,6 +426,52 @@ Manager::~Manager() {
   pw_thread_loop_destroy(thread_loop);
 }
 
+void Manager::setup_pipeline_data_loops(pw_properties* props_context) {
+  if (!DbMain::pipelineDataLoops()) {
+    return;
+  }
+
+  if (util::compare_versions(libraryVersion.toStdString(), "1.1.0") == -1) {
+    util::warning(std::format("PipeWire {} does not support multiple data loops. Both pipelines will share one.",
+                              libraryVersion.toStdString()));
+
+    return;
+  }
+
+  /**
+   * The default loop keeps the data.rt class so that nodes that do not ask for
+   * a specific loop, like the test signals, still find one. The pipeline loops
+   * get their own classes and are only used by filters that select them by name.
+   */
+
+  const auto loop_config = [](const std::string& name, const std::string& loop_class, const int& cpu,
+                              const int& rt_priority) {
+    auto config = std::format("{{ loop.name = {0} thread.name = {0} loop.class = [ {1} ]", name, loop_class);
+
+    if (cpu >= 0) {
+      config += std::format(" thread.affinity = [ {} ]", cpu);
+    }
+
+    if (rt_priority >= 0) {
+      config += std::format(" loop.rt-prio = {}", rt_priority);
+    }
+
+    return config + " }";
+  };
+
+  output_loop_name = "ee-output-loop";
+  input_loop_name = "ee-input-loop";
+
+  const auto data_loops =
+      std::format("[ {} {} {} ]", loop_config("data-loop.0", "data.rt", -1, -1),
+                  loop_config(output_loop_name, "ee.output", DbMain::outputLoopCpu(), DbMain::outputLoopRtPriority()),
+                  loop_config(input_loop_name, "ee.input", DbMain::inputLoopCpu(), DbMain::inputLoopRtPriority()));
+
+  pw_properties_set(props_context, "context.data-loops", data_loops.c_str());
+
+  util::debug(std::format("using pipeline data loops: {}", data_loops));
+}
+
 void Manager::register_models() {
   // NOLINTBEGIN(clang-analyzer-cplusplus.NewDelete)
   qmlRegisterSingletonInstance<pw::Manager>("ee.pipewire", VERSION_MAJOR, VERSION_MINOR, "Manager", this);
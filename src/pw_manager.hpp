@@ -22,6 +22,7 @@
 #include <pipewire/context.h>
 #include <pipewire/core.h>
 #include <pipewire/extensions/metadata.h>
+#include <pipewire/properties.h>
 #include <pipewire/proxy.h>
 #include <pipewire/thread-loop.h>
 #include <qmap.h>
@@ -30,6 +31,7 @@
 #include <spa/utils/hook.h>
 #include <sys/types.h>
 #include <cstdint>
+#include <string>
 #include <vector>
 #include "pw_client_manager.hpp"
 #include "pw_device_manager.hpp"
@@ -77,6 +79,12 @@ class Manager : public QObject {
 
   inline static bool exiting = false;
 
+  /**
+   * Names of the data loops the output and input pipelines run on. They are
+   * empty when the context was created without dedicated pipeline loops.
+   */
+  std::string output_loop_name, input_loop_name;
+
   spa_hook metadata_listener{};
 
   QString defaultInputDeviceName, defaultOutputDeviceName;
@@ -170,6 +178,7 @@ class Manager : public QObject {
   std::vector<DeviceInfo> list_devices;
 
   void register_models();
+  void setup_pipeline_data_loops(pw_properties* props_context);
   void set_metadata_target_node(const uint& origin_id, const uint& target_id, const uint64_t& target_serial) const;
 };
 
@@ -55,6 +55,7 @@
 #include <string>
 #include <utility>
 #include <vector>
+#include "channel_layout.hpp"
 #include "db_manager.hpp"
 #include "pw_metadata_manager.hpp"
 #include "tags_app.hpp"
@@ -675,7 +676,7 @@ auto NodeManager::load_virtual_devices(pw_core* core) -> std::pair<pw_proxy*, pw
   pw_properties_set(props_sink, PW_KEY_NODE_VIRTUAL, "true");
   pw_properties_set(props_sink, PW_KEY_NODE_GROUP, "ee_sink_group");
   pw_properties_set(props_sink, "factory.name", "support.null-audio-sink");
-  pw_properties_set(props_sink, "audio.position", "FL,FR");
+  pw_properties_set(props_sink, "audio.position", channel_layout::audio_position().c_str());
   pw_properties_set(props_sink, "monitor.channel-volumes", "false");
   pw_properties_set(props_sink, "monitor.passthrough", "true");
   pw_properties_set(props_sink, "priority.session", "0");
@@ -696,7 +697,7 @@ auto NodeManager::load_virtual_devices(pw_core* core) -> std::pair<pw_proxy*, pw
   pw_properties_set(props_source, PW_KEY_NODE_VIRTUAL, "true");
   pw_properties_set(props_source, PW_KEY_NODE_GROUP, "ee_source_group");
   pw_properties_set(props_source, "factory.name", "support.null-audio-sink");
-  pw_properties_set(props_source, "audio.position", "FL,FR");
+  pw_properties_set(props_source, "audio.position", channel_layout::audio_position().c_str());
   pw_properties_set(props_source, "monitor.channel-volumes", "false");
   pw_properties_set(props_source, "monitor.passthrough", "true");
   pw_properties_set(props_source, "priority.session", "0");
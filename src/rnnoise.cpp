@@ -39,7 +39,7 @@
 #include "db_manager.hpp"
 #include "plugin_base.hpp"
 #include "pw_manager.hpp"
-#include "resampler.hpp"
+#include "multichannel_resampler.hpp"
 #include "tags_plugin_name.hpp"
 #include "util.hpp"
 
@@ -167,11 +167,21 @@ void RNNoise::setup() {
   buf_out_L.clear();
   buf_out_R.clear();
 
-  resampler_inL = std::make_unique<Resampler>(rate, rnnoise_rate);
-  resampler_inR = std::make_unique<Resampler>(rate, rnnoise_rate);
+  resampler_in = std::make_unique<MultichannelResampler>(2U, rate, rnnoise_rate, n_samples);
 
-  resampler_outL = std::make_unique<Resampler>(rnnoise_rate, rate);
-  resampler_outR = std::make_unique<Resampler>(rnnoise_rate, rate);
+  // RNNoise may return one extra block it was holding from the previous call.
+
+  resampler_out = std::make_unique<MultichannelResampler>(2U, rnnoise_rate, rate,
+                                                          resampler_in->max_output_frames() + blocksize);
+
+  resampled_in_L.resize(resampler_in->max_output_frames());
+  resampled_in_R.resize(resampled_in_L.size());
+
+  resampled_data_L.reserve(resampler_in->max_output_frames() + blocksize);
+  resampled_data_R.reserve(resampled_data_L.capacity());
+
+  resampled_out_L.resize(resampler_out->max_output_frames());
+  resampled_out_R.resize(resampled_out_L.size());
 
   resampler_ready = true;
 }
@@ -209,21 +219,21 @@ void RNNoise::process(std::span<float>& left_in,
 
   if (resample) {
     if (resampler_ready) {
-      const auto resampled_inL = resampler_inL->process(left_in);
-      const auto resampled_inR = resampler_inR->process(right_in);
+      const auto n_in = resampler_in->process(left_in, right_in, resampled_in_L, resampled_in_R);
 
       resampled_data_L.resize(0U);
       resampled_data_R.resize(0U);
 
 #ifdef ENABLE_RNNOISE
-      remove_noise(resampled_inL, resampled_inR, resampled_data_L, resampled_data_R);
+      remove_noise(std::span<const float>(resampled_in_L.data(), n_in),
+                   std::span<const float>(resampled_in_R.data(), n_in), resampled_data_L, resampled_data_R);
 #endif
 
-      auto resampled_outL = resampler_outL->process(resampled_data_L);
-      auto resampled_outR = resampler_outR->process(resampled_data_R);
+      const auto n_out = static_cast<long>(
+          resampler_out->process(resampled_data_L, resampled_data_R, resampled_out_L, resampled_out_R));
 
-      buf_out_L.insert(buf_out_L.end(), resampled_outL.begin(), resampled_outL.end());
-      buf_out_R.insert(buf_out_R.end(), resampled_outR.begin(), resampled_outR.end());
+      buf_out_L.insert(buf_out_L.end(), resampled_out_L.begin(), resampled_out_L.begin() + n_out);
+      buf_out_R.insert(buf_out_R.end(), resampled_out_R.begin(), resampled_out_R.begin() + n_out);
     } else {
       buf_out_L.insert(buf_out_L.end(), left_in.begin(), left_in.end());
       buf_out_R.insert(buf_out_R.end(), right_in.begin(), right_in.end());
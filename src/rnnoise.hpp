@@ -39,7 +39,7 @@
 #endif
 
 #include "plugin_base.hpp"
-#include "resampler.hpp"
+#include "multichannel_resampler.hpp"
 
 class RNNoise : public PluginBase {
   Q_OBJECT
@@ -113,10 +113,11 @@ class RNNoise : public PluginBase {
   std::vector<float> buf_out_L, buf_out_R;
 
   std::vector<float> data_L, data_R, data_tmp;
+  std::vector<float> resampled_in_L, resampled_in_R;
   std::vector<float> resampled_data_L, resampled_data_R;
+  std::vector<float> resampled_out_L, resampled_out_R;
 
-  std::unique_ptr<Resampler> resampler_inL, resampler_outL;
-  std::unique_ptr<Resampler> resampler_inR, resampler_outR;
+  std::unique_ptr<MultichannelResampler> resampler_in, resampler_out;
 
 #ifdef ENABLE_RNNOISE
 
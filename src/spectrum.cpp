@@ -20,327 +20,370 @@
 #include "spectrum.hpp"
 #include <fftw3.h>
 #include <qlist.h>
-#include <qnamespace.h>
-#include <qobjectdefs.h>
+#include <qpoint.h>
 #include <qtypes.h>
-#include <QApplication>
-#include <QString>
+#include <sys/types.h>
 #include <algorithm>
-#include <cassert>
 #include <cmath>
 #include <cstddef>
-#include <cstring>
+#include <cstdint>
 #include <format>
 #include <memory>
 #include <mutex>
 #include <numbers>
-#include <span>
 #include <string>
-#include <tuple>
+#include <utility>
+#include "analysis_bus.hpp"
 #include "easyeffects_db_spectrum.h"
-#include "lv2_macros.hpp"
-#include "lv2_wrapper.hpp"
-#include "pipeline_type.hpp"
-#include "plugin_base.hpp"
-#include "pw_manager.hpp"
-#include "tags_plugin_name.hpp"
 #include "util.hpp"
 
-Spectrum::Spectrum(const std::string& tag, pw::Manager* pipe_manager, PipelineType pipe_type, QString instance_id)
-    : PluginBase(tag, "spectrum", tags::plugin_package::Package::ee, instance_id, pipe_manager, pipe_type),
-      settings(DbSpectrum::self()) {
-  bypass = !DbSpectrum::state();
-  // Precompute the Hann window, which is an expensive operation.
-  // https://en.wikipedia.org/wiki/Hann_function
-  for (size_t n = 0; n < n_bands; n++) {
-    hann_window[n] =
-        0.5F *
-        (1.0F - std::cos(2.0F * std::numbers::pi_v<float> * static_cast<float>(n) / static_cast<float>(n_bands - 1)));
-  }
+namespace {
+
+enum Averaging { none, exponential, peak_hold };
 
-  complex_output = fftwf_alloc_complex(output.size());
+enum WindowFunction { hann, hamming, blackman_harris, flat_top, rectangular };
 
-  plan = fftwf_plan_dft_r2c_1d(static_cast<int>(n_bands), real_input.data(), complex_output, FFTW_ESTIMATE);
+auto window_value(const int& type, const size_t& n, const size_t& size) -> float {
+  // https://en.wikipedia.org/wiki/Window_function
 
-  if (plan != nullptr && complex_output != nullptr) {
-    fftw_ready = true;
+  const double x = 2.0 * std::numbers::pi * static_cast<double>(n) / static_cast<double>(size - 1U);
+
+  switch (type) {
+    case hamming:
+      return static_cast<float>(0.54 - (0.46 * std::cos(x)));
+    case blackman_harris:
+      return static_cast<float>(0.35875 - (0.48829 * std::cos(x)) + (0.14128 * std::cos(2.0 * x)) -
+                                (0.01168 * std::cos(3.0 * x)));
+    case flat_top:
+      return static_cast<float>(0.21557895 - (0.41663158 * std::cos(x)) + (0.277263158 * std::cos(2.0 * x)) -
+                                (0.083578947 * std::cos(3.0 * x)) + (0.006947368 * std::cos(4.0 * x)));
+    case rectangular:
+      return 1.0F;
+    default:
+      return static_cast<float>(0.5 * (1.0 - std::cos(x)));
   }
+}
 
-  const auto lv2_plugin_uri = "http://lsp-plug.in/plugins/lv2/comp_delay_x2_stereo";
+}  // namespace
 
-  lv2_wrapper = std::make_unique<lv2::Lv2Wrapper>(lv2_plugin_uri);
+Spectrum::Spectrum(std::string tag, std::shared_ptr<AnalysisBus> analysis_bus)
+    : log_tag(std::move(tag)), settings(DbSpectrum::self()), analysis_bus(std::move(analysis_bus)) {
+  set_bypass(!DbSpectrum::state());
 
-  packageInstalled = lv2_wrapper->found_plugin;
+  connect(settings, &DbSpectrum::stateChanged, this, [&]() { set_bypass(!DbSpectrum::state()); });
+}
 
-  if (!packageInstalled) {
-    util::debug(
-        std::format("{}{} is not installed, spectrum will not have A/V sync compensation", log_tag, lv2_plugin_uri));
-  }
+Spectrum::~Spectrum() {
+  settings->disconnect(this);
 
-  lv2_wrapper->set_control_port_value("mode_l", 2);
-  lv2_wrapper->set_control_port_value("mode_r", 2);
+  set_bypass(true);
 
-  lv2_wrapper->set_control_port_value("dry_l", 0.0F);
-  lv2_wrapper->set_control_port_value("dry_r", 0.0F);
+  std::scoped_lock lock(data_mutex, util::fftw_lock());
 
-  lv2_wrapper->set_control_port_value("wet_l", util::db_to_linear(0.0F));
-  lv2_wrapper->set_control_port_value("wet_r", util::db_to_linear(0.0F));
+  if (plan != nullptr) {
+    fftwf_destroy_plan(plan);
+  }
 
-  BIND_LV2_PORT("time_l", avsyncDelay, setAvsyncDelay, DbSpectrum::avsyncDelayChanged);
-  BIND_LV2_PORT("time_r", avsyncDelay, setAvsyncDelay, DbSpectrum::avsyncDelayChanged);
+  if (complex_output != nullptr) {
+    fftwf_free(complex_output);
+  }
 
-  connect(DbSpectrum::self(), &DbSpectrum::stateChanged, [&]() { bypass = !DbSpectrum::state(); });
+  util::debug(std::format("{}spectrum destroyed", log_tag));
 }
 
-Spectrum::~Spectrum() {
-  stop_worker();
-
+void Spectrum::set_bypass(const bool& state) {
   std::scoped_lock<std::mutex> lock(data_mutex);
 
-  if (connected_to_pw) {
-    disconnect_from_pw();
+  if (state == bypass) {
+    return;
   }
 
-  settings->disconnect();
+  bypass = state;
 
-  fftw_ready = false;
+  // While bypassed we are not a reader and the level meter does not copy its output to the bus.
 
-  if (complex_output != nullptr) {
-    fftwf_free(complex_output);
+  if (bypass) {
+    analysis_bus->remove_reader();
+  } else {
+    analysis_bus->add_reader();
   }
 
-  fftwf_destroy_plan(plan);
-
-  util::debug(std::format("{}{} destroyed", log_tag, name.toStdString()));
+  reset_average();
 }
 
-void Spectrum::reset() {}
+void Spectrum::reset_average() {
+  has_average = false;
+
+  last_frame_end = 0U;
+}
 
-void Spectrum::clear_data() {
-  if (lv2_wrapper == nullptr) {
+void Spectrum::setup_fft(const uint& size, const int& window_type) {
+  if (size == fft_size && window_type == window_function) {
     return;
   }
 
-  {
-    std::scoped_lock<std::mutex> lock(data_mutex);
+  if (size != fft_size) {
+    std::scoped_lock<std::mutex> lock(util::fftw_lock());
+
+    if (plan != nullptr) {
+      fftwf_destroy_plan(plan);
+    }
+
+    if (complex_output != nullptr) {
+      fftwf_free(complex_output);
+    }
+
+    fft_size = size;
+
+    real_input.resize(fft_size);
+    power.resize((fft_size / 2U) + 1U);
+    averaged_power.resize(power.size());
 
-    lv2_wrapper->destroy_instance();
+    complex_output = fftwf_alloc_complex(power.size());
+
+    plan = fftwf_plan_dft_r2c_1d(static_cast<int>(fft_size), real_input.data(), complex_output, FFTW_ESTIMATE);
+
+    window_function = -1;
+
+    util::debug(std::format("{}spectrum fft size: {}", log_tag, fft_size));
   }
 
-  setup();
-}
+  if (window_type != window_function) {
+    window_function = window_type;
 
-void Spectrum::setup() {
-  if (rate == 0 || n_samples == 0) {
-    // Some signals may be emitted before PipeWire calls our setup function
-    return;
+    window.resize(fft_size);
+
+    double sum = 0.0;
+
+    for (size_t n = 0U; n < fft_size; n++) {
+      window[n] = window_value(window_function, n, fft_size);
+
+      sum += window[n];
+    }
+
+    /**
+     * The amplitude of the Hann window used to be compensated by 2 / fft_size. We keep the same calibration for it and
+     * correct the other windows by their coherent gain so that all of them show a sine at the same level.
+     */
+
+    window_scale = static_cast<float>(1.0 / sum);
   }
 
-  std::scoped_lock<std::mutex> lock(data_mutex);
+  reset_average();
+}
+
+void Spectrum::setup_display(const DisplayLayout& new_layout) {
+  layout = new_layout;
+
+  x_axis = layout.log_axis ? util::logspace(static_cast<float>(layout.min_freq), static_cast<float>(layout.max_freq),
+                                            static_cast<uint>(layout.n_points))
+                           : util::linspace(static_cast<float>(layout.min_freq), static_cast<float>(layout.max_freq),
+                                            static_cast<uint>(layout.n_points));
+
+  display_bins.resize(x_axis.size());
+
+  const double bin_hz = static_cast<double>(layout.rate) / static_cast<double>(layout.fft_size);
+
+  const auto last_bin = static_cast<uint>(power.size() - 1U);
+
+  // Band edges are placed halfway between neighbouring points, geometrically when the axis is logarithmic.
+
+  auto edge = [&](const size_t& a, const size_t& b) {
+    return layout.log_axis ? std::sqrt(static_cast<double>(x_axis[a]) * static_cast<double>(x_axis[b]))
+                           : 0.5 * (static_cast<double>(x_axis[a]) + static_cast<double>(x_axis[b]));
+  };
+
+  for (size_t n = 0U; n < x_axis.size(); n++) {
+    const double lower = (n == 0U) ? x_axis[n] : edge(n - 1U, n);
+    const double upper = (n == x_axis.size() - 1U) ? x_axis[n] : edge(n, n + 1U);
+
+    const auto first = static_cast<uint>(std::ceil(lower / bin_hz));
+    const auto last = static_cast<uint>(std::floor(upper / bin_hz));
+
+    if (first <= last && first <= last_bin) {
+      display_bins[n] = {.first = first, .last = std::min(last, last_bin), .fraction = 0.0F, .interpolate = false};
+    } else {
+      const double position = std::min(static_cast<double>(x_axis[n]) / bin_hz, static_cast<double>(last_bin));
+
+      const auto index = std::min(static_cast<uint>(position), last_bin - 1U);
 
-  std::ranges::fill(real_input, 0.0F);
-  std::ranges::fill(latest_samples_mono, 0.0F);
+      display_bins[n] = {.first = index,
+                         .last = index + 1U,
+                         .fraction = static_cast<float>(position - static_cast<double>(index)),
+                         .interpolate = true};
+    }
+  }
+}
 
-  left_delayed_vector.resize(n_samples, 0.0F);
-  right_delayed_vector.resize(n_samples, 0.0F);
+void Spectrum::analyze_frame(const uint64_t& end_position, const int& averaging, const float& coefficient) {
+  // Downmix and apply the window reading the frames straight from the ring of the bus.
 
-  left_delayed = std::span<float>(left_delayed_vector);
-  right_delayed = std::span<float>(right_delayed_vector);
+  const bool valid =
+      analysis_bus->visit(end_position, fft_size,
+                          [&](const float* left, const float* right, const size_t& count, const size_t& offset) {
+                            const float* w = window.data() + offset;
+                            float* out = real_input.data() + offset;
 
-  lv2_wrapper->set_n_samples(n_samples);
+                            for (size_t n = 0U; n < count; n++) {
+                              out[n] = 0.5F * (left[n] + right[n]) * w[n];
+                            }
+                          });
 
-  bin_hz = static_cast<float>(rate) / n_bands;
+  // Nothing was published for this position yet or the frames were overwritten while being read.
 
-  if (!lv2_wrapper->found_plugin) {
+  if (!valid) {
     return;
   }
 
-  ready = false;
+  fftwf_execute(plan);
 
-  // NOLINTBEGIN(clang-analyzer-cplusplus.NewDeleteLeaks)
-  QMetaObject::invokeMethod(
-      baseWorker,
-      [this] {
-        util::debug(std::format("{} creating instance of comp delay x2 stereo for spectrum A/V sync", log_tag));
+  for (size_t i = 0U; i < power.size(); i++) {
+    const float real = complex_output[i][0];
+    const float img = complex_output[i][1];
 
-        lv2_wrapper->create_instance(rate);
+    float mag = std::sqrt((real * real) + (img * img)) * window_scale;
 
-        std::scoped_lock<std::mutex> lock(data_mutex);
+    // Single-sided correction
+    if (i == 0U || i == fft_size / 2U) {
+      mag *= 0.5F;
+    }
 
-        ready = true;
-      },
-      Qt::QueuedConnection);
-  // NOLINTEND(clang-analyzer-cplusplus.NewDeleteLeaks)
-}
+    power[i] = mag * mag;
+  }
+
+  if (!has_average || averaging == none) {
+    std::ranges::copy(power, averaged_power.begin());
 
-void Spectrum::process(std::span<float>& left_in,
-                       std::span<float>& right_in,
-                       std::span<float>& left_out,
-                       std::span<float>& right_out) {
-  std::ranges::copy(left_in, left_out.begin());
-  std::ranges::copy(right_in, right_out.begin());
+    has_average = true;
 
-  if (bypass || !fftw_ready || !ready) {
     return;
   }
 
-  /**
-   * delay the visualization of the spectrum by the reported latency of the
-   * output device, so that the spectrum is visually in sync with the audio
-   * as experienced by the user. (A/V sync)
-   */
-  if (lv2_wrapper->found_plugin && lv2_wrapper->has_instance()) {
-    lv2_wrapper->connect_data_ports(left_in, right_in, left_delayed, right_delayed);
-    lv2_wrapper->run();
-
-    // Downmix the latest n_bands samples from the delayed signal.
-    if (n_samples < n_bands) {
-      // Drop the oldest quantum.
-      std::memmove(latest_samples_mono.data(), &latest_samples_mono[n_samples], (n_bands - n_samples) * sizeof(float));
-
-      // Copy the new quantum.
-      for (size_t n = 0; n < n_samples; n++) {
-        latest_samples_mono[n_bands - n_samples + n] = 0.5F * (left_delayed[n] + right_delayed[n]);
-      }
-    } else {
-      // Copy the latest n_bands samples.
-      for (size_t n = 0; n < n_bands; n++) {
-        latest_samples_mono[n] =
-            0.5F * (left_delayed[n_samples - n_bands + n] + right_delayed[n_samples - n_bands + n]);
-      }
+  if (averaging == peak_hold) {
+    for (size_t i = 0U; i < power.size(); i++) {
+      averaged_power[i] = std::max(power[i], averaged_power[i] * coefficient);
     }
   } else {
-    // Downmix the latest n_bands samples from the non-delayed signal.
-    if (n_samples < n_bands) {
-      // Drop the oldest quantum.
-      std::memmove(latest_samples_mono.data(), &latest_samples_mono[n_samples], (n_bands - n_samples) * sizeof(float));
-
-      // Copy the new quantum.
-      for (size_t n = 0; n < n_samples; n++) {
-        latest_samples_mono[n_bands - n_samples + n] = 0.5F * (left_in[n] + right_in[n]);
-      }
-    } else {
-      // Copy the latest n_bands samples.
-      for (size_t n = 0; n < n_bands; n++) {
-        latest_samples_mono[n] = 0.5F * (left_in[n_samples - n_bands + n] + right_in[n_samples - n_bands + n]);
-      }
+    for (size_t i = 0U; i < power.size(); i++) {
+      averaged_power[i] = (coefficient * averaged_power[i]) + ((1.0F - coefficient) * power[i]);
     }
   }
+}
+
+auto Spectrum::compute_magnitudes() -> QList<QPointF> {
+  std::scoped_lock<std::mutex> lock(data_mutex);
+
+  const auto rate = analysis_bus->get_rate();
+
+  if (bypass || rate == 0U) {
+    return {};
+  }
+
+  setup_fft(1024U << static_cast<uint>(settings->fftSize()), settings->windowFunction());
+
+  if (plan == nullptr || complex_output == nullptr) {
+    return {};
+  }
+
+  const DisplayLayout new_layout{.rate = rate,
+                                 .fft_size = fft_size,
+                                 .n_points = settings->nPoints(),
+                                 .min_freq = settings->minimumFrequency(),
+                                 .max_freq = settings->maximumFrequency(),
+                                 .log_axis = settings->logarithimicHorizontalAxis()};
+
+  if (new_layout.min_freq > (new_layout.max_freq - 100)) {
+    return {};
+  }
+
+  if (new_layout != layout) {
+    setup_display(new_layout);
+  }
 
   /**
-   * OK, we have the latest_samples_mono array that contains n_bands samples. We
-   * want to export it to the GUI thread. We don't wakeup the GUI thread from
-   * realtime, we only want to update the buffer and let the GUI thread follow
-   * its scheduling and have access to our new buffer. We accept losing old
-   * data.
-   *
-   * For that, we want to synchronise both threads. Realtime shouldn't have to
-   * wait (ie loop or syscall). It is fine if GUI waits a little.
-   *
-   * The overall concept is to use two buffers. When realtime comes in, it
-   * writes into one. When GUI arrives, it waits for realtime to be done
-   * writing (if it is busy) and it switches the active buffer to become the
-   * other one. As GUI is the one doing the toggle, it knows it can read at its
-   * pace the inactive buffer. Realtime will always have a buffer to write
-   * into, and it is fine if it overwrites data.
-   *
-   * We use an atomic integer (db_control) that contains three bits:
-   *  - DB_BIT_IDX: the current buffer index.
-   *  - DB_BIT_NEWDATA: indicates if realtime wrote new data.
-   *  - DB_BIT_BUSY: indicates if realtime is currently busy writing data.
-   *
-   * Realtime does this:
-   *  - Grab db_control and enable its BUSY bit.
-   *  - Write data into the correct buffer based on the IDX bit.
-   *  - Write db_control with same index as before, BUSY bit disabled and
-   *    NEWDATA bit enabled.
-   *
-   * GUI does this:
-   *  - Early return if NEWDATA is not enabled. It means realtime hasn't ran
-   *    since the last time GUI ran.
-   *  - Then it tries toggling the IDX bit. "Tries" because the operation fails
-   *    as long as the BUSY bit is active.
-   *  - From now on it can read the previous buffer knowing realtime cannot be
-   *    writing into it.
-   *
-   * This is single-producer single-consumer double-buffering. The
-   * implementation is inspired from the "Real-time 101" ADC19 talk
-   * (David Rowland & Fabian Renn-Giles).
-   *
-   * Talk part 1 & 2, slides (page 74 onwards) and illustrating library:
-   * https://www.youtube.com/watch?v=Q0vrQFyAdWI
-   * https://www.youtube.com/watch?v=PoZAo2Vikbo
-   * https://github.com/drowaudio/presentations/blob/master/ADC%202019%20-%20Real-time%20101/Real-time%20101.pdf
-   * https://github.com/hogliux/farbot
+   * Delay the visualization of the spectrum by the reported latency of the output device, so that the spectrum is
+   * visually in sync with the audio as experienced by the user (A/V sync). As the bus keeps the recent history of the
+   * pipeline output, this is done by reading older frames.
    */
 
-  // Grab the current index AND mark as busy at the same time.
-  int index = db_control.fetch_or(static_cast<int>(DB_BIT::BUSY)) & static_cast<int>(DB_BIT::IDX);
+  const auto delay_frames = static_cast<uint64_t>(static_cast<qint64>(settings->avsyncDelay()) * rate / 1000);
 
-  // Fill the buffer.
-  db_buffers[index] = latest_samples_mono;
+  const uint64_t write_position = analysis_bus->get_write_position();
 
-  // Mark new data available AND mark as not busy anymore.
-  db_control.store(index | static_cast<int>(DB_BIT::NEWDATA));
-}
+  if (write_position < delay_frames + fft_size) {
+    return {};
+  }
 
-auto Spectrum::compute_magnitudes() -> std::tuple<uint, float, QList<double>> {
-  std::scoped_lock<std::mutex> lock(data_mutex);
+  const uint64_t newest = write_position - delay_frames;
 
-  // Early return if no new data is available, ie if process() has not been
-  // called since our last compute_magnitudes() call.
-  int curr_control = db_control.load();
-  if (!fftw_ready || !(curr_control & static_cast<int>(DB_BIT::NEWDATA))) {
-    return {0, bin_hz, {}};
+  if (newest < last_frame_end) {
+    // The bus was invalidated or the delay was increased.
+    reset_average();
   }
 
-  // CAS loop to toggle the buffer used and remove NEWDATA flag, waiting for !BUSY.
-  int next_control = 0;
-  do {
-    curr_control &= ~static_cast<int>(DB_BIT::BUSY);
-    next_control = (curr_control ^ static_cast<int>(DB_BIT::IDX)) & static_cast<int>(DB_BIT::IDX);
-  } while (!db_control.compare_exchange_weak(curr_control, next_control));
+  const int averaging = settings->averaging();
 
-  // Buffer with data is at the index which was found inside db_control.
-  int index = curr_control & static_cast<int>(DB_BIT::IDX);
-  float* buf = db_buffers[index].data();
+  if (averaging == none) {
+    if (newest == last_frame_end) {
+      return {};
+    }
 
-  // https://en.wikipedia.org/wiki/Hann_function
-  for (size_t n = 0; n < n_bands; n++) {
-    real_input[n] = buf[n] * hann_window[n];
-  }
+    analyze_frame(newest, averaging, 0.0F);
 
-  fftwf_execute(plan);
+    last_frame_end = newest;
+  } else {
+    /**
+     * Frames are taken at fixed hops of the stream so that the averaging does not depend on how often the chart asks
+     * for data. The coefficient is the decay of the average during one hop.
+     */
+
+    const uint hop = fft_size >> static_cast<uint>(settings->overlap());
 
-  for (uint i = 0U; i < output.size(); i++) {
-    float real = complex_output[i][0];
-    float img = complex_output[i][1];
+    const float coefficient =
+        std::exp(-static_cast<float>(hop) / (static_cast<float>(rate) * 0.001F * settings->averagingTime()));
 
-    float mag = std::sqrt((real * real) + (img * img));
+    uint64_t frame_end = (last_frame_end == 0U) ? newest - (newest % hop) : last_frame_end + hop;
 
-    mag /= static_cast<float>(n_bands);
+    if (frame_end > newest) {
+      return {};
+    }
 
-    // Compensate Hann window
-    mag *= 2.0F;
+    const uint64_t n_pending = ((newest - frame_end) / hop) + 1U;
 
-    // Single-sided correction
-    if (i == 0 || i == n_bands / 2) {
-      mag *= 0.5F;
+    if (n_pending > max_frames_per_update) {
+      frame_end += (n_pending - max_frames_per_update) * hop;
     }
 
-    output[i] = static_cast<double>(util::linear_to_db(mag));
+    for (; frame_end <= newest; frame_end += hop) {
+      analyze_frame(frame_end, averaging, coefficient);
+
+      last_frame_end = frame_end;
+    }
   }
 
-  return {rate, bin_hz, output};
-}
+  if (!has_average) {
+    return {};
+  }
+
+  QList<QPointF> output(static_cast<qsizetype>(x_axis.size()));
+
+  for (size_t n = 0U; n < x_axis.size(); n++) {
+    const auto& bin = display_bins[n];
 
-void Spectrum::process([[maybe_unused]] std::span<float>& left_in,
-                       [[maybe_unused]] std::span<float>& right_in,
-                       [[maybe_unused]] std::span<float>& left_out,
-                       [[maybe_unused]] std::span<float>& right_out,
-                       [[maybe_unused]] std::span<float>& probe_left,
-                       [[maybe_unused]] std::span<float>& probe_right) {}
+    float db = 0.0F;
+
+    if (bin.interpolate) {
+      const float db_a = util::linear_to_db(std::sqrt(averaged_power[bin.first]));
+      const float db_b = util::linear_to_db(std::sqrt(averaged_power[bin.last]));
+
+      db = db_a + (bin.fraction * (db_b - db_a));
+    } else {
+      db = util::linear_to_db(
+          std::sqrt(*std::max_element(averaged_power.begin() + bin.first, averaged_power.begin() + bin.last + 1U)));
+    }
+
+    output[static_cast<qsizetype>(n)] = QPointF(x_axis[n], db);
+  }
 
-auto Spectrum::get_latency_seconds() -> float {
-  return 0.0F;
+  return output;
 }
@@ -21,85 +21,104 @@
 
 #include <fftw3.h>
 #include <qlist.h>
+#include <qobject.h>
+#include <qpoint.h>
 #include <sys/types.h>
-#include <QString>
-#include <array>
-#include <atomic>
-#include <span>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
-#include <tuple>
 #include <vector>
+#include "analysis_bus.hpp"
 #include "easyeffects_db_spectrum.h"
-#include "pipeline_type.hpp"
-#include "plugin_base.hpp"
-#include "pw_manager.hpp"
 
-class Spectrum : public PluginBase {
+/**
+ * The spectrum is not a PipeWire filter. It is an analyzer attached to the analysis bus of its pipeline and all of
+ * its work is done in compute_magnitudes, outside of the realtime thread.
+ */
+class Spectrum : public QObject {
  public:
-  Spectrum(const std::string& tag, pw::Manager* pipe_manager, PipelineType pipe_type, QString instance_id);
+  Spectrum(std::string tag, std::shared_ptr<AnalysisBus> analysis_bus);
   Spectrum(const Spectrum&) = delete;
   auto operator=(const Spectrum&) -> Spectrum& = delete;
   Spectrum(const Spectrum&&) = delete;
   auto operator=(const Spectrum&&) -> Spectrum& = delete;
   ~Spectrum() override;
 
-  void reset() override;
+  const std::string log_tag;
 
-  void clear_data() override;
+  void set_bypass(const bool& state);
 
-  void setup() override;
+  /**
+   * Analyzes the frames published since the last call and returns the spectrum already mapped to the points of the
+   * chart. The list is empty when there is nothing new to show.
+   */
+  auto compute_magnitudes() -> QList<QPointF>;
 
-  void process(std::span<float>& left_in,
-               std::span<float>& right_in,
-               std::span<float>& left_out,
-               std::span<float>& right_out) override;
-
-  void process(std::span<float>& left_in,
-               std::span<float>& right_in,
-               std::span<float>& left_out,
-               std::span<float>& right_out,
-               std::span<float>& probe_left,
-               std::span<float>& probe_right) override;
+ private:
+  DbSpectrum* settings = nullptr;
 
-  auto get_latency_seconds() -> float override;
+  std::shared_ptr<AnalysisBus> analysis_bus;
 
-  auto compute_magnitudes() -> std::tuple<uint, float, QList<double>>;  // rate, magnitudes
+  std::mutex data_mutex;
 
- private:
-  DbSpectrum* settings = nullptr;
+  bool bypass = true;
 
-  std::atomic<bool> fftw_ready = false;
+  // Limits the work done after the analyzer was not polled for a while.
+  static constexpr uint max_frames_per_update = 32U;
 
   fftwf_plan plan = nullptr;
 
   fftwf_complex* complex_output = nullptr;
 
-  static constexpr uint n_bands = 8192U;
+  uint fft_size = 0U;
 
-  bool ready = false;
+  int window_function = -1;
 
-  float bin_hz = 0.0F;
+  // Amplitude correction of the window (inverse of its coherent gain).
+  float window_scale = 0.0F;
 
-  std::array<float, n_bands> real_input;
+  std::vector<float> real_input, window;
 
-  QList<double> output = QList<double>(((n_bands / 2U) + 1U));
+  std::vector<float> power, averaged_power;
 
-  std::vector<float> left_delayed_vector;
-  std::vector<float> right_delayed_vector;
-  std::span<float> left_delayed;
-  std::span<float> right_delayed;
+  bool has_average = false;
 
-  std::array<float, n_bands> latest_samples_mono;
+  uint64_t last_frame_end = 0U;
 
-  std::array<float, n_bands> hann_window;
+  /**
+   * Each point of the chart takes the highest power of the FFT bins inside its frequency band. When the band is
+   * narrower than a bin the value is interpolated between the two bins closest to the point frequency.
+   */
+  struct DisplayBin {
+    uint first;
+    uint last;
+    float fraction;
+    bool interpolate;
+  };
 
-  enum class DB_BIT {
-    IDX = (1 << 0),      // To which db_buffers array process() should write.
-    NEWDATA = (1 << 1),  // If new data has been written by process().
-    BUSY = (1 << 2),     // If process() is currently writing data.
+  struct DisplayLayout {
+    uint rate = 0U;
+    uint fft_size = 0U;
+    int n_points = 0;
+    int min_freq = 0;
+    int max_freq = 0;
+    bool log_axis = false;
+
+    auto operator==(const DisplayLayout&) const -> bool = default;
   };
 
-  std::array<std::array<float, n_bands>, 2> db_buffers;
-  std::atomic<int> db_control = {0};
-  static_assert(std::atomic<int>::is_always_lock_free);
+  DisplayLayout layout;
+
+  std::vector<float> x_axis;
+
+  std::vector<DisplayBin> display_bins;
+
+  void setup_fft(const uint& size, const int& window_type);
+
+  void setup_display(const DisplayLayout& new_layout);
+
+  void analyze_frame(const uint64_t& end_position, const int& averaging, const float& coefficient);
+
+  void reset_average();
 };
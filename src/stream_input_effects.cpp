@@ -35,6 +35,7 @@
 #include <string>
 #include <thread>
 #include <vector>
+#include "channel_layout.hpp"
 #include "config.h"
 #include "db_manager.hpp"
 #include "effects_base.hpp"
@@ -93,6 +94,12 @@ StreamInputEffects::StreamInputEffects(pw::Manager* pipe_manager) : EffectsBase(
   connect(
       DbStreamInputs::self(), &DbStreamInputs::pluginsChanged, this,
       [&]() {
+        if (take_adopted_chain()) {
+          Q_EMIT pipelineChanged();
+
+          return;  // the preset chain was switched to while it was already linked
+        }
+
         if (DbMain::bypass()) {
           DbMain::setBypass(false);
 
@@ -105,6 +112,11 @@ StreamInputEffects::StreamInputEffects(pw::Manager* pipe_manager) : EffectsBase(
       },
       Qt::QueuedConnection);
 
+  connect(this, &EffectsBase::pluginBypassChanged, this, &StreamInputEffects::relink_filters);
+
+  connect(DbMain::self(), &DbMain::spliceBypassedPluginsChanged, this, &StreamInputEffects::relink_filters,
+          Qt::QueuedConnection);
+
   connect(pm, &pw::Manager::linkChanged, this, &StreamInputEffects::on_link_changed, Qt::QueuedConnection);
 
   connect(pm, &pw::Manager::linkRemoved, this, &StreamInputEffects::on_link_removed, Qt::QueuedConnection);
@@ -225,7 +237,7 @@ void StreamInputEffects::connect_filters(const bool& bypass) {
     return;
   }
 
-  const auto list = bypass ? QStringList() : DbStreamInputs::plugins();
+  const auto list = bypass ? QStringList() : get_linked_plugins(DbStreamInputs::plugins());
 
   auto mic_linked = false;
 
@@ -270,7 +282,7 @@ void StreamInputEffects::connect_filters(const bool& bypass) {
           list_proxies.push_back(link);
         }
 
-        if (mic_linked && (links.size() == 2U)) {
+        if (mic_linked && (links.size() == channel_layout::n_channels())) {
           prev_node_id = next_node_id;
         } else if (!mic_linked && (!links.empty())) {
           prev_node_id = next_node_id;
@@ -302,9 +314,9 @@ void StreamInputEffects::connect_filters(const bool& bypass) {
     }
   }
 
-  // link spectrum, output level meter and source node
+  // link the output level meter and source node. The spectrum reads the level meter output through the analysis bus.
 
-  for (const auto node_id : {spectrum->get_node_id(), output_level->get_node_id(), pm->ee_source_node.id}) {
+  for (const auto node_id : {output_level->get_node_id(), pm->ee_source_node.id}) {
     next_node_id = node_id;
 
     const auto links = pm->link_nodes(prev_node_id, next_node_id);
@@ -313,7 +325,7 @@ void StreamInputEffects::connect_filters(const bool& bypass) {
       list_proxies.push_back(link);
     }
 
-    if (mic_linked && (links.size() == 2U)) {
+    if (mic_linked && (links.size() == channel_layout::n_channels())) {
       prev_node_id = next_node_id;
     } else if (!mic_linked && (!links.empty())) {
       prev_node_id = next_node_id;
@@ -336,6 +348,8 @@ void StreamInputEffects::connect_filters(const bool& bypass) {
 }
 
 void StreamInputEffects::disconnect_filters() {
+  cancel_chain_switch();
+
   std::set<uint> link_id_list;
 
   const auto selected_plugins_list = (bypass) ? QStringList() : DbStreamInputs::plugins();
@@ -363,8 +377,7 @@ void StreamInputEffects::disconnect_filters() {
   }
 
   for (const auto& link : pm->get_links()) {
-    if (link.input_node_id == spectrum->get_node_id() || link.output_node_id == spectrum->get_node_id() ||
-        link.input_node_id == output_level->get_node_id() || link.output_node_id == output_level->get_node_id()) {
+    if (link.input_node_id == output_level->get_node_id() || link.output_node_id == output_level->get_node_id()) {
       link_id_list.insert(link.id);
     }
   }
@@ -386,6 +399,24 @@ void StreamInputEffects::disconnect_filters() {
   Q_EMIT filtersLinkedChanged();
 }
 
+void StreamInputEffects::relink_filters() {
+  // Nothing to do while the whole pipeline is bypassed or our filters are unlinked because of inactivity.
+
+  if (bypass || list_proxies.empty()) {
+    return;
+  }
+
+  disconnect_filters();
+
+  connect_filters();
+}
+
+auto StreamInputEffects::chain_source_node_id() -> uint {
+  auto input_device = pm->model_nodes.get_node_by_name(DbStreamInputs::inputDevice());
+
+  return input_device.serial != SPA_ID_INVALID ? input_device.id : SPA_ID_INVALID;
+}
+
 void StreamInputEffects::set_bypass(const bool& state) {
   bypass = state;
 
@@ -37,6 +37,9 @@ class StreamInputEffects : public EffectsBase {
 
   void set_listen_to_mic(const bool& state);
 
+ protected:
+  auto chain_source_node_id() -> uint override;
+
  private:
   bool bypass = false;
 
@@ -44,6 +47,8 @@ class StreamInputEffects : public EffectsBase {
 
   void disconnect_filters();
 
+  void relink_filters();
+
   auto apps_want_to_play() -> bool;
 
   void on_link_changed(pw::LinkInfo link_info);
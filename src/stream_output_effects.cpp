@@ -36,6 +36,7 @@
 #include <string>
 #include <thread>
 #include <vector>
+#include "channel_layout.hpp"
 #include "config.h"
 #include "db_manager.hpp"
 #include "effects_base.hpp"
@@ -103,6 +104,12 @@ StreamOutputEffects::StreamOutputEffects(pw::Manager* pipe_manager) : EffectsBas
   connect(
       DbStreamOutputs::self(), &DbStreamOutputs::pluginsChanged, this,
       [&]() {
+        if (take_adopted_chain()) {
+          Q_EMIT pipelineChanged();
+
+          return;  // the preset chain was switched to while it was already linked
+        }
+
         if (DbMain::bypass()) {
           DbMain::setBypass(false);
 
@@ -119,6 +126,11 @@ StreamOutputEffects::StreamOutputEffects(pw::Manager* pipe_manager) : EffectsBas
       DbStreamOutputs::self(), &DbStreamOutputs::linkToVirtualSourceChanged, this, [&]() { set_bypass(false); },
       Qt::QueuedConnection);
 
+  connect(this, &EffectsBase::pluginBypassChanged, this, &StreamOutputEffects::relink_filters);
+
+  connect(DbMain::self(), &DbMain::spliceBypassedPluginsChanged, this, &StreamOutputEffects::relink_filters,
+          Qt::QueuedConnection);
+
   connect(pm, &pw::Manager::linkChanged, this, &StreamOutputEffects::on_link_changed, Qt::QueuedConnection);
 
   connect(pm, &pw::Manager::linkRemoved, this, &StreamOutputEffects::on_link_removed, Qt::QueuedConnection);
@@ -216,17 +228,20 @@ void StreamOutputEffects::connect_filters(const bool& bypass) {
   /**
    * In the past we were connecting the filters from EE sink to the output
    * device:
-   * - ee_sink -> plugins -> spectrum -> level meter -> speakers
+   * - ee_sink -> plugins -> level meter -> speakers
    *
    * This went good until we started to see more crackling and null pointers
    * provided by Pipewire.
    *
    * Then we started making the connection in the reverse way (preserving the
    * direction from ee_sink to output device):
-   * - speakers <- level meter <- spectrum <- plugins <- ee_sink
+   * - speakers <- level meter <- plugins <- ee_sink
    *
    * And we got less crackling and null pointers from Pipewire. Don't know why,
    * but we'll keep this process until it works...
+   *
+   * The spectrum is not a node in the graph. It reads what the level meter
+   * outputs through the analysis bus.
    */
 
   // Checking if the output device exists.
@@ -281,26 +296,16 @@ void StreamOutputEffects::connect_filters(const bool& bypass) {
         std::format("Link from global level meter {} to output device {} failed", prev_node_id, next_node_id));
   }
 
-  // Link spectrum to global level meter.
-
-  next_node_id = prev_node_id;
-  prev_node_id = spectrum->get_node_id();
-
-  links = pm->link_nodes(prev_node_id, next_node_id);
-
-  for (auto* link : links) {
-    list_proxies.push_back(link);
-  }
+  // The channels of the layout the device does not have are left unlinked. The global level meter folds them into FL
+  // and FR.
 
-  if (links.size() < 2U) {
-    util::warning(std::format("Link from spectrum {} to global level meter {} failed", prev_node_id, next_node_id));
-  }
+  output_level->set_linked_channels(pm->link_manager.linked_output_channels(prev_node_id, next_node_id));
 
   // Link plugins in reverse order.
 
   next_node_id = prev_node_id;
 
-  const auto list = bypass ? QStringList() : DbStreamOutputs::plugins();
+  const auto list = bypass ? QStringList() : get_linked_plugins(DbStreamOutputs::plugins());
 
   if (!list.empty()) {
     for (const auto& name : std::ranges::reverse_view(list)) {
@@ -317,7 +322,7 @@ void StreamOutputEffects::connect_filters(const bool& bypass) {
           list_proxies.push_back(link);
         }
 
-        if (links.size() == 2U) {
+        if (links.size() == channel_layout::n_channels()) {
           next_node_id = prev_node_id;
         } else {
           util::warning(std::format("Link from node {} to node {} failed", prev_node_id, next_node_id));
@@ -382,6 +387,8 @@ void StreamOutputEffects::connect_filters(const bool& bypass) {
 }
 
 void StreamOutputEffects::disconnect_filters() {
+  cancel_chain_switch();
+
   std::set<uint> link_id_list;
 
   const auto selected_plugins_list = (bypass) ? QStringList() : DbStreamOutputs::plugins();
@@ -409,8 +416,7 @@ void StreamOutputEffects::disconnect_filters() {
   }
 
   for (const auto& link : pm->get_links()) {
-    if (link.input_node_id == spectrum->get_node_id() || link.output_node_id == spectrum->get_node_id() ||
-        link.input_node_id == output_level->get_node_id() || link.output_node_id == output_level->get_node_id()) {
+    if (link.input_node_id == output_level->get_node_id() || link.output_node_id == output_level->get_node_id()) {
       link_id_list.insert(link.id);
     }
   }
@@ -430,6 +436,22 @@ void StreamOutputEffects::disconnect_filters() {
   Q_EMIT filtersLinkedChanged();
 }
 
+void StreamOutputEffects::relink_filters() {
+  // Nothing to do while the whole pipeline is bypassed or our filters are unlinked because of inactivity.
+
+  if (bypass || list_proxies.empty()) {
+    return;
+  }
+
+  disconnect_filters();
+
+  connect_filters();
+}
+
+auto StreamOutputEffects::chain_source_node_id() -> uint {
+  return pm->ee_sink_node.id;
+}
+
 void StreamOutputEffects::set_bypass(const bool& state) {
   bypass = state;
 
@@ -35,6 +35,9 @@ class StreamOutputEffects : public EffectsBase {
 
   void set_bypass(const bool& state);
 
+ protected:
+  auto chain_source_node_id() -> uint override;
+
  private:
   bool bypass = false;
 
@@ -42,6 +45,8 @@ class StreamOutputEffects : public EffectsBase {
 
   void disconnect_filters();
 
+  void relink_filters();
+
   auto apps_want_to_play() -> bool;
 
   void on_link_changed(pw::LinkInfo link_info);
@@ -23,10 +23,18 @@ namespace tags::local_server {
 
 inline constexpr auto server_name = "EasyEffectsServer";
 
+inline constexpr auto protocol_version = 2;
+
 inline constexpr auto quit_app = "quit_app\n";
 
 inline constexpr auto show_window = "show_window\n";
 
+inline constexpr auto show_window_v2 = R"({"op":"show_window"})" "\n";
+
+inline constexpr auto no_window_error =
+    "running in daemon mode, there is no window to show. Quit it with 'easyeffects -q' and start easyeffects without "
+    "--daemon to use the interface";
+
 inline constexpr auto hide_window = "hide_window\n";
 
 inline constexpr auto load_preset = "load_preset";
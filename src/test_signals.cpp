@@ -28,6 +28,8 @@
 #include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <format>
 #include <numbers>
 #include <span>
@@ -39,7 +41,7 @@
 
 namespace {
 
-constexpr auto pi_x_2 = 2.0F * std::numbers::pi_v<float>;
+constexpr auto pi_x_2 = 2.0 * std::numbers::pi;
 
 void on_process(void* userdata, spa_io_position* position) {
   auto* d = static_cast<TestSignals::data*>(userdata);
@@ -55,7 +57,8 @@ void on_process(void* userdata, spa_io_position* position) {
     d->ts->rate = rate;
     d->ts->n_samples = n_samples;
 
-    d->ts->sine_phase = 0.0F;
+    d->ts->sine_re = 1.0;
+    d->ts->sine_im = 0.0;
   }
 
   // util::warning("Processing: " + util::to_string(n_samples));
@@ -70,47 +73,35 @@ void on_process(void* userdata, spa_io_position* position) {
   std::span left_out(out_left, n_samples);
   std::span right_out(out_right, n_samples);
 
-  const auto phase_delta = pi_x_2 * d->ts->sine_frequency / static_cast<float>(rate);
+  // A measurement stimulus replaces the configured signal on both channels.
 
-  for (uint n = 0U; n < n_samples; n++) {
-    float signal = 0.0F;
-    left_out[n] = 0.0F;
-    right_out[n] = 0.0F;
+  if (d->ts->stimulus_armed.load(std::memory_order_acquire)) {
+    d->ts->write_stimulus(left_out, right_out, position->clock.position);
 
-    switch (d->ts->signal_type) {
-      case TestSignalType::sine_wave: {
-        d->ts->sine_phase += phase_delta;
+    return;
+  }
 
-        if (d->ts->sine_phase >= pi_x_2) {
-          d->ts->sine_phase -= pi_x_2;
-        }
+  /**
+   * The signal is generated once per cycle in the buffer of the first enabled
+   * channel and copied to the other one.
+   */
 
-        signal = 0.5F * std::sin(d->ts->sine_phase);
+  if (!d->ts->create_left_channel && !d->ts->create_right_channel) {
+    std::ranges::fill(left_out, 0.0F);
+    std::ranges::fill(right_out, 0.0F);
 
-        break;
-      }
-      case TestSignalType::gaussian: {
-        signal = d->ts->white_noise();
+    return;
+  }
 
-        break;
-      }
-      case TestSignalType::pink: {
-        signal = d->ts->pink_noise();
+  auto& block = d->ts->create_left_channel ? left_out : right_out;
+  auto& other = d->ts->create_left_channel ? right_out : left_out;
 
-        break;
-      }
-      case TestSignalType::silence: {
-        break;
-      }
-    }
-
-    if (d->ts->create_left_channel) {
-      left_out[n] = signal;
-    }
+  d->ts->generate(block);
 
-    if (d->ts->create_right_channel) {
-      right_out[n] = signal;
-    }
+  if (d->ts->create_left_channel && d->ts->create_right_channel) {
+    std::ranges::copy(block, other.begin());
+  } else {
+    std::ranges::fill(other, 0.0F);
   }
 }
 
@@ -260,10 +251,15 @@ TestSignals::~TestSignals() {
 }
 
 void TestSignals::set_state(const bool& state) {
-  sine_phase = 0.0F;
+  sine_re = 1.0;
+  sine_im = 0.0;
   pink_b0 = pink_b1 = pink_b2 = 0.0F;
 
   if (state) {
+    if (!list_proxies.empty()) {
+      return;  // already linked
+    }
+
     for (const auto& link : pm->link_nodes(node_id, pm->ee_sink_node.id, false)) {
       list_proxies.push_back(link);
     }
@@ -277,7 +273,97 @@ void TestSignals::set_state(const bool& state) {
 void TestSignals::set_frequency(const float& value) {
   sine_frequency = value;
 
-  sine_phase = 0.0F;
+  sine_re = 1.0;
+  sine_im = 0.0;
+}
+
+void TestSignals::generate(std::span<float> block) {
+  switch (signal_type) {
+    case TestSignalType::sine_wave: {
+      // The phasor is rotated by the phase step of one sample, so sin and cos are evaluated once per block.
+
+      const auto phase_delta = pi_x_2 * sine_frequency / static_cast<double>(rate);
+
+      const auto step_re = std::cos(phase_delta);
+      const auto step_im = std::sin(phase_delta);
+
+      auto re = sine_re;
+      auto im = sine_im;
+
+      for (auto& v : block) {
+        const auto next_re = (re * step_re) - (im * step_im);
+
+        im = (re * step_im) + (im * step_re);
+        re = next_re;
+
+        v = 0.5F * static_cast<float>(im);
+      }
+
+      // Rounding errors make the magnitude drift a little on every rotation.
+
+      const auto magnitude = std::hypot(re, im);
+
+      sine_re = re / magnitude;
+      sine_im = im / magnitude;
+
+      break;
+    }
+    case TestSignalType::gaussian: {
+      std::ranges::generate(block, [this]() { return white_noise(); });
+
+      break;
+    }
+    case TestSignalType::pink: {
+      std::ranges::generate(block, [this]() { return pink_noise(); });
+
+      break;
+    }
+    case TestSignalType::silence: {
+      std::ranges::fill(block, 0.0F);
+
+      break;
+    }
+  }
+}
+
+void TestSignals::play_stimulus(std::span<const float> samples) {
+  stimulus_armed.store(false, std::memory_order_release);
+
+  stimulus = samples;
+  stimulus_index = 0U;
+
+  stimulus_started.store(false, std::memory_order_relaxed);
+  stimulus_finished.store(false, std::memory_order_relaxed);
+
+  stimulus_armed.store(true, std::memory_order_release);
+}
+
+void TestSignals::stop_stimulus() {
+  stimulus_armed.store(false, std::memory_order_release);
+}
+
+void TestSignals::write_stimulus(std::span<float> left_out,
+                                 std::span<float> right_out,
+                                 const uint64_t& clock_position) {
+  if (!stimulus_started.load(std::memory_order_relaxed)) {
+    stimulus_start_position.store(clock_position, std::memory_order_relaxed);
+
+    stimulus_started.store(true, std::memory_order_release);
+  }
+
+  const auto count = std::min(left_out.size(), stimulus.size() - stimulus_index);
+
+  std::copy_n(stimulus.begin() + static_cast<std::ptrdiff_t>(stimulus_index), count, left_out.begin());
+
+  std::fill(left_out.begin() + static_cast<std::ptrdiff_t>(count), left_out.end(), 0.0F);
+
+  std::ranges::copy(left_out, right_out.begin());
+
+  stimulus_index += count;
+
+  if (stimulus_index == stimulus.size()) {
+    stimulus_finished.store(true, std::memory_order_release);
+  }
 }
 
 auto TestSignals::white_noise() -> float {
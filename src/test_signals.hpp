@@ -26,7 +26,11 @@
 #include <qtmetamacros.h>
 #include <spa/utils/hook.h>
 #include <sys/types.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <random>
+#include <span>
 #include <vector>
 #include "pw_manager.hpp"
 
@@ -75,7 +79,9 @@ class TestSignals : public QObject {
 
   bool can_get_node_id = false;
 
-  float sine_phase = 0.0F;
+  // Unit phasor of the sine generator. The output is its imaginary part.
+  double sine_re = 1.0;
+  double sine_im = 0.0;
 
   float sine_frequency = 1000.0F;
 
@@ -97,6 +103,30 @@ class TestSignals : public QObject {
 
   auto pink_noise() -> float;
 
+  // Fills the block with the configured signal. Realtime thread only.
+  void generate(std::span<float> block);
+
+  /**
+   * Plays the samples once on both channels, replacing the configured signal,
+   * and then silence until stop_stimulus(). They must stay alive until then.
+   * The graph clock position of the first sample is published in
+   * stimulus_start_position.
+   */
+  void play_stimulus(std::span<const float> samples);
+
+  void stop_stimulus();
+
+  // Realtime thread only.
+  void write_stimulus(std::span<float> left_out,
+                      std::span<float> right_out,
+                      const uint64_t& clock_position);
+
+  std::atomic<bool> stimulus_armed = {false};
+  std::atomic<bool> stimulus_started = {false};
+  std::atomic<bool> stimulus_finished = {false};
+
+  std::atomic<uint64_t> stimulus_start_position = {0U};
+
  private:
   pw::Manager* pm = nullptr;
 
@@ -114,5 +144,9 @@ class TestSignals : public QObject {
 
   std::normal_distribution<float> normal_distribution{0.0F, 0.3F};
 
+  std::span<const float> stimulus;
+
+  size_t stimulus_index = 0U;  // realtime thread while armed
+
   void set_channel(const int& value);
 };
@@ -0,0 +1,70 @@
+/**
+ * Copyright © 2017-2026 Wellington Wallace
+ *
+ * This file is part of Easy Effects.
+ *
+ * Easy Effects is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Easy Effects is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <sys/types.h>
+#include <array>
+#include <atomic>
+
+/**
+ * Wait-free single producer, single consumer exchange of the latest value of T. Each side owns one of the three
+ * slots and the third one is swapped between them, so neither the writer nor the reader ever waits for the other
+ * and a value is never read while it is being written.
+ *
+ * Used to hand meter values from the realtime thread to the GUI, which only cares about the most recent ones. The
+ * plugins call read() in refreshMeters(), which the GUI thread runs before the const meter getters use latest().
+ */
+template <typename T>
+class TripleBuffer {
+ public:
+  // Writer thread only.
+  void write(const T& value) {
+    slots[back] = value;
+
+    back = middle.exchange(back | fresh_bit, std::memory_order_acq_rel) & index_mask;
+  }
+
+  // Reader thread only. Swaps in the last published value, if any, and returns it.
+  auto read() -> const T& {
+    if ((middle.load(std::memory_order_relaxed) & fresh_bit) != 0U) {
+      front = middle.exchange(front, std::memory_order_acq_rel) & index_mask;
+    }
+
+    return slots[front];
+  }
+
+  // Reader thread only. Returns the value taken by the last read() without looking for a newer one, so several
+  // fields can be fetched one call at a time and still belong to the same snapshot.
+  [[nodiscard]] auto latest() const -> const T& { return slots[front]; }
+
+ private:
+  static constexpr uint fresh_bit = 4U;
+  static constexpr uint index_mask = 3U;
+
+  std::array<T, 3> slots{};
+
+  uint back = 0U;  // Writer thread only
+
+  std::atomic<uint> middle = 1U;
+
+  uint front = 2U;  // Reader thread only
+
+  static_assert(std::atomic<uint>::is_always_lock_free);
+};
@@ -351,6 +351,10 @@ auto VoiceSuppressor::get_latency_seconds() -> float {
   return 0.0F;
 }
 
+auto VoiceSuppressor::is_primed() -> bool {
+  return rate != 0U && ready;
+}
+
 void VoiceSuppressor::free_fftw() {
   if (realL != nullptr) {
     fftw_free(realL);
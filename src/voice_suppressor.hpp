@@ -65,6 +65,8 @@ class VoiceSuppressor : public PluginBase {
 
   auto get_latency_seconds() -> float override;
 
+  auto is_primed() -> bool override;
+
  private:
   DbVoiceSuppressor* settings = nullptr;
 
@@ -0,0 +1,167 @@
+/**
+ * Copyright © 2017-2026 Wellington Wallace
+ *
+ * This file is part of Easy Effects.
+ *
+ * Easy Effects is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Easy Effects is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "worker_pool.hpp"
+#include <qcoreapplication.h>
+#include <qcoreevent.h>
+#include <qnamespace.h>
+#include <qobject.h>
+#include <qthread.h>
+#include <sys/types.h>
+#include <QString>
+#include <algorithm>
+#include <cstddef>
+#include <format>
+#include <mutex>
+#include <thread>
+#include "util.hpp"
+
+auto PoolWorker::event(QEvent* event) -> bool {
+  // The deferred deletion destroys the mutex, so it cannot run under it.
+
+  if (event->type() != QEvent::MetaCall) {
+    return QObject::event(event);
+  }
+
+  std::scoped_lock<std::mutex> lock(running);
+
+  if (released) {
+    return true;
+  }
+
+  return QObject::event(event);
+}
+
+WorkerPool::WorkerPool() {
+  // Workers mostly create plugin instances, load impulse responses and update native windows. A few threads are enough.
+
+  const uint n_threads = std::clamp(std::thread::hardware_concurrency() / 2U, 2U, 4U);
+
+  for (uint n = 0U; n < n_threads; n++) {
+    auto* thread = new QThread();
+
+    thread->setObjectName(QString::fromStdString(std::format("ee-worker-{}", n)));
+
+    thread->start();
+
+    lanes.push_back({.thread = thread});
+  }
+
+  util::debug(std::format("worker pool started with {} threads", n_threads));
+}
+
+WorkerPool::~WorkerPool() {
+  for (auto& lane : lanes) {
+    lane.thread->quit();
+    lane.thread->wait();
+
+    delete lane.thread;
+  }
+}
+
+auto WorkerPool::lane_index(const QThread* thread) -> int {
+  for (size_t n = 0U; n < lanes.size(); n++) {
+    if (lanes[n].thread == thread) {
+      return static_cast<int>(n);
+    }
+  }
+
+  return -1;
+}
+
+void WorkerPool::attach(PoolWorker* worker, const QObject* strand) {
+  std::scoped_lock<std::mutex> lock(mutex);
+
+  int idx = (strand != nullptr) ? lane_index(strand->thread()) : -1;
+
+  if (idx < 0) {
+    for (size_t n = 0U; n < lanes.size(); n++) {
+      if (!lanes[n].dedicated && (idx < 0 || lanes[n].n_workers < lanes[idx].n_workers)) {
+        idx = static_cast<int>(n);
+      }
+    }
+  }
+
+  lanes[idx].n_workers++;
+
+  worker->moveToThread(lanes[idx].thread);
+}
+
+void WorkerPool::attach_dedicated(PoolWorker* worker) {
+  auto* thread = new QThread();
+
+  thread->setObjectName(QStringLiteral("ee-worker-dedicated"));
+
+  thread->start(QThread::LowPriority);
+
+  std::scoped_lock<std::mutex> lock(mutex);
+
+  lanes.push_back({.thread = thread, .n_workers = 1U, .dedicated = true});
+
+  worker->moveToThread(thread);
+}
+
+void WorkerPool::release(PoolWorker* worker) {
+  if (worker == nullptr) {
+    return;
+  }
+
+  QThread* stop_thread = nullptr;
+
+  {
+    std::scoped_lock<std::mutex> lock(mutex);
+
+    if (const auto idx = lane_index(worker->thread()); idx >= 0) {
+      auto& lane = lanes[idx];
+
+      lane.n_workers--;
+
+      if (lane.dedicated && lane.n_workers == 0U) {
+        stop_thread = lane.thread;
+
+        lanes.erase(lanes.begin() + idx);
+      }
+    } else {
+      delete worker;
+
+      return;
+    }
+  }
+
+  /**
+   * The tasks still queued are dropped and the worker ignores any that arrive later. Taking the lock waits for the
+   * task it may be running, and only for it. The tasks of other workers in the same thread are not waited for.
+   */
+
+  QCoreApplication::removePostedEvents(worker, QEvent::MetaCall);
+
+  {
+    std::scoped_lock<std::mutex> lock(worker->running);
+
+    worker->released = true;
+  }
+
+  if (stop_thread != nullptr) {
+    QObject::connect(worker, &QObject::destroyed, stop_thread, &QThread::quit, Qt::DirectConnection);
+
+    QObject::connect(stop_thread, &QThread::finished, stop_thread, &QObject::deleteLater);
+  }
+
+  worker->deleteLater();
+}
@@ -0,0 +1,96 @@
+/**
+ * Copyright © 2017-2026 Wellington Wallace
+ *
+ * This file is part of Easy Effects.
+ *
+ * Easy Effects is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Easy Effects is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <qcoreevent.h>
+#include <qobject.h>
+#include <qthread.h>
+#include <sys/types.h>
+#include <mutex>
+#include <vector>
+
+/**
+ * Base of the objects attached to the pool. Keeps track of the task it is running so that release() can wait for
+ * that one task alone and drop the rest.
+ */
+class PoolWorker : public QObject {
+ public:
+  auto event(QEvent* event) -> bool override;
+
+ private:
+  friend class WorkerPool;
+
+  std::mutex running;  // Held while one of the tasks of this worker runs
+
+  bool released = false;
+};
+
+/**
+ * Small set of threads shared by the workers of all plugins and pipelines. Before it every plugin started its own
+ * QThread, which was idle most of the time.
+ *
+ * A worker is a PoolWorker that lives in one of the pool threads. Everything queued to it with
+ * QMetaObject::invokeMethod still runs one task at a time and in the order it was queued, so each worker behaves
+ * like a strand. Objects attached to the same thread as a worker keep their ordering relative to it.
+ *
+ * Workers whose tasks block for long, like loading a model or an impulse response, are attached to a thread of their
+ * own so that they do not hold back the workers of other plugins.
+ */
+class WorkerPool {
+ public:
+  WorkerPool();
+  WorkerPool(const WorkerPool&) = delete;
+  auto operator=(const WorkerPool&) -> WorkerPool& = delete;
+  WorkerPool(const WorkerPool&&) = delete;
+  auto operator=(const WorkerPool&&) -> WorkerPool& = delete;
+  ~WorkerPool();
+
+  static WorkerPool& self() {
+    static WorkerPool wp;
+    return wp;
+  }
+
+  // Moves the worker to the pool thread with fewer workers. If strand is given the worker goes to its thread.
+  void attach(PoolWorker* worker, const QObject* strand = nullptr);
+
+  // Moves the worker to a new thread that is stopped when its last worker is released.
+  void attach_dedicated(PoolWorker* worker);
+
+  /**
+   * Discards the tasks still queued to the worker and deletes it in its thread. Only waits when one of its tasks is
+   * running, as that task may use its owner. Must not be called from the thread of the worker.
+   */
+  void release(PoolWorker* worker);
+
+ private:
+  struct Lane {
+    QThread* thread = nullptr;
+
+    uint n_workers = 0U;
+
+    bool dedicated = false;
+  };
+
+  std::mutex mutex;
+
+  std::vector<Lane> lanes;
+
+  auto lane_index(const QThread* thread) -> int;
+};
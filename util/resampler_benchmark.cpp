@@ -0,0 +1,310 @@
+/**
+ * Copyright © 2017-2026 Wellington Wallace
+ *
+ * This file is part of Easy Effects.
+ *
+ * Easy Effects is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Easy Effects is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * Standalone benchmark and quality check of MultichannelResampler against a
+ * plain speexdsp resampler at the same quality. It is not part of the build.
+ * From the repository root:
+ *
+ *   g++ -std=c++20 -O2 -Isrc util/resampler_benchmark.cpp src/multichannel_resampler.cpp \
+ *     $(pkg-config --cflags --libs Qt6Core speexdsp) -o resampler_benchmark
+ *
+ * For every rate pair it prints the realtime factor for stereo noise fed in
+ * blocks of 1024 frames, the passband ripple, the worst signal to residual
+ * ratio of in band tones (images and distortion) and, when downsampling, the
+ * worst gain of tones above the output Nyquist frequency (aliasing).
+ */
+
+#include <speex/speex_resampler.h>
+#include <sys/types.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <format>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <numbers>
+#include <random>
+#include <source_location>
+#include <span>
+#include <string>
+#include <vector>
+#include "multichannel_resampler.hpp"
+
+// multichannel_resampler.cpp only reports speex errors through util::warning.
+namespace util {
+
+void warning(const std::string& s, std::source_location location) {
+  std::cerr << std::format("{}:{}: {}\n", location.file_name(), location.line(), s);
+}
+
+}  // namespace util
+
+namespace {
+
+constexpr size_t block_size = 1024U;
+
+constexpr double benchmark_seconds = 60.0;
+
+constexpr double tone_seconds = 2.0;
+
+// The first part of every tone response holds the filter transient.
+constexpr double settle_seconds = 0.25;
+
+// Speex' passband at the desktop quality ends a little above 0.9 of the lower Nyquist frequency.
+constexpr double passband_edge = 0.85;
+
+constexpr uint n_tones = 32U;
+
+constexpr std::array<std::array<uint, 2>, 4> rate_pairs = {
+    {{44100U, 48000U}, {48000U, 44100U}, {48000U, 96000U}, {96000U, 48000U}}};
+
+using Process =
+    std::function<size_t(std::span<const float>, std::span<const float>, std::span<float>, std::span<float>)>;
+
+using Factory = std::function<Process(const uint&, const uint&)>;
+
+auto make_multichannel(const uint& input_rate, const uint& output_rate) -> Process {
+  auto resampler = std::make_shared<MultichannelResampler>(2U, input_rate, output_rate, block_size);
+
+  return [=](std::span<const float> left_in, std::span<const float> right_in, std::span<float> left_out,
+             std::span<float> right_out) { return resampler->process(left_in, right_in, left_out, right_out); };
+}
+
+auto make_speex(const uint& input_rate, const uint& output_rate) -> Process {
+  int error = 0;
+
+  auto resampler = std::shared_ptr<SpeexResamplerState>(
+      speex_resampler_init(2U, input_rate, output_rate, SPEEX_RESAMPLER_QUALITY_DESKTOP, &error),
+      speex_resampler_destroy);
+
+  return [=](std::span<const float> left_in, std::span<const float> right_in, std::span<float> left_out,
+             std::span<float> right_out) {
+    std::array<std::span<const float>, 2> input = {left_in, right_in};
+    std::array<std::span<float>, 2> output = {left_out, right_out};
+
+    spx_uint32_t written = 0U;
+
+    for (spx_uint32_t n = 0U; n < 2U; n++) {
+      auto in_len = static_cast<spx_uint32_t>(input[n].size());
+      auto out_len = static_cast<spx_uint32_t>(output[n].size());
+
+      speex_resampler_process_float(resampler.get(), n, input[n].data(), &in_len, output[n].data(), &out_len);
+
+      written = out_len;
+    }
+
+    return static_cast<size_t>(written);
+  };
+}
+
+auto output_capacity(const uint& input_rate, const uint& output_rate) -> size_t {
+  return (block_size * output_rate / input_rate) + 64U;
+}
+
+/**
+ * Feeds the same signal to both channels in blocks of block_size and returns
+ * the left output.
+ */
+auto run(Process& process, const std::vector<float>& signal, const uint& input_rate, const uint& output_rate)
+    -> std::vector<float> {
+  std::vector<float> left_out(output_capacity(input_rate, output_rate));
+  std::vector<float> right_out(left_out.size());
+
+  std::vector<float> result;
+
+  for (size_t offset = 0U; offset + block_size <= signal.size(); offset += block_size) {
+    auto block = std::span(signal).subspan(offset, block_size);
+
+    auto written = process(block, block, left_out, right_out);
+
+    result.insert(result.end(), left_out.begin(), left_out.begin() + static_cast<std::ptrdiff_t>(written));
+  }
+
+  return result;
+}
+
+auto benchmark(const Factory& factory, const uint& input_rate, const uint& output_rate) -> double {
+  auto process = factory(input_rate, output_rate);
+
+  std::mt19937 generator(1U);
+  std::uniform_real_distribution<float> distribution(-1.0F, 1.0F);
+
+  std::vector<float> left_in(block_size);
+  std::vector<float> right_in(block_size);
+
+  std::ranges::generate(left_in, [&] { return distribution(generator); });
+  std::ranges::generate(right_in, [&] { return distribution(generator); });
+
+  std::vector<float> left_out(output_capacity(input_rate, output_rate));
+  std::vector<float> right_out(left_out.size());
+
+  auto n_blocks = static_cast<size_t>(benchmark_seconds * input_rate / block_size);
+
+  auto start = std::chrono::steady_clock::now();
+
+  for (size_t n = 0U; n < n_blocks; n++) {
+    process(left_in, right_in, left_out, right_out);
+  }
+
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  return static_cast<double>(n_blocks * block_size) / input_rate / elapsed.count();
+}
+
+struct ToneResponse {
+  double gain = 0.0;  // fitted output amplitude over input amplitude
+
+  double residual_db = 0.0;  // power of what the fitted tone does not explain, relative to the input tone
+
+  double power_db = 0.0;  // output power relative to the input tone
+};
+
+/**
+ * Resamples a unit sine of frequency hz and fits a sine of the same frequency
+ * to the settled part of the output with least squares.
+ */
+auto measure_tone(const Factory& factory, const uint& input_rate, const uint& output_rate, const double& hz)
+    -> ToneResponse {
+  auto process = factory(input_rate, output_rate);
+
+  std::vector<float> signal(static_cast<size_t>(tone_seconds * input_rate));
+
+  for (size_t n = 0U; n < signal.size(); n++) {
+    signal[n] = static_cast<float>(std::sin(2.0 * std::numbers::pi * hz * static_cast<double>(n) / input_rate));
+  }
+
+  auto output = run(process, signal, input_rate, output_rate);
+
+  auto first = static_cast<size_t>(settle_seconds * output_rate);
+
+  double ss = 0.0;
+  double sc = 0.0;
+  double cc = 0.0;
+  double ys = 0.0;
+  double yc = 0.0;
+
+  for (size_t n = first; n < output.size(); n++) {
+    auto phase = 2.0 * std::numbers::pi * hz * static_cast<double>(n) / output_rate;
+    auto s = std::sin(phase);
+    auto c = std::cos(phase);
+
+    ss += s * s;
+    sc += s * c;
+    cc += c * c;
+    ys += output[n] * s;
+    yc += output[n] * c;
+  }
+
+  auto det = (ss * cc) - (sc * sc);
+  auto a = ((ys * cc) - (yc * sc)) / det;
+  auto b = ((yc * ss) - (ys * sc)) / det;
+
+  double residual = 0.0;
+  double power = 0.0;
+
+  for (size_t n = first; n < output.size(); n++) {
+    auto phase = 2.0 * std::numbers::pi * hz * static_cast<double>(n) / output_rate;
+    auto error = output[n] - ((a * std::sin(phase)) + (b * std::cos(phase)));
+
+    residual += error * error;
+    power += output[n] * output[n];
+  }
+
+  auto count = static_cast<double>(output.size() - first);
+
+  return {.gain = std::hypot(a, b),
+          .residual_db = 10.0 * std::log10(std::max(residual / count, 1e-30) / 0.5),
+          .power_db = 10.0 * std::log10(std::max(power / count, 1e-30) / 0.5)};
+}
+
+struct Quality {
+  double ripple_db = 0.0;
+
+  double worst_residual_db = -std::numeric_limits<double>::infinity();
+
+  double worst_alias_db = -std::numeric_limits<double>::infinity();
+};
+
+auto measure_quality(const Factory& factory, const uint& input_rate, const uint& output_rate) -> Quality {
+  Quality quality;
+
+  auto nyquist = 0.5 * std::min(input_rate, output_rate);
+
+  auto min_gain = std::numeric_limits<double>::infinity();
+  auto max_gain = 0.0;
+
+  for (uint n = 0U; n < n_tones; n++) {
+    auto hz = nyquist * passband_edge * (n + 1U) / n_tones;
+
+    auto response = measure_tone(factory, input_rate, output_rate, hz);
+
+    min_gain = std::min(min_gain, response.gain);
+    max_gain = std::max(max_gain, response.gain);
+
+    quality.worst_residual_db = std::max(quality.worst_residual_db, response.residual_db);
+  }
+
+  quality.ripple_db = 20.0 * std::log10(max_gain / min_gain);
+
+  if (output_rate < input_rate) {
+    auto start = 1.1 * nyquist;
+    auto stop = 0.98 * 0.5 * input_rate;
+
+    for (uint n = 0U; n < n_tones; n++) {
+      auto hz = start + ((stop - start) * n / (n_tones - 1U));
+
+      // The output can not represent these tones. All of the power that gets through is aliasing.
+      auto response = measure_tone(factory, input_rate, output_rate, hz);
+
+      quality.worst_alias_db = std::max(quality.worst_alias_db, response.power_db);
+    }
+  }
+
+  return quality;
+}
+
+void report(const std::string& name, const Factory& factory, const uint& input_rate, const uint& output_rate) {
+  auto realtime = benchmark(factory, input_rate, output_rate);
+  auto quality = measure_quality(factory, input_rate, output_rate);
+
+  auto alias =
+      output_rate < input_rate ? std::format("{:8.1f} dB", quality.worst_alias_db) : std::string("       -   ");
+
+  std::cout << std::format("{:<14} {:>6} -> {:>6} {:9.0f}x {:9.4f} dB {:9.1f} dB {}\n", name, input_rate, output_rate,
+                           realtime, quality.ripple_db, quality.worst_residual_db, alias);
+}
+
+}  // namespace
+
+auto main() -> int {
+  std::cout << std::format("{:<14} {:>16} {:>10} {:>12} {:>12} {:>11}\n", "resampler", "rates", "realtime", "ripple",
+                           "residual", "alias");
+
+  for (const auto& [input_rate, output_rate] : rate_pairs) {
+    report("multichannel", make_multichannel, input_rate, output_rate);
+    report("speex", make_speex, input_rate, output_rate);
+  }
+
+  return 0;
+}